@@ -20,8 +20,20 @@
 #ifndef AVLSET_HPP
 #define AVLSET_HPP
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
-#include "Set.hpp"
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "KeyStorage.hpp"
+#include "NodeAllocator.hpp"
+#include "OrderedSet.hpp"
+#include "ParallelSort.hpp"
 #include <iostream>
 #include <iomanip>
 template <typename ElementType>
@@ -33,17 +45,172 @@ struct Node
 	int height;
 };
 
-template <typename ElementType>
-class AVLSet : public Set<ElementType>
+namespace impl_
+{
+	// A NodeStack holds the nodes a walk of a tree has yet to come back
+	// to, which are never more than the tree is tall.  When that's no more
+	// than InlineDepth, they're kept in the stack itself, so walking the
+	// tree allocates nothing; only a taller (i.e., unbalanced) tree needs a
+	// vector instead.  Either way, the room is set aside up front, so
+	// pushing and popping never check for it.
+	template <typename NodeType, std::size_t InlineDepth>
+	class NodeStack
+	{
+	public:
+		explicit NodeStack(std::size_t height)
+			: spilled(height > InlineDepth ? height : 0), bottom{height > InlineDepth ? spilled.data() : inlined}, next{bottom}
+		{
+		}
+
+		//only the occupied part of the inline array is copied
+		NodeStack(const NodeStack& s)
+			: spilled{s.spilled}, bottom{s.spilled.empty() ? inlined : spilled.data()}, next{bottom + (s.next - s.bottom)}
+		{
+			if(s.spilled.empty())
+				std::copy_n(s.inlined, s.next - s.bottom, inlined);
+		}
+
+		NodeStack& operator=(const NodeStack& s)
+		{
+			spilled = s.spilled;
+			bottom = s.spilled.empty() ? inlined : spilled.data();
+			next = bottom + (s.next - s.bottom);
+			if(s.spilled.empty())
+				std::copy_n(s.inlined, s.next - s.bottom, inlined);
+			return *this;
+		}
+
+		bool empty() const noexcept
+		{
+			return next == bottom;
+		}
+
+		void push(NodeType* node) noexcept
+		{
+			*next++ = node;
+		}
+
+		NodeType* top() const noexcept
+		{
+			return next[-1];
+		}
+
+		NodeType* pop() noexcept
+		{
+			return *--next;
+		}
+
+	private:
+		std::vector<NodeType*> spilled;
+		NodeType** bottom;
+		NodeType** next;
+		NodeType* inlined[InlineDepth];
+	};
+}
+
+template <typename ElementType, typename NodeAllocator = HeapNodeAllocator, typename KeyStorage = DirectKeys>
+class AVLSet : public OrderedSet<ElementType>
 {
 public:
 	// A VisitFunction is a function that takes a reference to a const
 	// ElementType and returns no value.
 	using VisitFunction = std::function<void(const ElementType&)>;
 
+	// A WhileFunction is a visit function that returns false to stop the
+	// visiting (see OrderedSet).
+	using WhileFunction = typename OrderedSet<ElementType>::WhileFunction;
+
+private:
+	// No AVL tree that fits in memory is taller than this (one of height
+	// h has at least fib(h + 2) - 1 nodes), so insertNode() can keep the
+	// path it walked down in a fixed-size array, and walks of the tree
+	// keep their stack of nodes inline.
+	static constexpr unsigned int MAX_HEIGHT = 96;
+
+	using NodeStack = impl_::NodeStack<Node<StoredKey<KeyStorage, ElementType>>, MAX_HEIGHT>;
+
+public:
+	// A const_iterator visits the elements in ascending order (an inorder
+	// traversal of the tree), keeping the nodes it has yet to come back to
+	// on an explicit stack instead of recursing.  The stack is kept in the
+	// iterator, so no iterator over a balanced tree allocates memory.
+	// Adding an element to the set invalidates its iterators.  When the
+	// KeyStorage hands elements back by value (see InternedKeys), so does
+	// the iterator, which is then only an input iterator.
+	class const_iterator
+	{
+	public:
+		using value_type = ElementType;
+		using reference = decltype(std::declval<const typename KeyStorage::template Store<ElementType>&>().element(
+			std::declval<const StoredKey<KeyStorage, ElementType>&>()));
+		using pointer = std::conditional_t<std::is_reference_v<reference>, const ElementType*, void>;
+		using difference_type = std::ptrdiff_t;
+		using iterator_category = std::conditional_t<
+			std::is_reference_v<reference>, std::forward_iterator_tag, std::input_iterator_tag>;
+
+		const_iterator() : set{nullptr}, path{0} {}
+
+		reference operator*() const
+		{
+			return set->keys.element(path.top()->data);
+		}
+
+		template <typename Reference = reference, typename = std::enable_if_t<std::is_reference_v<Reference>>>
+		const ElementType* operator->() const
+		{
+			return &**this;
+		}
+
+		const_iterator& operator++()
+		{
+			//the next node is the leftmost of the current one's right
+			//subtree, or else the nearest of the ancestors below it
+			Node<StoredKey<KeyStorage, ElementType>>* node = path.pop()->right;
+			for(; node != nullptr; node = node->left)
+				path.push(node);
+			return *this;
+		}
+
+		const_iterator operator++(int)
+		{
+			const_iterator old{*this};
+			++*this;
+			return old;
+		}
+
+		bool operator==(const const_iterator& i) const noexcept
+		{
+			return current() == i.current();
+		}
+
+		bool operator!=(const const_iterator& i) const noexcept
+		{
+			return current() != i.current();
+		}
+
+	private:
+		friend class AVLSet;
+
+		explicit const_iterator(const AVLSet* set) : set{set}, path{static_cast<std::size_t>(set->getHeight(set->head))} {}
+
+		Node<StoredKey<KeyStorage, ElementType>>* current() const noexcept
+		{
+			return path.empty() ? nullptr : path.top();
+		}
+
+		const AVLSet* set;
+
+		//the current node, on top of the ancestors whose left subtrees
+		//hold it; empty at the end
+		NodeStack path;
+	};
+
+	using iterator = const_iterator;
+
 public:
-	// Initializes an AVLSet to be empty, with or without balancing.
-	explicit AVLSet(bool shouldBalance = true);
+	// Initializes an AVLSet to be empty, with or without balancing, and
+	// with or without the array that freeze() can build (see below).
+	explicit AVLSet(bool shouldBalance = true, bool shouldFreezeIntoArray = false);
 
 	// Cleans up the AVLSet so that it leaks no memory.
 	virtual ~AVLSet() noexcept;
@@ -73,6 +240,20 @@ public:
 	virtual void add(const ElementType& element) override;
 
 
+	// addAll() adds every element in the vector.  If the set is empty and
+	// balanced, it builds a perfectly balanced tree directly from the
+	// elements in order, in linear time, instead of adding them one at a
+	// time; if the elements aren't known to be sorted, a copy of them is
+	// sorted (see parallelSort()) first.  Otherwise, it calls add() for
+	// each one.
+	virtual void addAll(const std::vector<ElementType>& elements, bool sorted = false) override;
+
+
+	// buildsInBulk() returns true while addAll() would build the tree
+	// directly, i.e., while the set is empty and balanced.
+	virtual bool buildsInBulk() const noexcept override;
+
+
 	// contains() returns true if the given element is already in the set,
 	// false otherwise.  This function always runs in O(log n) time when
 	// there are n elements in the AVL tree.
@@ -80,7 +261,30 @@ public:
 
 
 	// size() returns the number of elements in the set.
-	virtual unsigned int size() const noexcept override;
+	virtual std::size_t size() const noexcept override;
+
+
+	// freeze() gives back whatever room the KeyStorage has set aside for
+	// elements that haven't been added.  If the set was asked to freeze
+	// into an array when it was constructed, it also copies the keys into
+	// an array in Eytzinger order (the
+	// order of a breadth-first walk of a perfectly balanced tree, so the
+	// children of the key at index i are at 2i and 2i + 1), which
+	// contains() then searches instead of the tree.  Each step of that
+	// search is a comparison and some arithmetic rather than a pointer to
+	// follow, the top levels share a few cache lines, and the keys a few
+	// levels below are prefetched while the current one is compared,
+	// since their position is known in advance.
+	// The tree itself is kept, so height() and the traversals behave as
+	// before, but every key is then held twice, which is why the array is
+	// only built when asked for; adding an element discards it until
+	// freeze() is called again.
+	virtual void freeze() override;
+
+
+	// isFrozen() returns true if contains() is searching the array built
+	// by freeze().
+	bool isFrozen() const noexcept;
 
 
 	// height() returns the height of the AVL tree.  Note that, by definition,
@@ -88,6 +292,18 @@ public:
 	int height() const;
 
 
+	// begin() and end() are the bounds of an ascending walk of the
+	// elements, which is the same as an inorder traversal of the tree.
+	// They walk the tree even when the set is frozen.
+	const_iterator begin() const;
+	const_iterator end() const;
+
+
+	// lowerBound() returns an iterator at the smallest element that is not
+	// less than the given one, or end() if there is none, in O(log n) time.
+	const_iterator lowerBound(const ElementType& element) const;
+
+
 	// preorder() calls the given "visit" function for each of the elements
 	// in the set, in the order determined by a preorder traversal of the AVL
 	// tree.
@@ -104,8 +320,33 @@ public:
 	// in the set, in the order determined by a postorder traversal of the AVL
 	// tree.
 	void postorder(VisitFunction visit) const;
+
+
+	// These overloads of the traversals take any function object, whose
+	// calls can then be inlined, rather than calling a VisitFunction
+	// indirectly for each element; the VisitFunction versions are built on
+	// them.  None of the traversals recurse, so an unbalanced tree of any
+	// height can be walked.
+	template <typename Visit>
+	void preorder(Visit visit) const;
+
+	template <typename Visit>
+	void inorder(Visit visit) const;
+
+	template <typename Visit>
+	void postorder(Visit visit) const;
+
+
+	// visitFrom() calls the given "visit" function for each element that
+	// is not less than low, in ascending order, until it returns false.
+	// The walk starts at lowerBound(low), so this runs in O(log n + k)
+	// time when k elements are visited; visitRange()
+	// and visitPrefix() (see OrderedSet) are built on it.  The tree is
+	// walked even when the set is frozen, since the frozen array isn't in
+	// ascending order.
+	virtual std::size_t visitFrom(const ElementType& low, WhileFunction visit) const override;
 /*
-	void coutNode(Node<ElementType>* head, int indent = 0)
+	void coutNode(Node<StoredKey<KeyStorage, ElementType>>* head, int indent = 0)
 	{
 		if(head != nullptr)
 		{
@@ -128,25 +369,41 @@ private:
 	// You'll no doubt want to add member variables and "helper" member
 	// functions here.
 
-
-	Node<ElementType>* head;
-	int treesize;
+	// The frozen array is aligned to a cache line, and each step of a
+	// search prefetches the two cache lines holding the descendants
+	// PREFETCH_KEYS positions below it (i.e., log2(PREFETCH_KEYS) levels
+	// down, all of which are contiguous).
+	static constexpr std::size_t FROZEN_ALIGNMENT = 64;
+	static constexpr std::size_t PREFETCH_BYTES = 2 * FROZEN_ALIGNMENT;
+	static constexpr std::size_t PREFETCH_KEYS =
+		sizeof(StoredKey<KeyStorage, ElementType>) >= PREFETCH_BYTES ? 1 : PREFETCH_BYTES / sizeof(StoredKey<KeyStorage, ElementType>);
+
+	Node<StoredKey<KeyStorage, ElementType>>* head;
+	std::size_t treesize;
 	bool balance;
+	bool freezearray;
+	typename NodeAllocator::template Pool<Node<StoredKey<KeyStorage, ElementType>>> nodes;
+	typename KeyStorage::template Store<ElementType> keys;
 
-	Node<ElementType>* newNode(const ElementType& element, Node<ElementType>* left, Node<ElementType>* right, int height);
-	int getHeight(Node<ElementType>* head) const;
-	int compareHeight(Node<ElementType>* head);
-	int branchHeight(Node<ElementType>* head);
-	Node<ElementType>* leftRotate(Node<ElementType>* head);
-	Node<ElementType>* rightRotate(Node<ElementType>* head);
-	Node<ElementType>* insertNode(const ElementType& element, Node<ElementType>* head);
-	Node<ElementType>* insertNodeBST(const ElementType& element, Node<ElementType>* head);
-	Node<ElementType>* copyTree(Node<ElementType>* head);
-	void deleteTree(Node<ElementType>* head);
-	bool containsNode(const ElementType& element, Node<ElementType>* head) const;
-	void previsitnode(VisitFunction& visit, Node<ElementType>* head) const;
-	void invisitnode(VisitFunction& visit, Node<ElementType>* head) const;
-	void postvisitnode(VisitFunction& visit, Node<ElementType>* head) const;
+	//the frozen array; frozenkeys[1] through frozenkeys[treesize] are the
+	//keys in Eytzinger order, or frozenkeys is nullptr if not frozen
+	StoredKey<KeyStorage, ElementType>* frozenkeys;
+
+	Node<StoredKey<KeyStorage, ElementType>>* newNode(const StoredKey<KeyStorage, ElementType>& key, Node<StoredKey<KeyStorage, ElementType>>* left, Node<StoredKey<KeyStorage, ElementType>>* right, int height);
+	int getHeight(Node<StoredKey<KeyStorage, ElementType>>* head) const;
+	int compareHeight(Node<StoredKey<KeyStorage, ElementType>>* head);
+	int branchHeight(Node<StoredKey<KeyStorage, ElementType>>* head);
+	Node<StoredKey<KeyStorage, ElementType>>* leftRotate(Node<StoredKey<KeyStorage, ElementType>>* head);
+	Node<StoredKey<KeyStorage, ElementType>>* rightRotate(Node<StoredKey<KeyStorage, ElementType>>* head);
+	bool insertNode(const ElementType& element);
+	bool insertNodeBST(const ElementType& element);
+	Node<StoredKey<KeyStorage, ElementType>>* buildBalanced(const ElementType* first, std::size_t count);
+	Node<StoredKey<KeyStorage, ElementType>>* copyTree(Node<StoredKey<KeyStorage, ElementType>>* head);
+	void deleteTree(Node<StoredKey<KeyStorage, ElementType>>* head);
+	bool containsNode(const ElementType& element, Node<StoredKey<KeyStorage, ElementType>>* head) const;
+	bool containsFrozen(const ElementType& element) const;
+	void fillFrozen();
+	void releaseFrozen() noexcept;
 
 
 
@@ -156,157 +413,346 @@ private:
 };
 
 
-template <typename ElementType>
-AVLSet<ElementType>::AVLSet(bool shouldBalance) : head{nullptr}, treesize{0}, balance{shouldBalance}
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+AVLSet<ElementType, NodeAllocator, KeyStorage>::AVLSet(bool shouldBalance, bool shouldFreezeIntoArray) : head{nullptr}, treesize{0}, balance{shouldBalance}, freezearray{shouldFreezeIntoArray}, frozenkeys{nullptr}
 {
 }
 
 
-template <typename ElementType>
-AVLSet<ElementType>::~AVLSet() noexcept
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+AVLSet<ElementType, NodeAllocator, KeyStorage>::~AVLSet() noexcept
 {
+	releaseFrozen();
 	deleteTree(head);
 }
 
 
-template <typename ElementType>
-AVLSet<ElementType>::AVLSet(const AVLSet& s)
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+AVLSet<ElementType, NodeAllocator, KeyStorage>::AVLSet(const AVLSet& s)
+	: frozenkeys{nullptr}
 {
+	keys = s.keys;
 	head = copyTree(s.head);
 	treesize = s.treesize;
 	balance = s.balance;
+	freezearray = s.freezearray;
+	if(s.isFrozen())
+		freeze();
 }
 
 
-template <typename ElementType>
-AVLSet<ElementType>::AVLSet(AVLSet&& s) noexcept
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+AVLSet<ElementType, NodeAllocator, KeyStorage>::AVLSet(AVLSet&& s) noexcept
+	: head{s.head}, treesize{s.treesize}, balance{s.balance}, freezearray{s.freezearray}, nodes{std::move(s.nodes)}, keys{std::move(s.keys)}, frozenkeys{s.frozenkeys}
 {
-	head = copyTree(s.head);
-	treesize = s.treesize;
-	balance = s.balance;
+	//the nodes (and the frozen array) are taken rather than copied, so
+	//the expiring set is left empty
+	s.head = nullptr;
+	s.treesize = 0;
+	s.frozenkeys = nullptr;
 }
 
 
-template <typename ElementType>
-AVLSet<ElementType>& AVLSet<ElementType>::operator=(const AVLSet& s)
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+AVLSet<ElementType, NodeAllocator, KeyStorage>& AVLSet<ElementType, NodeAllocator, KeyStorage>::operator=(const AVLSet& s)
 {
+	if(this == &s) return *this;
+	releaseFrozen();
 	deleteTree(head);
+	keys = s.keys;
 	head = copyTree(s.head);
 	treesize = s.treesize;
 	balance = s.balance;
+	freezearray = s.freezearray;
+	if(s.isFrozen())
+		freeze();
 	return *this;
 }
 
 
-template <typename ElementType>
-AVLSet<ElementType>& AVLSet<ElementType>::operator=(AVLSet&& s) noexcept
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+AVLSet<ElementType, NodeAllocator, KeyStorage>& AVLSet<ElementType, NodeAllocator, KeyStorage>::operator=(AVLSet&& s) noexcept
 {
-	deleteTree(head);
-	head = copyTree(s.head);
-	treesize = s.treesize;
-	balance = s.balance;
+	//the expiring set is left with this one's old contents, which it
+	//cleans up when it's destroyed
+	std::swap(head, s.head);
+	std::swap(treesize, s.treesize);
+	std::swap(balance, s.balance);
+	std::swap(freezearray, s.freezearray);
+	std::swap(nodes, s.nodes);
+	std::swap(keys, s.keys);
+	std::swap(frozenkeys, s.frozenkeys);
 	return *this;
 }
 
 
-template <typename ElementType>
-bool AVLSet<ElementType>::isImplemented() const noexcept
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+bool AVLSet<ElementType, NodeAllocator, KeyStorage>::isImplemented() const noexcept
 {
 	return true;
 }
 
 
-template <typename ElementType>
-void AVLSet<ElementType>::add(const ElementType& element)
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+void AVLSet<ElementType, NodeAllocator, KeyStorage>::add(const ElementType& element)
 {
-	if(balance)
+	bool inserted = balance ? insertNode(element) : insertNodeBST(element);
+	if(inserted)
 	{
-		head = insertNode(element, head);
+		releaseFrozen();
+		treesize++;
 	}
-	else
-	{ 
-		head = insertNodeBST(element, head);
+}
+
+
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+void AVLSet<ElementType, NodeAllocator, KeyStorage>::addAll(const std::vector<ElementType>& elements, bool sorted)
+{
+	if(treesize != 0 || !balance)
+	{
+		for(const ElementType& element : elements)
+			add(element);
+		return;
+	}
+
+	//the sorted elements can be used as they are unless they have
+	//duplicates in them; otherwise, a copy is sorted and/or made unique
+	if(sorted && std::adjacent_find(elements.begin(), elements.end()) == elements.end())
+	{
+		head = buildBalanced(elements.data(), elements.size());
+		treesize = elements.size();
+		return;
 	}
-	treesize++;
+
+	std::vector<ElementType> ordered{elements};
+	if(!sorted)
+		parallelSort(ordered);
+	ordered.erase(std::unique(ordered.begin(), ordered.end()), ordered.end());
+	head = buildBalanced(ordered.data(), ordered.size());
+	treesize = ordered.size();
 }
 
 
-template <typename ElementType>
-bool AVLSet<ElementType>::contains(const ElementType& element) const
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+bool AVLSet<ElementType, NodeAllocator, KeyStorage>::buildsInBulk() const noexcept
 {
+	return treesize == 0 && balance;
+}
+
+
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+bool AVLSet<ElementType, NodeAllocator, KeyStorage>::contains(const ElementType& element) const
+{
+	if(frozenkeys != nullptr)
+		return containsFrozen(element);
 	return containsNode(element, head);
 }
 
 
-template <typename ElementType>
-unsigned int AVLSet<ElementType>::size() const noexcept
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+std::size_t AVLSet<ElementType, NodeAllocator, KeyStorage>::size() const noexcept
 {
 	return treesize;
 }
 
 
-template <typename ElementType>
-int AVLSet<ElementType>::height() const
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+void AVLSet<ElementType, NodeAllocator, KeyStorage>::freeze()
+{
+	keys.shrinkToFit();
+	releaseFrozen();
+	if(!freezearray || treesize == 0)
+		return;
+
+	frozenkeys = static_cast<StoredKey<KeyStorage, ElementType>*>(
+		::operator new((treesize + 1) * sizeof(StoredKey<KeyStorage, ElementType>), std::align_val_t{FROZEN_ALIGNMENT}));
+	fillFrozen();
+}
+
+
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+bool AVLSet<ElementType, NodeAllocator, KeyStorage>::isFrozen() const noexcept
+{
+	return frozenkeys != nullptr;
+}
+
+
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+int AVLSet<ElementType, NodeAllocator, KeyStorage>::height() const
 {
 	return getHeight(head) - 1;
 }
 
 
-template <typename ElementType>
-void AVLSet<ElementType>::preorder(VisitFunction visit) const
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+typename AVLSet<ElementType, NodeAllocator, KeyStorage>::const_iterator AVLSet<ElementType, NodeAllocator, KeyStorage>::begin() const
 {
-	previsitnode(visit, head);
+	const_iterator i{this};
+	for(Node<StoredKey<KeyStorage, ElementType>>* node = head; node != nullptr; node = node->left)
+		i.path.push(node);
+	return i;
 }
 
 
-template <typename ElementType>
-void AVLSet<ElementType>::inorder(VisitFunction visit) const
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+typename AVLSet<ElementType, NodeAllocator, KeyStorage>::const_iterator AVLSet<ElementType, NodeAllocator, KeyStorage>::end() const
 {
-	invisitnode(visit, head);
+	return const_iterator{};
 }
 
 
-template <typename ElementType>
-void AVLSet<ElementType>::postorder(VisitFunction visit) const
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+typename AVLSet<ElementType, NodeAllocator, KeyStorage>::const_iterator AVLSet<ElementType, NodeAllocator, KeyStorage>::lowerBound(const ElementType& element) const
 {
-	postvisitnode(visit, head);
+	//only the nodes not less than the element are pushed, since those
+	//less than it (and their left subtrees) are never visited
+	const_iterator i{this};
+	for(Node<StoredKey<KeyStorage, ElementType>>* node = head; node != nullptr;)
+	{
+		if(keys.compare(element, node->data) > 0)
+			node = node->right;
+		else
+		{
+			i.path.push(node);
+			node = node->left;
+		}
+	}
+	return i;
 }
 
-template <typename ElementType>
-Node<ElementType>* AVLSet<ElementType>::newNode(const ElementType& element, Node<ElementType>* left, Node<ElementType>* right, int height)
+
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+void AVLSet<ElementType, NodeAllocator, KeyStorage>::preorder(VisitFunction visit) const
 {
-	Node<ElementType>* head = new Node<ElementType>;
-	head->data = element;
-	head->left = left;
-	head->right = right;
-	head->height = height;
-	return head;
+	preorder<VisitFunction&>(visit);
 }
 
-template <typename ElementType>
-int AVLSet<ElementType>::getHeight(Node<ElementType>* head) const
+
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+void AVLSet<ElementType, NodeAllocator, KeyStorage>::inorder(VisitFunction visit) const
+{
+	inorder<VisitFunction&>(visit);
+}
+
+
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+void AVLSet<ElementType, NodeAllocator, KeyStorage>::postorder(VisitFunction visit) const
+{
+	postorder<VisitFunction&>(visit);
+}
+
+
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+template <typename Visit>
+void AVLSet<ElementType, NodeAllocator, KeyStorage>::preorder(Visit visit) const
+{
+	//each node is visited on the way down, leaving its right child on
+	//the stack to come back to
+	NodeStack pending{static_cast<std::size_t>(getHeight(head))};
+	Node<StoredKey<KeyStorage, ElementType>>* node = head;
+	while(node != nullptr)
+	{
+		visit(keys.element(node->data));
+		if(node->right != nullptr)
+			pending.push(node->right);
+		if(node->left != nullptr)
+			node = node->left;
+		else
+			node = pending.empty() ? nullptr : pending.pop();
+	}
+}
+
+
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+template <typename Visit>
+void AVLSet<ElementType, NodeAllocator, KeyStorage>::inorder(Visit visit) const
+{
+	//the same walk as a const_iterator's, without going through one
+	NodeStack pending{static_cast<std::size_t>(getHeight(head))};
+	Node<StoredKey<KeyStorage, ElementType>>* node = head;
+	while(true)
+	{
+		for(; node != nullptr; node = node->left)
+			pending.push(node);
+		if(pending.empty())
+			return;
+		node = pending.pop();
+		visit(keys.element(node->data));
+		node = node->right;
+	}
+}
+
+
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+template <typename Visit>
+void AVLSet<ElementType, NodeAllocator, KeyStorage>::postorder(Visit visit) const
+{
+	//a node on the stack is visited once the walk comes back up to it
+	//from its right subtree (or from its left, if it has no right)
+	NodeStack pending{static_cast<std::size_t>(getHeight(head))};
+	Node<StoredKey<KeyStorage, ElementType>>* node = head;
+	Node<StoredKey<KeyStorage, ElementType>>* last = nullptr;
+	while(node != nullptr || !pending.empty())
+	{
+		if(node != nullptr)
+		{
+			pending.push(node);
+			node = node->left;
+		}
+		else if(pending.top()->right != nullptr && pending.top()->right != last)
+			node = pending.top()->right;
+		else
+		{
+			last = pending.pop();
+			visit(keys.element(last->data));
+		}
+	}
+}
+
+
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+std::size_t AVLSet<ElementType, NodeAllocator, KeyStorage>::visitFrom(const ElementType& low, WhileFunction visit) const
+{
+	std::size_t visited = 0;
+	for(const_iterator i = lowerBound(low), last = end(); i != last; ++i)
+	{
+		visited++;
+		if(!visit(*i))
+			break;
+	}
+	return visited;
+}
+
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+Node<StoredKey<KeyStorage, ElementType>>* AVLSet<ElementType, NodeAllocator, KeyStorage>::newNode(const StoredKey<KeyStorage, ElementType>& key, Node<StoredKey<KeyStorage, ElementType>>* left, Node<StoredKey<KeyStorage, ElementType>>* right, int height)
+{
+	return nodes.create(key, left, right, height);
+}
+
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+int AVLSet<ElementType, NodeAllocator, KeyStorage>::getHeight(Node<StoredKey<KeyStorage, ElementType>>* head) const
 {
 	if(head == nullptr) return 0;
 	return head->height;
 }
 
-template <typename ElementType>
-int AVLSet<ElementType>::compareHeight(Node<ElementType>* head)
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+int AVLSet<ElementType, NodeAllocator, KeyStorage>::compareHeight(Node<StoredKey<KeyStorage, ElementType>>* head)
 {
 	return getHeight(head->left) - getHeight(head->right);
 }
 
-template <typename ElementType>
-int AVLSet<ElementType>::branchHeight(Node<ElementType>* head)
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+int AVLSet<ElementType, NodeAllocator, KeyStorage>::branchHeight(Node<StoredKey<KeyStorage, ElementType>>* head)
 {
 	return getHeight(head->left) > getHeight(head->right) ? getHeight(head->left) : getHeight(head->right);
 }
 
-template <typename ElementType>
-Node<ElementType>* AVLSet<ElementType>::leftRotate(Node<ElementType>* head)
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+Node<StoredKey<KeyStorage, ElementType>>* AVLSet<ElementType, NodeAllocator, KeyStorage>::leftRotate(Node<StoredKey<KeyStorage, ElementType>>* head)
 {
-	Node<ElementType>* main_right = head->right;
-	Node<ElementType>* rightleft_sub = main_right->left;
+	Node<StoredKey<KeyStorage, ElementType>>* main_right = head->right;
+	Node<StoredKey<KeyStorage, ElementType>>* rightleft_sub = main_right->left;
 	
 	main_right->left = head;
 	head->right = rightleft_sub;
@@ -317,11 +763,11 @@ Node<ElementType>* AVLSet<ElementType>::leftRotate(Node<ElementType>* head)
 	return main_right;
 }
 
-template <typename ElementType>
-Node<ElementType>* AVLSet<ElementType>::rightRotate(Node<ElementType>* head)
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+Node<StoredKey<KeyStorage, ElementType>>* AVLSet<ElementType, NodeAllocator, KeyStorage>::rightRotate(Node<StoredKey<KeyStorage, ElementType>>* head)
 {
-	Node<ElementType>* main_left = head->left;
-	Node<ElementType>* leftright_sub = main_left->right;
+	Node<StoredKey<KeyStorage, ElementType>>* main_left = head->left;
+	Node<StoredKey<KeyStorage, ElementType>>* leftright_sub = main_left->right;
 
 	head->left = leftright_sub;
 	main_left->right = head;
@@ -332,143 +778,254 @@ Node<ElementType>* AVLSet<ElementType>::rightRotate(Node<ElementType>* head)
 	return main_left;
 }
 
-template <typename ElementType>
-Node<ElementType>* AVLSet<ElementType>::insertNode(const ElementType& element, Node<ElementType>* head)
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+bool AVLSet<ElementType, NodeAllocator, KeyStorage>::insertNode(const ElementType& element)
 {
-	//BST insertNode
-	if(head == nullptr)
+	//walk down, remembering each link followed, with one comparison per
+	//node; path[i] is the link to the node at depth i
+	Node<StoredKey<KeyStorage, ElementType>>** path[MAX_HEIGHT];
+	unsigned int depth = 0;
+	Node<StoredKey<KeyStorage, ElementType>>** link = &head;
+	while(*link != nullptr)
 	{
-		return newNode(element, nullptr, nullptr, 1);
+		int order = keys.compare(element, (*link)->data);
+		if(order == 0)
+			return false;
+		path[depth++] = link;
+		link = (order < 0 ? &(*link)->left : &(*link)->right);
 	}
-	if(head->data == element)
-	{
-		return head;
-	} 
-	else if (element > head->data)
-	{
-		head->right = insertNode(element, head->right);
-	}
-	else if (element < head->data)
-	{
-		head->left = insertNode(element, head->left);
-	}
-	//update height
-	head->height = 1 + branchHeight(head);
-
-	//compare height dirrerence of left and right
-	int hei_diff = compareHeight(head);
+	*link = newNode(keys.keep(element), nullptr, nullptr, 1);
 
-	//perform rotation
-
-	//leftleft rotation
-	if(hei_diff > 1 && element < head->left->data)
+	//walk back up, updating heights; one rotation (single or double)
+	//restores the height the subtree had before the insertion, so nothing
+	//above it changes, and neither does anything above a node whose
+	//height stays the same
+	while(depth > 0)
 	{
-		return rightRotate(head);
-	}
+		link = path[--depth];
+		Node<StoredKey<KeyStorage, ElementType>>* node = *link;
+		int oldHeight = node->height;
+		node->height = 1 + branchHeight(node);
 
-	//leftright rotation
-	if(hei_diff > 1 && element > head->left->data)
-	{
-		head->left = leftRotate(head->left);
-		return rightRotate(head);
+		int hei_diff = compareHeight(node);
+		if(hei_diff > 1)
+		{
+			//leftright rotation, or leftleft if the left child leans left
+			if(compareHeight(node->left) < 0)
+				node->left = leftRotate(node->left);
+			*link = rightRotate(node);
+			return true;
+		}
+		if(hei_diff < -1)
+		{
+			//rightleft rotation, or rightright if the right child leans right
+			if(compareHeight(node->right) > 0)
+				node->right = rightRotate(node->right);
+			*link = leftRotate(node);
+			return true;
+		}
+		if(node->height == oldHeight)
+			return true;
 	}
+	return true;
+}
 
-	//rightleft rotation
-	if(hei_diff < -1 && element < head->right->data)
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+bool AVLSet<ElementType, NodeAllocator, KeyStorage>::insertNodeBST(const ElementType& element)
+{
+	//an unbalanced tree can be arbitrarily tall, so there's no path to
+	//remember; instead, the new node's depth is found on the way down,
+	//and a second walk raises the heights along the same path, since a
+	//node at depth i is now at least depth - i + 1 tall
+	Node<StoredKey<KeyStorage, ElementType>>** link = &head;
+	unsigned int depth = 0;
+	while(*link != nullptr)
 	{
-		head->right = rightRotate(head->right);
-		return leftRotate(head);
+		int order = keys.compare(element, (*link)->data);
+		if(order == 0)
+			return false;
+		depth++;
+		link = (order < 0 ? &(*link)->left : &(*link)->right);
 	}
+	*link = newNode(keys.keep(element), nullptr, nullptr, 1);
 
-	//rightright rotation
-	if(hei_diff < -1 && element > head->right->data)
+	int height = depth + 1;
+	for(Node<StoredKey<KeyStorage, ElementType>>* node = head; height > 1; height--)
 	{
-		return leftRotate(head);
+		if(node->height < height)
+			node->height = height;
+		node = (keys.compare(element, node->data) < 0 ? node->left : node->right);
 	}
-	//difference no more than 2, return unmodified head
-	return head;
+	return true;
 }
 
-template <typename ElementType>
-Node<ElementType>* AVLSet<ElementType>::insertNodeBST(const ElementType& element, Node<ElementType>* head)
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+Node<StoredKey<KeyStorage, ElementType>>* AVLSet<ElementType, NodeAllocator, KeyStorage>::buildBalanced(const ElementType* first, std::size_t count)
 {
-	if(head == nullptr)
-	{
-		return newNode(element, nullptr, nullptr, 1);
-	}
-	if(head->data == element)
-	{
-		return head;
-	} 
-	else if (element > head->data)
-	{
-		head->right = insertNodeBST(element, head->right);
-	}
-	else if (element < head->data)
-	{
-		head->left = insertNodeBST(element, head->left);
-	}
-	head->height = 1 + branchHeight(head);
-	return head;
+	//the middle element is the root, and the halves on either side of it
+	//are its subtrees, which differ in size by at most one, so no node is
+	//ever out of balance
+	if(count == 0) return nullptr;
+	std::size_t middle = count / 2;
+	Node<StoredKey<KeyStorage, ElementType>>* left = buildBalanced(first, middle);
+	Node<StoredKey<KeyStorage, ElementType>>* right = buildBalanced(first + middle + 1, count - middle - 1);
+	Node<StoredKey<KeyStorage, ElementType>>* node = newNode(keys.keep(first[middle]), left, right, 1);
+	node->height = 1 + branchHeight(node);
+	return node;
 }
 
-template<typename ElementType>
-Node<ElementType>* AVLSet<ElementType>::copyTree(Node<ElementType>* head)
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+Node<StoredKey<KeyStorage, ElementType>>* AVLSet<ElementType, NodeAllocator, KeyStorage>::copyTree(Node<StoredKey<KeyStorage, ElementType>>* head)
 {
 	if(head == nullptr) return nullptr;
-	return newNode(head->data, copyTree(head->left), copyTree(head->right), head->height);
+
+	//the tree is copied in preorder; a node whose right subtree is still
+	//to be copied waits on a stack alongside its copy
+	NodeStack pending{static_cast<std::size_t>(getHeight(head))};
+	NodeStack copies{static_cast<std::size_t>(getHeight(head))};
+	Node<StoredKey<KeyStorage, ElementType>>* root = newNode(head->data, nullptr, nullptr, head->height);
+	Node<StoredKey<KeyStorage, ElementType>>* from = head;
+	Node<StoredKey<KeyStorage, ElementType>>* to = root;
+	for(;;)
+	{
+		if(from->right != nullptr)
+		{
+			pending.push(from);
+			copies.push(to);
+		}
+		if(from->left != nullptr)
+		{
+			from = from->left;
+			to->left = newNode(from->data, nullptr, nullptr, from->height);
+			to = to->left;
+		}
+		else if(!pending.empty())
+		{
+			from = pending.pop()->right;
+			to = copies.pop();
+			to->right = newNode(from->data, nullptr, nullptr, from->height);
+			to = to->right;
+		}
+		else
+			return root;
+	}
 }
 
-template<typename ElementType>
-void AVLSet<ElementType>::deleteTree(Node<ElementType>* head)
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+void AVLSet<ElementType, NodeAllocator, KeyStorage>::deleteTree(Node<StoredKey<KeyStorage, ElementType>>* head)
 {
-	if(head != nullptr)
+	if constexpr (decltype(nodes)::RELEASES_IN_BULK)
+	{
+		nodes.releaseAll();
+	}
+	else
 	{
-		deleteTree(head->left);
-		deleteTree(head->right);
-		delete head;
+		//rotating each left child up until there is none leaves a node
+		//that can be destroyed once its right child is remembered, so no
+		//stack is needed
+		while(head != nullptr)
+		{
+			Node<StoredKey<KeyStorage, ElementType>>* left = head->left;
+			if(left != nullptr)
+			{
+				head->left = left->right;
+				left->right = head;
+				head = left;
+			}
+			else
+			{
+				Node<StoredKey<KeyStorage, ElementType>>* right = head->right;
+				nodes.destroy(head);
+				head = right;
+			}
+		}
 	}
 }
 
-template<typename ElementType>
-bool AVLSet<ElementType>::containsNode(const ElementType& element, Node<ElementType>* head) const
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+bool AVLSet<ElementType, NodeAllocator, KeyStorage>::containsNode(const ElementType& element, Node<StoredKey<KeyStorage, ElementType>>* head) const
 {
-	if (head != nullptr) 
+	while(head != nullptr)
 	{
-		if(element == head->data)
+		int order = keys.compare(element, head->data);
+		if(order == 0)
 			return true;
-		else if(element < head->data)
-			return containsNode(element, head->left);
-		else if(element > head-> data)
-			return containsNode(element, head->right);
+		head = (order < 0 ? head->left : head->right);
 	}
 	return false;
 }
 
-template <typename ElementType>
-void AVLSet<ElementType>::previsitnode(VisitFunction& visit, Node<ElementType>* head) const
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+bool AVLSet<ElementType, NodeAllocator, KeyStorage>::containsFrozen(const ElementType& element) const
 {
-	if(head == nullptr) return;
-	visit(head->data);
-	previsitnode(visit, head->left);
-	previsitnode(visit, head->right);
+	//the direction taken is left as a branch: a fully branch-free descent
+	//(one that always reaches the leaves) turned out slower, since the
+	//candidates WordChecker tries share most of their search path, which
+	//the branch predictor learns
+	std::size_t index = 1;
+	while(index <= treesize)
+	{
+#if defined(__GNUC__)
+		//only once there are descendants that far down; the address is
+		//worked out as an integer, since the second cache line can lie
+		//past the end of the array, where no pointer may be formed (a
+		//prefetch itself never faults)
+		if(index * PREFETCH_KEYS <= treesize)
+		{
+			std::uintptr_t below = reinterpret_cast<std::uintptr_t>(frozenkeys) + index * PREFETCH_KEYS * sizeof(StoredKey<KeyStorage, ElementType>);
+			__builtin_prefetch(reinterpret_cast<const void*>(below));
+			__builtin_prefetch(reinterpret_cast<const void*>(below + FROZEN_ALIGNMENT));
+		}
+#endif
+		int order = keys.compare(element, frozenkeys[index]);
+		if(order == 0)
+			return true;
+		//written as a branch so that the compiler keeps it one
+		if(order < 0)
+			index = 2 * index;
+		else
+			index = 2 * index + 1;
+	}
+	return false;
 }
-template <typename ElementType>
-void AVLSet<ElementType>::invisitnode(VisitFunction& visit, Node<ElementType>* head) const
+
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+void AVLSet<ElementType, NodeAllocator, KeyStorage>::fillFrozen()
 {
-	if(head == nullptr) return;
-	invisitnode(visit, head->left);
-	visit(head->data);
-	invisitnode(visit, head->right);
-	return;
+	//an inorder walk of the implicit tree visits the array's positions in
+	//the order the keys come out of an inorder walk of the real one; it
+	//starts at the leftmost position, and each step goes to the leftmost
+	//position in the right subtree, or else up past every right child to
+	//the parent of a left one
+	std::size_t index = 1;
+	while(2 * index <= treesize)
+		index = 2 * index;
+	for(const_iterator i = begin(); i != end(); ++i)
+	{
+		new (&frozenkeys[index]) StoredKey<KeyStorage, ElementType>{i.current()->data};
+		if(2 * index + 1 <= treesize)
+		{
+			index = 2 * index + 1;
+			while(2 * index <= treesize)
+				index = 2 * index;
+		}
+		else
+		{
+			while(index % 2 == 1)
+				index = index / 2;
+			index = index / 2;
+		}
+	}
 }
-template <typename ElementType>
-void AVLSet<ElementType>::postvisitnode(VisitFunction& visit, Node<ElementType>* head) const
+
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+void AVLSet<ElementType, NodeAllocator, KeyStorage>::releaseFrozen() noexcept
 {
-	if(head == nullptr) return;
-	postvisitnode(visit, head->left);
-	postvisitnode(visit, head->right);
-	visit(head->data);
+	if(frozenkeys == nullptr) return;
+	for(std::size_t i = 1; i <= treesize; i++)
+		std::destroy_at(&frozenkeys[i]);
+	::operator delete(frozenkeys, std::align_val_t{FROZEN_ALIGNMENT});
+	frozenkeys = nullptr;
 }
 
 #endif // AVLSET_HPP
\ No newline at end of file
@@ -0,0 +1,831 @@
+// BTreeSet.hpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+//
+// A BTreeSet is an implementation of an OrderedSet that is a B+tree.  All
+// of the elements are kept in leaves, in sorted arrays, and the leaves are
+// linked together in ascending order; above them, inner nodes hold sorted
+// arrays of separator keys and pointers to their children.  Every node is
+// about NodeBytes bytes (a handful of cache lines), and holds as many keys
+// as fit in that, so a lookup follows only one pointer per level -- five
+// levels for 60,000 words, instead of the sixteen or so in an AVL tree --
+// and the cache lines it reads within a node are next to one another, so
+// they're all prefetched as soon as the node is reached.
+//
+// Beside its keys, each node keeps an array of their prefixes: 64-bit
+// integers that are ordered the same way as the keys (for a string, its
+// first eight characters).  A search works out the element's prefix once,
+// and then counts the prefixes in each node that are less than it, which
+// are plain integers packed into a cache line or two; the keys themselves
+// (and, for longer strings, the characters they point to) are only
+// compared when their prefixes are the same as the element's, which is
+// usually just to confirm that a word that was found is really there.
+//
+// Like AVLSet, a BTreeSet takes a NodeAllocator, which its leaves and inner
+// nodes come from, and a KeyStorage, which decides what is kept in the
+// nodes' arrays.  With InternedKeys, each key is an 8-byte handle, so
+// more than twice as many fit in each node.
+//
+// A node that is full when something is added to it is split in half, so
+// a tree built one element at a time has nodes that are between half and
+// completely full.  addAll() can instead build an empty tree bottom-up
+// from sorted elements in linear time, with every node full (or nearly
+// so), since a word set is rarely added to once it's loaded.
+
+#ifndef BTREESET_HPP
+#define BTREESET_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "KeyStorage.hpp"
+#include "NodeAllocator.hpp"
+#include "OrderedSet.hpp"
+#include "ParallelSort.hpp"
+
+
+
+namespace impl_
+{
+	// BTreePrefix<ElementType>::of() returns a 64-bit integer such that
+	// if a < b, then of(a) <= of(b).  When EXACT is true, elements with
+	// the same prefix are equal, so their keys never need to be compared.
+	// Types other than strings and integers all get the same prefix,
+	// which leaves every search to compare keys.
+	template <typename ElementType, typename = void>
+	struct BTreePrefix
+	{
+		static constexpr bool EXACT = false;
+
+		static std::uint64_t of(const ElementType&) noexcept
+		{
+			return 0;
+		}
+	};
+
+
+	//an integer's prefix is its value, with the sign bit flipped so that
+	//negative values come first
+	template <typename ElementType>
+	struct BTreePrefix<ElementType, std::enable_if_t<std::is_integral_v<ElementType>>>
+	{
+		static constexpr bool EXACT = sizeof(ElementType) <= sizeof(std::uint64_t);
+
+		static std::uint64_t of(ElementType element) noexcept
+		{
+			std::uint64_t value = static_cast<std::uint64_t>(element);
+			if constexpr (std::is_signed_v<ElementType>)
+				value ^= std::uint64_t{1} << 63;
+			return value;
+		}
+	};
+
+
+	//a string's prefix is its first eight characters, as unsigned bytes,
+	//with the first one most significant (and zeroes after the end of a
+	//shorter string), which is the order std::string::compare() uses
+	template <>
+	struct BTreePrefix<std::string>
+	{
+		static constexpr bool EXACT = false;
+
+		static std::uint64_t of(const std::string& element) noexcept
+		{
+			std::uint64_t prefix = 0;
+			std::size_t length = std::min<std::size_t>(element.length(), 8);
+			for(std::size_t i = 0; i < length; i++)
+				prefix |= std::uint64_t{static_cast<unsigned char>(element[i])} << (56 - 8 * i);
+			return prefix;
+		}
+	};
+}
+
+
+
+template <typename ElementType, typename NodeAllocator = HeapNodeAllocator, typename KeyStorage = DirectKeys, std::size_t NodeBytes = 512>
+class BTreeSet : public OrderedSet<ElementType>
+{
+public:
+	// A WhileFunction is a visit function that returns false to stop the
+	// visiting (see OrderedSet).
+	using WhileFunction = typename OrderedSet<ElementType>::WhileFunction;
+
+public:
+	// Initializes a BTreeSet to be empty.
+	BTreeSet();
+
+	// Cleans up the BTreeSet so that it leaks no memory.
+	virtual ~BTreeSet() noexcept;
+
+	// Initializes a new BTreeSet to be a copy of an existing one.
+	BTreeSet(const BTreeSet& s);
+
+	// Initializes a new BTreeSet whose contents are moved from an
+	// expiring one.
+	BTreeSet(BTreeSet&& s) noexcept;
+
+	// Assigns an existing BTreeSet into another.
+	BTreeSet& operator=(const BTreeSet& s);
+
+	// Assigns an expiring BTreeSet into another.
+	BTreeSet& operator=(BTreeSet&& s) noexcept;
+
+
+	virtual bool isImplemented() const noexcept override;
+
+
+	// add() adds an element to the set.  If the element is already in the
+	// set, this function has no effect.  This function runs in O(log n)
+	// time when there are n elements in the tree.
+	virtual void add(const ElementType& element) override;
+
+
+	// addAll() adds every element in the vector.  If the set is empty, it
+	// builds the tree bottom-up from the elements in order, in linear
+	// time, with full nodes; if the elements aren't known to be sorted, a
+	// copy of them is sorted (see parallelSort()) first.  Otherwise, it
+	// calls add() for each one.
+	virtual void addAll(const std::vector<ElementType>& elements, bool sorted = false) override;
+
+
+	// buildsInBulk() returns true while the set is empty, since addAll()
+	// then builds the tree bottom-up.
+	virtual bool buildsInBulk() const noexcept override;
+
+
+	// contains() returns true if the given element is already in the set,
+	// false otherwise.  This function runs in O(log n) time when there are
+	// n elements in the tree.
+	virtual bool contains(const ElementType& element) const override;
+
+
+	// size() returns the number of elements in the set.
+	virtual std::size_t size() const noexcept override;
+
+
+	// freeze() gives back whatever room the KeyStorage has set aside for
+	// elements that haven't been added.
+	virtual void freeze() override;
+
+
+	// printStatistics() writes the number of levels and nodes in the tree,
+	// and how full its leaves are.
+	virtual void printStatistics(std::ostream& out) const override;
+
+
+	// visitFrom() calls the given "visit" function for each element that
+	// is not less than low, in ascending order, until it returns false.
+	// This searches for low once and then walks along the leaves, so it
+	// runs in O(log n + k) time when k elements are visited.
+	virtual std::size_t visitFrom(const ElementType& low, WhileFunction visit) const override;
+
+
+	// height() returns the number of levels of inner nodes above the
+	// leaves (so a tree that is a single leaf has height 0).  As in AVLSet,
+	// the height of an empty tree is -1.
+	int height() const noexcept;
+
+
+private:
+	using Key = StoredKey<KeyStorage, ElementType>;
+	using Prefix = impl_::BTreePrefix<ElementType>;
+
+	// Each node starts with its count (and, in a leaf, the link to the
+	// next leaf); its arrays fill the rest of NodeBytes.  A node holds at
+	// least four keys no matter how large they are.
+	static constexpr std::size_t NODE_HEADER_BYTES = 16;
+	static constexpr std::size_t ENTRY_BYTES = sizeof(std::uint64_t) + sizeof(Key);
+	static constexpr unsigned int LEAF_KEYS =
+		std::max<std::size_t>(4, (NodeBytes - NODE_HEADER_BYTES) / ENTRY_BYTES);
+	static constexpr unsigned int INNER_KEYS =
+		std::max<std::size_t>(4, (NodeBytes - NODE_HEADER_BYTES - sizeof(void*)) / (ENTRY_BYTES + sizeof(void*)));
+
+	//prefixes[i] is the prefix of keys[i]; the prefixes (and, in an Inner,
+	//the children) come before the keys, since they're what a search
+	//reads, and the keys are only read when prefixes are the same
+	struct Leaf
+	{
+		unsigned int count;
+		Leaf* next;
+		std::uint64_t prefixes[LEAF_KEYS];
+		Key keys[LEAF_KEYS];
+	};
+
+	//children[i] holds the keys not less than keys[i - 1] and less than
+	//keys[i]; the children are Leafs on the lowest inner level, and Inners
+	//above that
+	struct Inner
+	{
+		unsigned int count;
+		std::uint64_t prefixes[INNER_KEYS];
+		void* children[INNER_KEYS + 1];
+		Key keys[INNER_KEYS];
+	};
+
+	//when a node is split, a Split describes the new node to its right:
+	//the smallest key under it (and that key's prefix), which its parent
+	//will use to separate it from its left sibling
+	struct Split
+	{
+		Key key;
+		std::uint64_t prefix;
+		void* right;
+	};
+
+	//root is nullptr when the set is empty; innerlevels is the number of
+	//levels of Inners above the Leafs
+	void* root;
+	unsigned int innerlevels;
+	std::size_t treesize;
+	std::size_t leafcount;
+	std::size_t innercount;
+	typename NodeAllocator::template Pool<Leaf> leaves;
+	typename NodeAllocator::template Pool<Inner> inners;
+	typename KeyStorage::template Store<ElementType> keys;
+
+	Leaf* newLeaf();
+	Inner* newInner();
+	static void prefetchSearchedPart(const void* node, unsigned int level) noexcept;
+	static void countPrefixes(const std::uint64_t* prefixes, unsigned int count, std::uint64_t prefix, unsigned int& low, unsigned int& high) noexcept;
+	unsigned int childIndex(const Inner* inner, const ElementType& element, std::uint64_t prefix) const;
+	unsigned int leafPosition(const Leaf* leaf, const ElementType& element, std::uint64_t prefix, bool& found) const;
+	const Leaf* findLeaf(const ElementType& element, std::uint64_t prefix) const;
+	bool insertInto(void* node, unsigned int level, const ElementType& element, std::uint64_t prefix, Split& split);
+	bool insertIntoLeaf(Leaf* leaf, const ElementType& element, std::uint64_t prefix, Split& split);
+	void insertIntoInner(Inner* inner, unsigned int index, Split&& child, Split& split);
+	void buildFrom(const ElementType* first, std::size_t count);
+	void* copyNode(const void* node, unsigned int level, Leaf*& previous);
+	void deleteNode(void* node, unsigned int level) noexcept;
+	void deleteTree() noexcept;
+};
+
+
+
+template <typename ElementType, typename NodeAllocator, typename KeyStorage, std::size_t NodeBytes>
+BTreeSet<ElementType, NodeAllocator, KeyStorage, NodeBytes>::BTreeSet()
+	: root{nullptr}, innerlevels{0}, treesize{0}, leafcount{0}, innercount{0}
+{
+}
+
+
+template <typename ElementType, typename NodeAllocator, typename KeyStorage, std::size_t NodeBytes>
+BTreeSet<ElementType, NodeAllocator, KeyStorage, NodeBytes>::~BTreeSet() noexcept
+{
+	deleteTree();
+}
+
+
+template <typename ElementType, typename NodeAllocator, typename KeyStorage, std::size_t NodeBytes>
+BTreeSet<ElementType, NodeAllocator, KeyStorage, NodeBytes>::BTreeSet(const BTreeSet& s)
+	: root{nullptr}, innerlevels{s.innerlevels}, treesize{s.treesize}, leafcount{0}, innercount{0}, keys{s.keys}
+{
+	Leaf* previous = nullptr;
+	if(s.root != nullptr)
+		root = copyNode(s.root, s.innerlevels, previous);
+}
+
+
+template <typename ElementType, typename NodeAllocator, typename KeyStorage, std::size_t NodeBytes>
+BTreeSet<ElementType, NodeAllocator, KeyStorage, NodeBytes>::BTreeSet(BTreeSet&& s) noexcept
+	: root{s.root}, innerlevels{s.innerlevels}, treesize{s.treesize}, leafcount{s.leafcount}, innercount{s.innercount},
+	  leaves{std::move(s.leaves)}, inners{std::move(s.inners)}, keys{std::move(s.keys)}
+{
+	s.root = nullptr;
+	s.innerlevels = 0;
+	s.treesize = 0;
+	s.leafcount = 0;
+	s.innercount = 0;
+}
+
+
+template <typename ElementType, typename NodeAllocator, typename KeyStorage, std::size_t NodeBytes>
+BTreeSet<ElementType, NodeAllocator, KeyStorage, NodeBytes>& BTreeSet<ElementType, NodeAllocator, KeyStorage, NodeBytes>::operator=(const BTreeSet& s)
+{
+	if(this != &s)
+	{
+		deleteTree();
+		keys = s.keys;
+		innerlevels = s.innerlevels;
+		treesize = s.treesize;
+		Leaf* previous = nullptr;
+		if(s.root != nullptr)
+			root = copyNode(s.root, s.innerlevels, previous);
+	}
+	return *this;
+}
+
+
+template <typename ElementType, typename NodeAllocator, typename KeyStorage, std::size_t NodeBytes>
+BTreeSet<ElementType, NodeAllocator, KeyStorage, NodeBytes>& BTreeSet<ElementType, NodeAllocator, KeyStorage, NodeBytes>::operator=(BTreeSet&& s) noexcept
+{
+	std::swap(root, s.root);
+	std::swap(innerlevels, s.innerlevels);
+	std::swap(treesize, s.treesize);
+	std::swap(leafcount, s.leafcount);
+	std::swap(innercount, s.innercount);
+	std::swap(leaves, s.leaves);
+	std::swap(inners, s.inners);
+	std::swap(keys, s.keys);
+	return *this;
+}
+
+
+template <typename ElementType, typename NodeAllocator, typename KeyStorage, std::size_t NodeBytes>
+bool BTreeSet<ElementType, NodeAllocator, KeyStorage, NodeBytes>::isImplemented() const noexcept
+{
+	return true;
+}
+
+
+template <typename ElementType, typename NodeAllocator, typename KeyStorage, std::size_t NodeBytes>
+void BTreeSet<ElementType, NodeAllocator, KeyStorage, NodeBytes>::add(const ElementType& element)
+{
+	if(root == nullptr)
+		root = newLeaf();
+
+	Split split{Key{}, 0, nullptr};
+	if(!insertInto(root, innerlevels, element, Prefix::of(element), split))
+		return;
+	treesize++;
+
+	//the root was split, so the tree grows a level
+	if(split.right != nullptr)
+	{
+		Inner* newroot = newInner();
+		newroot->count = 1;
+		newroot->prefixes[0] = split.prefix;
+		newroot->keys[0] = std::move(split.key);
+		newroot->children[0] = root;
+		newroot->children[1] = split.right;
+		root = newroot;
+		innerlevels++;
+	}
+}
+
+
+template <typename ElementType, typename NodeAllocator, typename KeyStorage, std::size_t NodeBytes>
+void BTreeSet<ElementType, NodeAllocator, KeyStorage, NodeBytes>::addAll(const std::vector<ElementType>& elements, bool sorted)
+{
+	if(treesize != 0)
+	{
+		for(const ElementType& element : elements)
+			add(element);
+		return;
+	}
+
+	//the sorted elements can be used as they are unless they have
+	//duplicates in them; otherwise, a copy is sorted and/or made unique
+	if(sorted && std::adjacent_find(elements.begin(), elements.end()) == elements.end())
+	{
+		buildFrom(elements.data(), elements.size());
+		return;
+	}
+
+	std::vector<ElementType> ordered{elements};
+	if(!sorted)
+		parallelSort(ordered);
+	ordered.erase(std::unique(ordered.begin(), ordered.end()), ordered.end());
+	buildFrom(ordered.data(), ordered.size());
+}
+
+
+template <typename ElementType, typename NodeAllocator, typename KeyStorage, std::size_t NodeBytes>
+bool BTreeSet<ElementType, NodeAllocator, KeyStorage, NodeBytes>::buildsInBulk() const noexcept
+{
+	return treesize == 0;
+}
+
+
+template <typename ElementType, typename NodeAllocator, typename KeyStorage, std::size_t NodeBytes>
+bool BTreeSet<ElementType, NodeAllocator, KeyStorage, NodeBytes>::contains(const ElementType& element) const
+{
+	std::uint64_t prefix = Prefix::of(element);
+	const Leaf* leaf = findLeaf(element, prefix);
+	if(leaf == nullptr)
+		return false;
+
+	bool found;
+	leafPosition(leaf, element, prefix, found);
+	return found;
+}
+
+
+template <typename ElementType, typename NodeAllocator, typename KeyStorage, std::size_t NodeBytes>
+std::size_t BTreeSet<ElementType, NodeAllocator, KeyStorage, NodeBytes>::size() const noexcept
+{
+	return treesize;
+}
+
+
+template <typename ElementType, typename NodeAllocator, typename KeyStorage, std::size_t NodeBytes>
+void BTreeSet<ElementType, NodeAllocator, KeyStorage, NodeBytes>::freeze()
+{
+	keys.shrinkToFit();
+}
+
+
+template <typename ElementType, typename NodeAllocator, typename KeyStorage, std::size_t NodeBytes>
+void BTreeSet<ElementType, NodeAllocator, KeyStorage, NodeBytes>::printStatistics(std::ostream& out) const
+{
+	out << "B+tree: " << height() + 1 << " levels, "
+		<< leafcount << " leaves of " << LEAF_KEYS << " keys, "
+		<< innercount << " inner nodes of " << INNER_KEYS << " keys" << std::endl;
+
+	if(leafcount != 0)
+		out << "Leaves are " << 100.0 * treesize / (leafcount * LEAF_KEYS) << "% full" << std::endl;
+}
+
+
+template <typename ElementType, typename NodeAllocator, typename KeyStorage, std::size_t NodeBytes>
+std::size_t BTreeSet<ElementType, NodeAllocator, KeyStorage, NodeBytes>::visitFrom(const ElementType& low, WhileFunction visit) const
+{
+	std::uint64_t prefix = Prefix::of(low);
+	const Leaf* leaf = findLeaf(low, prefix);
+	if(leaf == nullptr)
+		return 0;
+
+	bool found;
+	unsigned int position = leafPosition(leaf, low, prefix, found);
+	std::size_t visited = 0;
+
+	for(; leaf != nullptr; leaf = leaf->next, position = 0)
+	{
+		for(; position < leaf->count; position++)
+		{
+			visited++;
+			if(!visit(keys.element(leaf->keys[position])))
+				return visited;
+		}
+	}
+	return visited;
+}
+
+
+template <typename ElementType, typename NodeAllocator, typename KeyStorage, std::size_t NodeBytes>
+int BTreeSet<ElementType, NodeAllocator, KeyStorage, NodeBytes>::height() const noexcept
+{
+	return root == nullptr ? -1 : static_cast<int>(innerlevels);
+}
+
+
+template <typename ElementType, typename NodeAllocator, typename KeyStorage, std::size_t NodeBytes>
+typename BTreeSet<ElementType, NodeAllocator, KeyStorage, NodeBytes>::Leaf* BTreeSet<ElementType, NodeAllocator, KeyStorage, NodeBytes>::newLeaf()
+{
+	leafcount++;
+	return leaves.create();
+}
+
+
+template <typename ElementType, typename NodeAllocator, typename KeyStorage, std::size_t NodeBytes>
+typename BTreeSet<ElementType, NodeAllocator, KeyStorage, NodeBytes>::Inner* BTreeSet<ElementType, NodeAllocator, KeyStorage, NodeBytes>::newInner()
+{
+	innercount++;
+	return inners.create();
+}
+
+
+template <typename ElementType, typename NodeAllocator, typename KeyStorage, std::size_t NodeBytes>
+void BTreeSet<ElementType, NodeAllocator, KeyStorage, NodeBytes>::prefetchSearchedPart(const void* node, unsigned int level) noexcept
+{
+	//all of the cache lines a search of the node will read are fetched at
+	//once, rather than one after another as the search reaches them
+#if defined(__GNUC__)
+	constexpr std::size_t CACHE_LINE = 64;
+	const char* start = static_cast<const char*>(node);
+	const char* end = start + (level == 0 ? offsetof(Leaf, keys) : offsetof(Inner, keys));
+	for(const char* line = start; line < end; line += CACHE_LINE)
+		__builtin_prefetch(line);
+#endif
+}
+
+
+template <typename ElementType, typename NodeAllocator, typename KeyStorage, std::size_t NodeBytes>
+void BTreeSet<ElementType, NodeAllocator, KeyStorage, NodeBytes>::countPrefixes(const std::uint64_t* prefixes, unsigned int count, std::uint64_t prefix, unsigned int& low, unsigned int& high) noexcept
+{
+	//the prefixes less than, and the same as, the given one are counted
+	//in one pass with no branches, which is faster than binary searching
+	//an array this short (whose branches are unpredictable)
+	unsigned int less = 0;
+	unsigned int same = 0;
+	for(unsigned int i = 0; i < count; i++)
+	{
+		less += prefixes[i] < prefix;
+		same += prefixes[i] == prefix;
+	}
+	low = less;
+	high = less + same;
+}
+
+
+template <typename ElementType, typename NodeAllocator, typename KeyStorage, std::size_t NodeBytes>
+unsigned int BTreeSet<ElementType, NodeAllocator, KeyStorage, NodeBytes>::childIndex(const Inner* inner, const ElementType& element, std::uint64_t prefix) const
+{
+	//the number of keys not greater than the element; only the keys whose
+	//prefix is the same as the element's need to be compared with it
+	unsigned int low;
+	unsigned int high;
+	countPrefixes(inner->prefixes, inner->count, prefix, low, high);
+	if(low == high || Prefix::EXACT)
+		return high;
+
+	while(low < high)
+	{
+		unsigned int middle = (low + high) / 2;
+		if(keys.compare(element, inner->keys[middle]) < 0)
+			high = middle;
+		else
+			low = middle + 1;
+	}
+	return low;
+}
+
+
+template <typename ElementType, typename NodeAllocator, typename KeyStorage, std::size_t NodeBytes>
+unsigned int BTreeSet<ElementType, NodeAllocator, KeyStorage, NodeBytes>::leafPosition(const Leaf* leaf, const ElementType& element, std::uint64_t prefix, bool& found) const
+{
+	//the position of the first key not less than the element, stopping
+	//early if one equal to it is found along the way
+	unsigned int low;
+	unsigned int high;
+	countPrefixes(leaf->prefixes, leaf->count, prefix, low, high);
+	found = (low != high && Prefix::EXACT);
+	if(low == high || Prefix::EXACT)
+		return low;
+
+	while(low < high)
+	{
+		unsigned int middle = (low + high) / 2;
+		int order = keys.compare(element, leaf->keys[middle]);
+		if(order == 0)
+		{
+			found = true;
+			return middle;
+		}
+		if(order < 0)
+			high = middle;
+		else
+			low = middle + 1;
+	}
+	return low;
+}
+
+
+template <typename ElementType, typename NodeAllocator, typename KeyStorage, std::size_t NodeBytes>
+const typename BTreeSet<ElementType, NodeAllocator, KeyStorage, NodeBytes>::Leaf* BTreeSet<ElementType, NodeAllocator, KeyStorage, NodeBytes>::findLeaf(const ElementType& element, std::uint64_t prefix) const
+{
+	const void* node = root;
+	if(node == nullptr)
+		return nullptr;
+
+	prefetchSearchedPart(node, innerlevels);
+	for(unsigned int level = innerlevels; level > 0; level--)
+	{
+		const Inner* inner = static_cast<const Inner*>(node);
+		node = inner->children[childIndex(inner, element, prefix)];
+		prefetchSearchedPart(node, level - 1);
+	}
+	return static_cast<const Leaf*>(node);
+}
+
+
+template <typename ElementType, typename NodeAllocator, typename KeyStorage, std::size_t NodeBytes>
+bool BTreeSet<ElementType, NodeAllocator, KeyStorage, NodeBytes>::insertInto(void* node, unsigned int level, const ElementType& element, std::uint64_t prefix, Split& split)
+{
+	//returns false if the element was already there; if the node had to
+	//be split, split.right is set to its new right sibling
+	if(level == 0)
+		return insertIntoLeaf(static_cast<Leaf*>(node), element, prefix, split);
+
+	Inner* inner = static_cast<Inner*>(node);
+	unsigned int index = childIndex(inner, element, prefix);
+	Split childsplit{Key{}, 0, nullptr};
+	if(!insertInto(inner->children[index], level - 1, element, prefix, childsplit))
+		return false;
+	if(childsplit.right != nullptr)
+		insertIntoInner(inner, index, std::move(childsplit), split);
+	return true;
+}
+
+
+template <typename ElementType, typename NodeAllocator, typename KeyStorage, std::size_t NodeBytes>
+bool BTreeSet<ElementType, NodeAllocator, KeyStorage, NodeBytes>::insertIntoLeaf(Leaf* leaf, const ElementType& element, std::uint64_t prefix, Split& split)
+{
+	bool found;
+	unsigned int position = leafPosition(leaf, element, prefix, found);
+	if(found)
+		return false;
+
+	Leaf* sibling = nullptr;
+	if(leaf->count == LEAF_KEYS)
+	{
+		sibling = newLeaf();
+		unsigned int half = (LEAF_KEYS + 1) / 2;
+		std::copy(leaf->prefixes + half, leaf->prefixes + LEAF_KEYS, sibling->prefixes);
+		std::move(leaf->keys + half, leaf->keys + LEAF_KEYS, sibling->keys);
+		sibling->count = LEAF_KEYS - half;
+		leaf->count = half;
+		sibling->next = leaf->next;
+		leaf->next = sibling;
+
+		if(position > half)
+		{
+			leaf = sibling;
+			position -= half;
+		}
+	}
+
+	std::copy_backward(leaf->prefixes + position, leaf->prefixes + leaf->count, leaf->prefixes + leaf->count + 1);
+	std::move_backward(leaf->keys + position, leaf->keys + leaf->count, leaf->keys + leaf->count + 1);
+	leaf->prefixes[position] = prefix;
+	leaf->keys[position] = keys.keep(element);
+	leaf->count++;
+
+	if(sibling != nullptr)
+		split = Split{sibling->keys[0], sibling->prefixes[0], sibling};
+	return true;
+}
+
+
+template <typename ElementType, typename NodeAllocator, typename KeyStorage, std::size_t NodeBytes>
+void BTreeSet<ElementType, NodeAllocator, KeyStorage, NodeBytes>::insertIntoInner(Inner* inner, unsigned int index, Split&& child, Split& split)
+{
+	//the child's key and node go in at keys[index] and children[index + 1],
+	//after splitting this node if it's full; the middle key moves up to
+	//the parent, and the keys after it move to the new sibling
+	if(inner->count == INNER_KEYS)
+	{
+		Inner* sibling = newInner();
+		unsigned int half = INNER_KEYS / 2;
+		split = Split{std::move(inner->keys[half]), inner->prefixes[half], sibling};
+		std::copy(inner->prefixes + half + 1, inner->prefixes + INNER_KEYS, sibling->prefixes);
+		std::move(inner->keys + half + 1, inner->keys + INNER_KEYS, sibling->keys);
+		std::copy(inner->children + half + 1, inner->children + INNER_KEYS + 1, sibling->children);
+		sibling->count = INNER_KEYS - half - 1;
+		inner->count = half;
+
+		if(index > half)
+		{
+			inner = sibling;
+			index -= half + 1;
+		}
+	}
+
+	std::copy_backward(inner->prefixes + index, inner->prefixes + inner->count, inner->prefixes + inner->count + 1);
+	std::move_backward(inner->keys + index, inner->keys + inner->count, inner->keys + inner->count + 1);
+	std::copy_backward(inner->children + index + 1, inner->children + inner->count + 1, inner->children + inner->count + 2);
+	inner->prefixes[index] = child.prefix;
+	inner->keys[index] = std::move(child.key);
+	inner->children[index + 1] = child.right;
+	inner->count++;
+}
+
+
+template <typename ElementType, typename NodeAllocator, typename KeyStorage, std::size_t NodeBytes>
+void BTreeSet<ElementType, NodeAllocator, KeyStorage, NodeBytes>::buildFrom(const ElementType* first, std::size_t count)
+{
+	if(count == 0)
+		return;
+
+	//the elements are spread evenly across as few leaves as will hold
+	//them, and then each level of inner nodes is built the same way from
+	//the level below it, until there's only one node; lows[i] is the
+	//smallest key under level[i] (and lowprefixes[i] is its prefix)
+	std::size_t nodecount = (count + LEAF_KEYS - 1) / LEAF_KEYS;
+	std::vector<void*> level;
+	std::vector<Key> lows;
+	std::vector<std::uint64_t> lowprefixes;
+	level.reserve(nodecount);
+	lows.reserve(nodecount);
+	lowprefixes.reserve(nodecount);
+
+	Leaf* previous = nullptr;
+	std::size_t next = 0;
+	for(std::size_t i = 0; i < nodecount; i++)
+	{
+		Leaf* leaf = newLeaf();
+		for(std::size_t end = count * (i + 1) / nodecount; next < end; next++)
+		{
+			leaf->prefixes[leaf->count] = Prefix::of(first[next]);
+			leaf->keys[leaf->count++] = keys.keep(first[next]);
+		}
+		if(previous != nullptr)
+			previous->next = leaf;
+		previous = leaf;
+		level.push_back(leaf);
+		lows.push_back(leaf->keys[0]);
+		lowprefixes.push_back(leaf->prefixes[0]);
+	}
+
+	unsigned int levels = 0;
+	while(level.size() > 1)
+	{
+		std::size_t parentcount = (level.size() + INNER_KEYS) / (INNER_KEYS + 1);
+		std::vector<void*> parents;
+		std::vector<Key> parentlows;
+		std::vector<std::uint64_t> parentlowprefixes;
+		parents.reserve(parentcount);
+		parentlows.reserve(parentcount);
+		parentlowprefixes.reserve(parentcount);
+
+		std::size_t child = 0;
+		for(std::size_t i = 0; i < parentcount; i++)
+		{
+			Inner* inner = newInner();
+			parentlows.push_back(std::move(lows[child]));
+			parentlowprefixes.push_back(lowprefixes[child]);
+			inner->children[0] = level[child++];
+			for(std::size_t end = level.size() * (i + 1) / parentcount; child < end; child++)
+			{
+				inner->prefixes[inner->count] = lowprefixes[child];
+				inner->keys[inner->count++] = std::move(lows[child]);
+				inner->children[inner->count] = level[child];
+			}
+			parents.push_back(inner);
+		}
+
+		level.swap(parents);
+		lows.swap(parentlows);
+		lowprefixes.swap(parentlowprefixes);
+		levels++;
+	}
+
+	root = level[0];
+	innerlevels = levels;
+	treesize = count;
+}
+
+
+template <typename ElementType, typename NodeAllocator, typename KeyStorage, std::size_t NodeBytes>
+void* BTreeSet<ElementType, NodeAllocator, KeyStorage, NodeBytes>::copyNode(const void* node, unsigned int level, Leaf*& previous)
+{
+	//the leaves are copied from left to right, so each one is linked to
+	//the one copied just before it
+	if(level == 0)
+	{
+		Leaf* leaf = newLeaf();
+		const Leaf* source = static_cast<const Leaf*>(node);
+		std::copy(source->prefixes, source->prefixes + source->count, leaf->prefixes);
+		std::copy(source->keys, source->keys + source->count, leaf->keys);
+		leaf->count = source->count;
+		if(previous != nullptr)
+			previous->next = leaf;
+		previous = leaf;
+		return leaf;
+	}
+
+	Inner* inner = newInner();
+	const Inner* source = static_cast<const Inner*>(node);
+	std::copy(source->prefixes, source->prefixes + source->count, inner->prefixes);
+	std::copy(source->keys, source->keys + source->count, inner->keys);
+	inner->count = source->count;
+	for(unsigned int i = 0; i <= source->count; i++)
+		inner->children[i] = copyNode(source->children[i], level - 1, previous);
+	return inner;
+}
+
+
+template <typename ElementType, typename NodeAllocator, typename KeyStorage, std::size_t NodeBytes>
+void BTreeSet<ElementType, NodeAllocator, KeyStorage, NodeBytes>::deleteNode(void* node, unsigned int level) noexcept
+{
+	if(level == 0)
+	{
+		leaves.destroy(static_cast<Leaf*>(node));
+		return;
+	}
+
+	Inner* inner = static_cast<Inner*>(node);
+	for(unsigned int i = 0; i <= inner->count; i++)
+		deleteNode(inner->children[i], level - 1);
+	inners.destroy(inner);
+}
+
+
+template <typename ElementType, typename NodeAllocator, typename KeyStorage, std::size_t NodeBytes>
+void BTreeSet<ElementType, NodeAllocator, KeyStorage, NodeBytes>::deleteTree() noexcept
+{
+	if constexpr (decltype(leaves)::RELEASES_IN_BULK)
+	{
+		leaves.releaseAll();
+		inners.releaseAll();
+	}
+	else if(root != nullptr)
+	{
+		deleteNode(root, innerlevels);
+	}
+
+	root = nullptr;
+	innerlevels = 0;
+	treesize = 0;
+	leafcount = 0;
+	innercount = 0;
+}
+
+
+
+#endif // BTREESET_HPP
@@ -0,0 +1,388 @@
+// BloomFilterSet.hpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+//
+// A BloomFilterSet is a decorator: it wraps any other Set and puts a
+// Bloom filter in front of it.  Every element added is added to both.
+// contains() asks the filter first; when the filter says the element is
+// definitely absent (as it does for nearly every element that really is
+// absent), contains() returns false without touching the wrapped set at
+// all.  Otherwise, the wrapped set has the final say.  This pays off when
+// most lookups are misses, as when WordChecker::findSuggestions() tries
+// dozens of candidate words for every misspelling.
+//
+// The filter is "blocked": it is an array of 64-byte blocks, each the size
+// of a cache line.  The element's hash, remixed with mixHash() so that
+// even a 32-bit Hasher spreads elements over every block, picks a block;
+// a second remix of it picks HASH_COUNT bits within that block, so a
+// lookup touches exactly one cache line.  The filter is
+// sized, at BITS_PER_ELEMENT bits per element, by reserve() (WordSetLoader
+// calls it before loading); without a reserve(), it starts at
+// DEFAULT_BLOCK_COUNT blocks.  Since a Set can't list its elements, the
+// filter can't be rebuilt larger later, so adding far more elements than
+// it was sized for raises its false positive rate (though it never causes
+// a wrong answer).
+//
+// Whether contains() counts the lookups it filters is up to a
+// LookupCounting policy, as in HashSet; by default it doesn't.
+
+#ifndef BLOOMFILTERSET_HPP
+#define BLOOMFILTERSET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <memory>
+#include <ostream>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "HashMixing.hpp"
+#include "HasherTraits.hpp"
+#include "Set.hpp"
+
+
+
+// A LookupCounting policy for a BloomFilterSet decides whether contains()
+// counts the lookups the filter answers by itself, the ones it passes on
+// to the wrapped set, and the false positives among those.
+// UncountedFilterLookups is the default: it keeps no counters, so
+// contains() stores nothing and can be called from several threads at
+// once (if the wrapped set's contains() can).  CountedFilterLookups keeps
+// them, for when the filter's effectiveness is what's being measured.
+struct UncountedFilterLookups
+{
+	static constexpr bool COUNTED = false;
+	static constexpr unsigned long long filtered = 0;
+	static constexpr unsigned long long passed = 0;
+	static constexpr unsigned long long falsePositives = 0;
+
+	void record(bool passedOn, bool found) noexcept
+	{
+	}
+};
+
+
+struct CountedFilterLookups
+{
+	static constexpr bool COUNTED = true;
+	unsigned long long filtered = 0;
+	unsigned long long passed = 0;
+	unsigned long long falsePositives = 0;
+
+	void record(bool passedOn, bool found) noexcept
+	{
+		if(!passedOn)
+			filtered++;
+		else
+		{
+			passed++;
+			if(!found)
+				falsePositives++;
+		}
+	}
+};
+
+
+
+template <typename ElementType, typename Hasher, typename LookupCounting = UncountedFilterLookups>
+class BloomFilterSet : public Set<ElementType>
+{
+public:
+	// The number of filter bits per expected element, and the number of
+	// bits set per element.  Together with the block size, these give a
+	// false positive rate of about 1%.
+	static constexpr unsigned int BITS_PER_ELEMENT = 10;
+	static constexpr unsigned int HASH_COUNT = 6;
+
+	// The number of blocks in the filter if reserve() is never called.
+	static constexpr unsigned int DEFAULT_BLOCK_COUNT = 1024;
+
+public:
+	// Initializes a BloomFilterSet in front of the given set, which should
+	// be empty.  The BloomFilterSet takes ownership of it.  Only a function
+	// object Hasher can be left to default (see HashSet).
+	BloomFilterSet(std::unique_ptr<Set<ElementType>> wrapped, Hasher hashFunction);
+
+	template <typename DefaultHasher = Hasher, typename = std::enable_if_t<impl_::CAN_DEFAULT_HASHER<DefaultHasher>>>
+	explicit BloomFilterSet(std::unique_ptr<Set<ElementType>> wrapped);
+
+	BloomFilterSet(const BloomFilterSet& s) = delete;
+	BloomFilterSet& operator=(const BloomFilterSet& s) = delete;
+
+
+	virtual bool isImplemented() const noexcept override;
+
+
+	// add() adds an element to the filter and to the wrapped set.
+	virtual void add(const ElementType& element) override;
+
+
+	// addAll() adds every element to the filter, then passes all of them
+	// on to the wrapped set at once, so that it can bulk-build if it's
+	// able to.
+	virtual void addAll(const std::vector<ElementType>& elements, bool sorted = false) override;
+
+
+	// buildsInBulk() asks the wrapped set.
+	virtual bool buildsInBulk() const noexcept override;
+
+
+	// contains() returns false if the filter rules the element out, and
+	// otherwise asks the wrapped set.
+	virtual bool contains(const ElementType& element) const override;
+
+
+	virtual std::size_t size() const noexcept override;
+
+
+	// reserve() sizes the filter for expectedSize elements (if nothing has
+	// been added yet) and passes the hint on to the wrapped set.
+	virtual void reserve(std::size_t expectedSize) override;
+
+
+	virtual void freeze() override;
+
+
+	// printStatistics() prints the filter's size and, if LookupCounting
+	// keeps them, how many lookups it answered by itself, followed by the
+	// wrapped set's statistics.
+	virtual void printStatistics(std::ostream& out) const override;
+
+
+	// blockCount() returns the number of 64-byte blocks in the filter.
+	std::size_t blockCount() const noexcept;
+
+
+	// filteredLookups() returns the number of calls to contains() that the
+	// filter answered by itself; passedLookups() returns the number it
+	// passed on to the wrapped set, and falsePositives() the number of
+	// those for which the wrapped set returned false.  All three are zero
+	// unless LookupCounting keeps them.
+	unsigned long long filteredLookups() const noexcept;
+	unsigned long long passedLookups() const noexcept;
+	unsigned long long falsePositives() const noexcept;
+
+
+	// falsePositiveRate() returns the fraction of lookups of elements not
+	// in the set that the filter failed to rule out.
+	double falsePositiveRate() const noexcept;
+
+
+private:
+	struct alignas(64) Block
+	{
+		std::uint64_t words[8];
+	};
+
+	std::unique_ptr<Set<ElementType>> wrapped;
+	Hasher hashFunction;
+	std::size_t blocks;
+	std::unique_ptr<Block[]> filter;
+
+	mutable LookupCounting lookups;
+
+	void allocateFilter(std::size_t count);
+	void addToFilter(const ElementType& element);
+	std::size_t blockIndex(std::uint64_t mixed) const noexcept;
+	static std::uint64_t bitIndexes(std::uint64_t mixed) noexcept;
+};
+
+
+
+template <typename ElementType, typename Hasher, typename LookupCounting>
+BloomFilterSet<ElementType, Hasher, LookupCounting>::BloomFilterSet(std::unique_ptr<Set<ElementType>> wrapped, Hasher hashFunction)
+	: wrapped{std::move(wrapped)}, hashFunction{hashFunction}, blocks{0}
+{
+	allocateFilter(DEFAULT_BLOCK_COUNT);
+}
+
+
+template <typename ElementType, typename Hasher, typename LookupCounting>
+template <typename DefaultHasher, typename>
+BloomFilterSet<ElementType, Hasher, LookupCounting>::BloomFilterSet(std::unique_ptr<Set<ElementType>> wrapped)
+	: BloomFilterSet{std::move(wrapped), Hasher{}}
+{
+}
+
+
+template <typename ElementType, typename Hasher, typename LookupCounting>
+bool BloomFilterSet<ElementType, Hasher, LookupCounting>::isImplemented() const noexcept
+{
+	return wrapped->isImplemented();
+}
+
+
+template <typename ElementType, typename Hasher, typename LookupCounting>
+void BloomFilterSet<ElementType, Hasher, LookupCounting>::add(const ElementType& element)
+{
+	addToFilter(element);
+	wrapped->add(element);
+}
+
+
+template <typename ElementType, typename Hasher, typename LookupCounting>
+void BloomFilterSet<ElementType, Hasher, LookupCounting>::addAll(const std::vector<ElementType>& elements, bool sorted)
+{
+	for(const ElementType& element : elements)
+		addToFilter(element);
+	wrapped->addAll(elements, sorted);
+}
+
+
+template <typename ElementType, typename Hasher, typename LookupCounting>
+bool BloomFilterSet<ElementType, Hasher, LookupCounting>::buildsInBulk() const noexcept
+{
+	return wrapped->buildsInBulk();
+}
+
+
+template <typename ElementType, typename Hasher, typename LookupCounting>
+bool BloomFilterSet<ElementType, Hasher, LookupCounting>::contains(const ElementType& element) const
+{
+	std::uint64_t mixed = mixHash(hashFunction(element));
+	const Block& block = filter[blockIndex(mixed)];
+
+	std::uint64_t bits = bitIndexes(mixed);
+	for(unsigned int i = 0; i < HASH_COUNT; i++, bits >>= 9)
+	{
+		if((block.words[(bits >> 6) & 7] & (std::uint64_t{1} << (bits & 63))) == 0)
+		{
+			lookups.record(false, false);
+			return false;
+		}
+	}
+
+	bool found = wrapped->contains(element);
+	lookups.record(true, found);
+	return found;
+}
+
+
+template <typename ElementType, typename Hasher, typename LookupCounting>
+std::size_t BloomFilterSet<ElementType, Hasher, LookupCounting>::size() const noexcept
+{
+	return wrapped->size();
+}
+
+
+template <typename ElementType, typename Hasher, typename LookupCounting>
+void BloomFilterSet<ElementType, Hasher, LookupCounting>::reserve(std::size_t expectedSize)
+{
+	if(wrapped->size() == 0)
+	{
+		std::size_t count = (expectedSize * BITS_PER_ELEMENT + 511) / 512;
+		allocateFilter(count > 0 ? count : 1);
+	}
+	wrapped->reserve(expectedSize);
+}
+
+
+template <typename ElementType, typename Hasher, typename LookupCounting>
+void BloomFilterSet<ElementType, Hasher, LookupCounting>::freeze()
+{
+	wrapped->freeze();
+}
+
+
+template <typename ElementType, typename Hasher, typename LookupCounting>
+void BloomFilterSet<ElementType, Hasher, LookupCounting>::printStatistics(std::ostream& out) const
+{
+	out << std::left << std::fixed << std::setprecision(2);
+	out << std::setw(24) << "Bloom filter" << blocks << " blocks ("
+		<< blocks * sizeof(Block) / 1024.0 << " KiB, "
+		<< (size() == 0 ? 0.0 : blocks * 512.0 / size()) << " bits/element)" << '\n';
+	if(LookupCounting::COUNTED)
+	{
+		out << std::setw(24) << "Filtered lookups" << filteredLookups() << '\n';
+		out << std::setw(24) << "Passed lookups" << passedLookups() << '\n';
+		out << std::setw(24) << "False positives" << falsePositives()
+			<< " (" << std::setprecision(3) << falsePositiveRate() * 100.0 << "% of misses)" << '\n';
+	}
+	out << std::right;
+
+	wrapped->printStatistics(out);
+}
+
+
+template <typename ElementType, typename Hasher, typename LookupCounting>
+std::size_t BloomFilterSet<ElementType, Hasher, LookupCounting>::blockCount() const noexcept
+{
+	return blocks;
+}
+
+
+template <typename ElementType, typename Hasher, typename LookupCounting>
+unsigned long long BloomFilterSet<ElementType, Hasher, LookupCounting>::filteredLookups() const noexcept
+{
+	return lookups.filtered;
+}
+
+
+template <typename ElementType, typename Hasher, typename LookupCounting>
+unsigned long long BloomFilterSet<ElementType, Hasher, LookupCounting>::passedLookups() const noexcept
+{
+	return lookups.passed;
+}
+
+
+template <typename ElementType, typename Hasher, typename LookupCounting>
+unsigned long long BloomFilterSet<ElementType, Hasher, LookupCounting>::falsePositives() const noexcept
+{
+	return lookups.falsePositives;
+}
+
+
+template <typename ElementType, typename Hasher, typename LookupCounting>
+double BloomFilterSet<ElementType, Hasher, LookupCounting>::falsePositiveRate() const noexcept
+{
+	unsigned long long misses = lookups.filtered + lookups.falsePositives;
+	return misses == 0 ? 0.0 : (double)lookups.falsePositives / misses;
+}
+
+
+template <typename ElementType, typename Hasher, typename LookupCounting>
+void BloomFilterSet<ElementType, Hasher, LookupCounting>::allocateFilter(std::size_t count)
+{
+	filter = std::make_unique<Block[]>(count);
+	blocks = count;
+}
+
+
+template <typename ElementType, typename Hasher, typename LookupCounting>
+void BloomFilterSet<ElementType, Hasher, LookupCounting>::addToFilter(const ElementType& element)
+{
+	std::uint64_t mixed = mixHash(hashFunction(element));
+	Block& block = filter[blockIndex(mixed)];
+
+	//each bit index takes 9 bits (0-511) of bitIndexes()
+	std::uint64_t bits = bitIndexes(mixed);
+	for(unsigned int i = 0; i < HASH_COUNT; i++, bits >>= 9)
+		block.words[(bits >> 6) & 7] |= std::uint64_t{1} << (bits & 63);
+}
+
+
+template <typename ElementType, typename Hasher, typename LookupCounting>
+std::size_t BloomFilterSet<ElementType, Hasher, LookupCounting>::blockIndex(std::uint64_t mixed) const noexcept
+{
+	//the high 32 bits of the mixed hash (which, unlike the Hasher's own
+	//high bits, aren't zero for a 32-bit Hasher), scaled into [0, blocks)
+	//without a division; the product fits in 64 bits for any filter up to
+	//2^32 blocks (256 GiB)
+	return (std::size_t)(((mixed >> 32) * blocks) >> 32);
+}
+
+
+template <typename ElementType, typename Hasher, typename LookupCounting>
+std::uint64_t BloomFilterSet<ElementType, Hasher, LookupCounting>::bitIndexes(std::uint64_t mixed) noexcept
+{
+	//remixing with a different offset gives bits independent of the ones
+	//that picked the block, so elements sharing a block don't also share
+	//their bit indexes
+	return mixHash(mixed + 0x9e3779b97f4a7c15ULL);
+}
+
+
+
+#endif // BLOOMFILTERSET_HPP
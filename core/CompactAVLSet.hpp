@@ -0,0 +1,661 @@
+// CompactAVLSet.hpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+//
+// A CompactAVLSet is an AVL tree, balanced the same way as an AVLSet,
+// whose nodes aren't allocated one at a time.  Instead, they're kept in
+// arrays that grow as elements are added, and they're linked by their
+// 32-bit positions in those arrays rather than by pointers; a node's
+// height, which in a balanced tree is never more than a few dozen, takes
+// a single byte.  An AVLSet's node carries two pointers and an int beside
+// its key, and the allocator adds its own bookkeeping to each one; here,
+// the same information takes 9 bytes, so a node of a string set shrinks
+// from 64 bytes to 48 (or to 41, when the keys are kept apart from the
+// links).  Nodes added together also sit together in memory, and
+// addAll() lays out the tree it builds in preorder, so a search usually
+// steps from a node to its left child in the same cache line or the next.
+//
+// The NodeLayout decides whether each node's key is kept next to its
+// links (InterleavedNodes) or in an array of its own (SplitNodes); the
+// KeyStorage decides what the key is, as it does for AVLSet.
+//
+// Unlike an AVLSet, a CompactAVLSet is always balanced, since the heights
+// of an unbalanced tree wouldn't fit in a byte.  It can hold at most
+// 2^32 - 1 elements.
+
+#ifndef COMPACTAVLSET_HPP
+#define COMPACTAVLSET_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "KeyStorage.hpp"
+#include "OrderedSet.hpp"
+#include "ParallelSort.hpp"
+
+
+
+namespace impl_
+{
+	// NO_NODE stands in for a missing child (or root) in a CompactAVLSet.
+	inline constexpr std::uint32_t NO_NODE = UINT32_MAX;
+}
+
+
+// A NodeLayout policy decides where a CompactAVLSet keeps each node's
+// key, its two links (child(node, false) is the left one, and
+// child(node, true) the right), and its height.  InterleavedNodes keeps
+// them together, in one array, so each step of a search reads one place
+// in memory.  SplitNodes keeps the keys, the links, and the heights in
+// three arrays, so no key is padded out to the alignment of the others
+// and the links of neighboring nodes share cache lines; a search reads
+// two places per step, but rebalancing reads no keys at all.
+//
+// append() adds a node with no children and a height of 1, returning its
+// index.  NODE_BYTES is what each node takes, and bytes() what all of the
+// arrays take, including room not yet used.
+struct InterleavedNodes
+{
+	template <typename Key>
+	class Nodes
+	{
+	private:
+		struct Node
+		{
+			Key key;
+			std::uint32_t children[2];
+			std::uint8_t height;
+		};
+
+	public:
+		static constexpr std::size_t NODE_BYTES = sizeof(Node);
+
+		std::uint32_t append(const Key& key)
+		{
+			nodes.push_back(Node{key, {impl_::NO_NODE, impl_::NO_NODE}, 1});
+			return static_cast<std::uint32_t>(nodes.size() - 1);
+		}
+
+		const Key& key(std::uint32_t node) const noexcept
+		{
+			return nodes[node].key;
+		}
+
+		std::uint32_t& child(std::uint32_t node, bool right) noexcept
+		{
+			return nodes[node].children[right];
+		}
+
+		std::uint32_t child(std::uint32_t node, bool right) const noexcept
+		{
+			return nodes[node].children[right];
+		}
+
+		std::uint8_t& height(std::uint32_t node) noexcept
+		{
+			return nodes[node].height;
+		}
+
+		std::uint8_t height(std::uint32_t node) const noexcept
+		{
+			return nodes[node].height;
+		}
+
+		std::size_t size() const noexcept
+		{
+			return nodes.size();
+		}
+
+		void reserve(std::size_t count)
+		{
+			nodes.reserve(count);
+		}
+
+		void shrinkToFit()
+		{
+			nodes.shrink_to_fit();
+		}
+
+		std::size_t bytes() const noexcept
+		{
+			return nodes.capacity() * sizeof(Node);
+		}
+
+	private:
+		std::vector<Node> nodes;
+	};
+};
+
+
+struct SplitNodes
+{
+	template <typename Key>
+	class Nodes
+	{
+	private:
+		struct Links
+		{
+			std::uint32_t children[2];
+		};
+
+	public:
+		static constexpr std::size_t NODE_BYTES = sizeof(Key) + sizeof(Links) + sizeof(std::uint8_t);
+
+		std::uint32_t append(const Key& key)
+		{
+			keys.push_back(key);
+			links.push_back(Links{{impl_::NO_NODE, impl_::NO_NODE}});
+			heights.push_back(1);
+			return static_cast<std::uint32_t>(keys.size() - 1);
+		}
+
+		const Key& key(std::uint32_t node) const noexcept
+		{
+			return keys[node];
+		}
+
+		std::uint32_t& child(std::uint32_t node, bool right) noexcept
+		{
+			return links[node].children[right];
+		}
+
+		std::uint32_t child(std::uint32_t node, bool right) const noexcept
+		{
+			return links[node].children[right];
+		}
+
+		std::uint8_t& height(std::uint32_t node) noexcept
+		{
+			return heights[node];
+		}
+
+		std::uint8_t height(std::uint32_t node) const noexcept
+		{
+			return heights[node];
+		}
+
+		std::size_t size() const noexcept
+		{
+			return keys.size();
+		}
+
+		void reserve(std::size_t count)
+		{
+			keys.reserve(count);
+			links.reserve(count);
+			heights.reserve(count);
+		}
+
+		void shrinkToFit()
+		{
+			keys.shrink_to_fit();
+			links.shrink_to_fit();
+			heights.shrink_to_fit();
+		}
+
+		std::size_t bytes() const noexcept
+		{
+			return keys.capacity() * sizeof(Key) + links.capacity() * sizeof(Links) + heights.capacity();
+		}
+
+	private:
+		std::vector<Key> keys;
+		std::vector<Links> links;
+		std::vector<std::uint8_t> heights;
+	};
+};
+
+
+
+template <typename ElementType, typename KeyStorage = DirectKeys, typename NodeLayout = InterleavedNodes>
+class CompactAVLSet : public OrderedSet<ElementType>
+{
+public:
+	// A WhileFunction is a visit function that returns false to stop the
+	// visiting (see OrderedSet).
+	using WhileFunction = typename OrderedSet<ElementType>::WhileFunction;
+
+public:
+	// Initializes a CompactAVLSet to be empty.
+	CompactAVLSet();
+
+	// The arrays clean themselves up, and are copied as they are, since
+	// their indexes mean the same thing in any copy.
+	virtual ~CompactAVLSet() noexcept = default;
+	CompactAVLSet(const CompactAVLSet& s) = default;
+	CompactAVLSet& operator=(const CompactAVLSet& s) = default;
+
+	// Initializes a new CompactAVLSet whose contents are moved from an
+	// expiring one, which is left empty.
+	CompactAVLSet(CompactAVLSet&& s) noexcept;
+
+	// Assigns an expiring CompactAVLSet into another, leaving it with the
+	// other's old contents.
+	CompactAVLSet& operator=(CompactAVLSet&& s) noexcept;
+
+
+	virtual bool isImplemented() const noexcept override;
+
+
+	// add() adds an element to the set.  If the element is already in the
+	// set, this function has no effect.  This function runs in O(log n)
+	// time when there are n elements in the set, besides the occasional
+	// growth of the arrays.  It throws a std::length_error if the set
+	// already has as many elements as it can hold.
+	virtual void add(const ElementType& element) override;
+
+
+	// addAll() adds every element in the vector.  If the set is empty, it
+	// builds a perfectly balanced tree from the elements in order, in
+	// linear time (sorting a copy of them first if they aren't known to be
+	// sorted), with its nodes in preorder; otherwise, it calls add() for
+	// each one.
+	virtual void addAll(const std::vector<ElementType>& elements, bool sorted = false) override;
+
+
+	// buildsInBulk() returns true while the set is empty, since addAll()
+	// then builds the tree directly.
+	virtual bool buildsInBulk() const noexcept override;
+
+
+	// contains() returns true if the given element is already in the set,
+	// false otherwise.  This function runs in O(log n) time when there
+	// are n elements in the set.
+	virtual bool contains(const ElementType& element) const override;
+
+
+	// size() returns the number of elements in the set.
+	virtual std::size_t size() const noexcept override;
+
+
+	// reserve() makes room in the arrays for the given number of nodes.
+	virtual void reserve(std::size_t expectedSize) override;
+
+
+	// freeze() gives back the room in the arrays (and in the KeyStorage)
+	// that hasn't been used.
+	virtual void freeze() override;
+
+
+	// printStatistics() writes the height of the tree, the size of its
+	// nodes, and how many bytes the arrays take per element.
+	virtual void printStatistics(std::ostream& out) const override;
+
+
+	// visitFrom() calls the given "visit" function for each element that
+	// is not less than low, in ascending order, until it returns false.
+	// This runs in O(log n + k) time when k elements are visited.
+	virtual std::size_t visitFrom(const ElementType& low, WhileFunction visit) const override;
+
+
+	// inorder() calls the given "visit" function for each of the elements
+	// in the set, in ascending order.
+	template <typename Visit>
+	void inorder(Visit visit) const;
+
+
+	// height() returns the height of the AVL tree.  As in AVLSet, the
+	// height of an empty tree is -1.
+	int height() const noexcept;
+
+
+	// nodeBytes() returns the number of bytes the node arrays take,
+	// including room set aside for nodes not yet added.
+	std::size_t nodeBytes() const noexcept;
+
+
+private:
+	using Key = StoredKey<KeyStorage, ElementType>;
+
+	// An AVL tree of height h has at least fib(h + 2) - 1 nodes, so one
+	// with fewer than 2^32 nodes is less than 46 tall, and the paths that
+	// add() and the traversals walk fit in arrays of this size.
+	static constexpr unsigned int MAX_HEIGHT = 48;
+
+	static constexpr bool LEFT = false;
+	static constexpr bool RIGHT = true;
+
+	typename NodeLayout::template Nodes<Key> nodes;
+	typename KeyStorage::template Store<ElementType> keys;
+	std::uint32_t root;
+
+	int heightOf(std::uint32_t node) const noexcept;
+	int leanOf(std::uint32_t node) const noexcept;
+	void updateHeight(std::uint32_t node) noexcept;
+	std::uint32_t leftRotate(std::uint32_t node) noexcept;
+	std::uint32_t rightRotate(std::uint32_t node) noexcept;
+	std::uint32_t buildBalanced(const ElementType* first, std::size_t count);
+
+	template <typename Visit>
+	std::size_t walk(std::uint32_t* pending, unsigned int depth, Visit& visit) const;
+};
+
+
+
+template <typename ElementType, typename KeyStorage, typename NodeLayout>
+CompactAVLSet<ElementType, KeyStorage, NodeLayout>::CompactAVLSet()
+	: root{impl_::NO_NODE}
+{
+}
+
+
+template <typename ElementType, typename KeyStorage, typename NodeLayout>
+CompactAVLSet<ElementType, KeyStorage, NodeLayout>::CompactAVLSet(CompactAVLSet&& s) noexcept
+	: nodes{std::move(s.nodes)}, keys{std::move(s.keys)}, root{s.root}
+{
+	//the arrays are taken, so the root the expiring set had no longer
+	//leads anywhere
+	s.root = impl_::NO_NODE;
+}
+
+
+template <typename ElementType, typename KeyStorage, typename NodeLayout>
+CompactAVLSet<ElementType, KeyStorage, NodeLayout>& CompactAVLSet<ElementType, KeyStorage, NodeLayout>::operator=(CompactAVLSet&& s) noexcept
+{
+	std::swap(nodes, s.nodes);
+	std::swap(keys, s.keys);
+	std::swap(root, s.root);
+	return *this;
+}
+
+
+template <typename ElementType, typename KeyStorage, typename NodeLayout>
+bool CompactAVLSet<ElementType, KeyStorage, NodeLayout>::isImplemented() const noexcept
+{
+	return true;
+}
+
+
+template <typename ElementType, typename KeyStorage, typename NodeLayout>
+void CompactAVLSet<ElementType, KeyStorage, NodeLayout>::add(const ElementType& element)
+{
+	//walk down, remembering each node passed and which way the walk went
+	//from it, with one comparison per node
+	std::uint32_t path[MAX_HEIGHT];
+	bool sides[MAX_HEIGHT];
+	unsigned int depth = 0;
+	for(std::uint32_t node = root; node != impl_::NO_NODE; depth++)
+	{
+		int order = keys.compare(element, nodes.key(node));
+		if(order == 0)
+			return;
+		path[depth] = node;
+		sides[depth] = order > 0;
+		node = nodes.child(node, sides[depth]);
+	}
+
+	if(nodes.size() == impl_::NO_NODE)
+		throw std::length_error{"CompactAVLSet can't hold any more elements"};
+
+	//the arrays may move when the node is appended, so the links are only
+	//reached through their indexes from here on
+	std::uint32_t added = nodes.append(keys.keep(element));
+	if(depth == 0)
+	{
+		root = added;
+		return;
+	}
+	nodes.child(path[depth - 1], sides[depth - 1]) = added;
+
+	//walk back up, as AVLSet's insertNode() does; one rotation (single or
+	//double) restores the height the subtree had before the insertion
+	while(depth > 0)
+	{
+		std::uint32_t node = path[--depth];
+		int oldHeight = nodes.height(node);
+		updateHeight(node);
+
+		std::uint32_t subtree;
+		int lean = leanOf(node);
+		if(lean > 1)
+		{
+			if(leanOf(nodes.child(node, LEFT)) < 0)
+				nodes.child(node, LEFT) = leftRotate(nodes.child(node, LEFT));
+			subtree = rightRotate(node);
+		}
+		else if(lean < -1)
+		{
+			if(leanOf(nodes.child(node, RIGHT)) > 0)
+				nodes.child(node, RIGHT) = rightRotate(nodes.child(node, RIGHT));
+			subtree = leftRotate(node);
+		}
+		else if(nodes.height(node) == oldHeight)
+			return;
+		else
+			continue;
+
+		if(depth == 0)
+			root = subtree;
+		else
+			nodes.child(path[depth - 1], sides[depth - 1]) = subtree;
+		return;
+	}
+}
+
+
+template <typename ElementType, typename KeyStorage, typename NodeLayout>
+void CompactAVLSet<ElementType, KeyStorage, NodeLayout>::addAll(const std::vector<ElementType>& elements, bool sorted)
+{
+	if(nodes.size() != 0)
+	{
+		for(const ElementType& element : elements)
+			add(element);
+		return;
+	}
+
+	if(elements.size() >= impl_::NO_NODE)
+		throw std::length_error{"CompactAVLSet can't hold that many elements"};
+
+	if(sorted && std::adjacent_find(elements.begin(), elements.end()) == elements.end())
+	{
+		nodes.reserve(elements.size());
+		root = buildBalanced(elements.data(), elements.size());
+		return;
+	}
+
+	std::vector<ElementType> ordered{elements};
+	if(!sorted)
+		parallelSort(ordered);
+	ordered.erase(std::unique(ordered.begin(), ordered.end()), ordered.end());
+	nodes.reserve(ordered.size());
+	root = buildBalanced(ordered.data(), ordered.size());
+}
+
+
+template <typename ElementType, typename KeyStorage, typename NodeLayout>
+bool CompactAVLSet<ElementType, KeyStorage, NodeLayout>::buildsInBulk() const noexcept
+{
+	return nodes.size() == 0;
+}
+
+
+template <typename ElementType, typename KeyStorage, typename NodeLayout>
+bool CompactAVLSet<ElementType, KeyStorage, NodeLayout>::contains(const ElementType& element) const
+{
+	for(std::uint32_t node = root; node != impl_::NO_NODE;)
+	{
+		int order = keys.compare(element, nodes.key(node));
+		if(order == 0)
+			return true;
+		node = (order < 0 ? nodes.child(node, LEFT) : nodes.child(node, RIGHT));
+	}
+	return false;
+}
+
+
+template <typename ElementType, typename KeyStorage, typename NodeLayout>
+std::size_t CompactAVLSet<ElementType, KeyStorage, NodeLayout>::size() const noexcept
+{
+	return nodes.size();
+}
+
+
+template <typename ElementType, typename KeyStorage, typename NodeLayout>
+void CompactAVLSet<ElementType, KeyStorage, NodeLayout>::reserve(std::size_t expectedSize)
+{
+	nodes.reserve(expectedSize);
+}
+
+
+template <typename ElementType, typename KeyStorage, typename NodeLayout>
+void CompactAVLSet<ElementType, KeyStorage, NodeLayout>::freeze()
+{
+	keys.shrinkToFit();
+	nodes.shrinkToFit();
+}
+
+
+template <typename ElementType, typename KeyStorage, typename NodeLayout>
+void CompactAVLSet<ElementType, KeyStorage, NodeLayout>::printStatistics(std::ostream& out) const
+{
+	out << "Compact AVL tree: height " << height() << ", "
+		<< size() << " nodes of " << nodes.NODE_BYTES << " bytes" << std::endl;
+
+	if(size() != 0)
+		out << "Node arrays take " << static_cast<double>(nodeBytes()) / size() << " bytes per element" << std::endl;
+}
+
+
+template <typename ElementType, typename KeyStorage, typename NodeLayout>
+std::size_t CompactAVLSet<ElementType, KeyStorage, NodeLayout>::visitFrom(const ElementType& low, WhileFunction visit) const
+{
+	//only the nodes not less than low are pushed, since those less than
+	//it (and their left subtrees) are never visited
+	std::uint32_t pending[MAX_HEIGHT];
+	unsigned int depth = 0;
+	for(std::uint32_t node = root; node != impl_::NO_NODE;)
+	{
+		if(keys.compare(low, nodes.key(node)) > 0)
+			node = nodes.child(node, RIGHT);
+		else
+		{
+			pending[depth++] = node;
+			node = nodes.child(node, LEFT);
+		}
+	}
+	return walk(pending, depth, visit);
+}
+
+
+template <typename ElementType, typename KeyStorage, typename NodeLayout>
+template <typename Visit>
+void CompactAVLSet<ElementType, KeyStorage, NodeLayout>::inorder(Visit visit) const
+{
+	std::uint32_t pending[MAX_HEIGHT];
+	unsigned int depth = 0;
+	for(std::uint32_t node = root; node != impl_::NO_NODE; node = nodes.child(node, LEFT))
+		pending[depth++] = node;
+
+	auto visitAll = [&](const ElementType& element) { visit(element); return true; };
+	walk(pending, depth, visitAll);
+}
+
+
+template <typename ElementType, typename KeyStorage, typename NodeLayout>
+int CompactAVLSet<ElementType, KeyStorage, NodeLayout>::height() const noexcept
+{
+	return heightOf(root) - 1;
+}
+
+
+template <typename ElementType, typename KeyStorage, typename NodeLayout>
+std::size_t CompactAVLSet<ElementType, KeyStorage, NodeLayout>::nodeBytes() const noexcept
+{
+	return nodes.bytes();
+}
+
+
+template <typename ElementType, typename KeyStorage, typename NodeLayout>
+int CompactAVLSet<ElementType, KeyStorage, NodeLayout>::heightOf(std::uint32_t node) const noexcept
+{
+	if(node == impl_::NO_NODE) return 0;
+	return nodes.height(node);
+}
+
+
+template <typename ElementType, typename KeyStorage, typename NodeLayout>
+int CompactAVLSet<ElementType, KeyStorage, NodeLayout>::leanOf(std::uint32_t node) const noexcept
+{
+	return heightOf(nodes.child(node, LEFT)) - heightOf(nodes.child(node, RIGHT));
+}
+
+
+template <typename ElementType, typename KeyStorage, typename NodeLayout>
+void CompactAVLSet<ElementType, KeyStorage, NodeLayout>::updateHeight(std::uint32_t node) noexcept
+{
+	nodes.height(node) = static_cast<std::uint8_t>(
+		1 + std::max(heightOf(nodes.child(node, LEFT)), heightOf(nodes.child(node, RIGHT))));
+}
+
+
+template <typename ElementType, typename KeyStorage, typename NodeLayout>
+std::uint32_t CompactAVLSet<ElementType, KeyStorage, NodeLayout>::leftRotate(std::uint32_t node) noexcept
+{
+	std::uint32_t mainRight = nodes.child(node, RIGHT);
+	nodes.child(node, RIGHT) = nodes.child(mainRight, LEFT);
+	nodes.child(mainRight, LEFT) = node;
+	updateHeight(node);
+	updateHeight(mainRight);
+	return mainRight;
+}
+
+
+template <typename ElementType, typename KeyStorage, typename NodeLayout>
+std::uint32_t CompactAVLSet<ElementType, KeyStorage, NodeLayout>::rightRotate(std::uint32_t node) noexcept
+{
+	std::uint32_t mainLeft = nodes.child(node, LEFT);
+	nodes.child(node, LEFT) = nodes.child(mainLeft, RIGHT);
+	nodes.child(mainLeft, RIGHT) = node;
+	updateHeight(node);
+	updateHeight(mainLeft);
+	return mainLeft;
+}
+
+
+template <typename ElementType, typename KeyStorage, typename NodeLayout>
+std::uint32_t CompactAVLSet<ElementType, KeyStorage, NodeLayout>::buildBalanced(const ElementType* first, std::size_t count)
+{
+	//as in AVLSet, the middle element is the root and the halves on either
+	//side are its subtrees; the root is appended before either of them, and
+	//the left before the right, which puts the nodes in preorder
+	if(count == 0) return impl_::NO_NODE;
+	std::size_t middle = count / 2;
+	std::uint32_t node = nodes.append(keys.keep(first[middle]));
+	std::uint32_t left = buildBalanced(first, middle);
+	std::uint32_t right = buildBalanced(first + middle + 1, count - middle - 1);
+	nodes.child(node, LEFT) = left;
+	nodes.child(node, RIGHT) = right;
+	updateHeight(node);
+	return node;
+}
+
+
+template <typename ElementType, typename KeyStorage, typename NodeLayout>
+template <typename Visit>
+std::size_t CompactAVLSet<ElementType, KeyStorage, NodeLayout>::walk(std::uint32_t* pending, unsigned int depth, Visit& visit) const
+{
+	//pending holds the nodes still to be visited, nearest on top, each of
+	//whose left subtrees has already been walked; after each node comes
+	//the leftmost of its right subtree
+	std::size_t visited = 0;
+	while(depth > 0)
+	{
+		std::uint32_t node = pending[--depth];
+		visited++;
+		if(!visit(keys.element(nodes.key(node))))
+			return visited;
+		for(node = nodes.child(node, RIGHT); node != impl_::NO_NODE; node = nodes.child(node, LEFT))
+			pending[depth++] = node;
+	}
+	return visited;
+}
+
+
+
+#endif // COMPACTAVLSET_HPP
@@ -0,0 +1,307 @@
+// ConcurrentHashSet.hpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+//
+// A ConcurrentHashSet is a separately-chained hash table that can be
+// shared by many threads at once: any number of threads may call
+// contains() while others call add().
+//
+// Readers take no locks.  A node is never modified once it has been
+// linked into a chain (new nodes are pushed onto the front), so a reader
+// can walk a chain while a writer is adding to it.  contains() is
+// wait-free: it pins the set's EpochReclaimer, loads the current array,
+// and walks one chain.
+//
+// Writers lock one of STRIPE_COUNT mutexes, chosen by the element's hash,
+// so adds to different parts of the table proceed in parallel.  Because
+// the capacity is a power of two no smaller than STRIPE_COUNT, every
+// chain belongs to exactly one stripe.  When the load factor exceeds 0.8,
+// the writer that noticed takes every stripe, builds a doubled array out
+// of fresh copies of the nodes, and publishes it with a single atomic
+// store; readers still walking the old array are unaffected.  The old
+// array and its nodes are then retired to the EpochReclaimer, which
+// deletes them once no reader can still be looking at them.
+//
+// ConcurrentHashSets can't be copied or moved, since there is no way to
+// do so safely while other threads are using them.
+
+#ifndef CONCURRENTHASHSET_HPP
+#define CONCURRENTHASHSET_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <type_traits>
+#include "EpochReclaimer.hpp"
+#include "HashMixing.hpp"
+#include "HasherTraits.hpp"
+#include "Set.hpp"
+
+
+
+template <typename ElementType, typename Hasher = std::function<unsigned int(const ElementType&)>>
+class ConcurrentHashSet : public Set<ElementType>
+{
+public:
+	// The number of locks shared among writers.  Must be a power of two.
+	static constexpr unsigned int STRIPE_COUNT = 64;
+
+	// The number of chains in a ConcurrentHashSet before anything has been
+	// added to it.  Must be a power of two no smaller than STRIPE_COUNT.
+	static constexpr unsigned int DEFAULT_CAPACITY = 1024;
+
+	using HashFunction = std::function<unsigned int(const ElementType&)>;
+
+public:
+	explicit ConcurrentHashSet(Hasher hashFunction);
+
+	// Only a function object Hasher can be left to default (see HashSet).
+	template <typename DefaultHasher = Hasher, typename = std::enable_if_t<impl_::CAN_DEFAULT_HASHER<DefaultHasher>>>
+	ConcurrentHashSet();
+
+	virtual ~ConcurrentHashSet() noexcept;
+
+	ConcurrentHashSet(const ConcurrentHashSet& s) = delete;
+	ConcurrentHashSet& operator=(const ConcurrentHashSet& s) = delete;
+
+
+	virtual bool isImplemented() const noexcept override;
+
+
+	// add() adds an element to the set, if it isn't already there.  It
+	// locks only the element's stripe, unless it has to resize the array.
+	virtual void add(const ElementType& element) override;
+
+
+	// contains() returns true if the given element is in the set, false
+	// otherwise.  It never blocks, even while the array is being resized.
+	virtual bool contains(const ElementType& element) const override;
+
+
+	// size() returns the number of elements in the set.
+	virtual std::size_t size() const noexcept override;
+
+
+	// reserve() grows the array, if necessary, so that expectedSize
+	// elements can be added without any further resizing.
+	virtual void reserve(std::size_t expectedSize) override;
+
+
+	// capacity() returns the number of chains in the current array.
+	std::size_t capacity() const;
+
+
+private:
+	struct Node
+	{
+		ElementType value;
+		std::size_t hash;
+		Node* next;
+	};
+
+	struct Table
+	{
+		std::size_t capacity;
+		std::atomic<Node*>* chains;
+	};
+
+	struct alignas(64) Stripe
+	{
+		std::mutex mutex;
+	};
+
+	Hasher hashFunction;
+	std::atomic<Table*> table;
+	std::atomic<std::size_t> setsize;
+	Stripe stripes[STRIPE_COUNT];
+	mutable EpochReclaimer reclaimer;
+
+	std::size_t hashOf(const ElementType& element) const;
+	static Table* newTable(std::size_t capacity);
+	static void deleteTable(Table* t) noexcept;
+	void resize(std::size_t newCapacity);
+};
+
+
+
+template <typename ElementType, typename Hasher>
+ConcurrentHashSet<ElementType, Hasher>::ConcurrentHashSet(Hasher hashFunction)
+	: hashFunction{hashFunction}, table{newTable(DEFAULT_CAPACITY)}, setsize{0}
+{
+}
+
+
+template <typename ElementType, typename Hasher>
+template <typename DefaultHasher, typename>
+ConcurrentHashSet<ElementType, Hasher>::ConcurrentHashSet()
+	: ConcurrentHashSet{Hasher{}}
+{
+}
+
+
+template <typename ElementType, typename Hasher>
+ConcurrentHashSet<ElementType, Hasher>::~ConcurrentHashSet() noexcept
+{
+	deleteTable(table.load());
+}
+
+
+template <typename ElementType, typename Hasher>
+bool ConcurrentHashSet<ElementType, Hasher>::isImplemented() const noexcept
+{
+	return true;
+}
+
+
+template <typename ElementType, typename Hasher>
+void ConcurrentHashSet<ElementType, Hasher>::add(const ElementType& element)
+{
+	std::size_t hash = hashOf(element);
+	std::size_t oldcapacity;
+	std::size_t newsize;
+
+	{
+		std::lock_guard<std::mutex> lock{stripes[hash & (STRIPE_COUNT - 1)].mutex};
+
+		//resizing takes every stripe, so the array can't change while we
+		//hold one of them
+		Table* t = table.load(std::memory_order_acquire);
+		oldcapacity = t->capacity;
+		std::atomic<Node*>& chain = t->chains[hash & (t->capacity - 1)];
+		Node* head = chain.load(std::memory_order_relaxed);
+
+		for(Node* n = head; n != nullptr; n = n->next)
+		{
+			if(n->hash == hash && n->value == element)
+				return;
+		}
+
+		chain.store(new Node{element, hash, head}, std::memory_order_release);
+		newsize = setsize.fetch_add(1) + 1;
+	}
+
+	//once the lock is released, t may be retired by another writer's
+	//resize, so only its capacity is used from here on
+	if(newsize > oldcapacity / 5 * 4)
+		resize(oldcapacity * 2);
+}
+
+
+template <typename ElementType, typename Hasher>
+bool ConcurrentHashSet<ElementType, Hasher>::contains(const ElementType& element) const
+{
+	std::size_t hash = hashOf(element);
+	EpochReclaimer::Guard guard = reclaimer.pin();
+
+	Table* t = table.load();
+	Node* n = t->chains[hash & (t->capacity - 1)].load(std::memory_order_acquire);
+
+	for(; n != nullptr; n = n->next)
+	{
+		if(n->hash == hash && n->value == element)
+			return true;
+	}
+	return false;
+}
+
+
+template <typename ElementType, typename Hasher>
+std::size_t ConcurrentHashSet<ElementType, Hasher>::size() const noexcept
+{
+	return setsize.load();
+}
+
+
+template <typename ElementType, typename Hasher>
+void ConcurrentHashSet<ElementType, Hasher>::reserve(std::size_t expectedSize)
+{
+	std::size_t newCapacity = capacity();
+	while(newCapacity / 5 * 4 < expectedSize)
+		newCapacity *= 2;
+	resize(newCapacity);
+}
+
+
+template <typename ElementType, typename Hasher>
+std::size_t ConcurrentHashSet<ElementType, Hasher>::capacity() const
+{
+	EpochReclaimer::Guard guard = reclaimer.pin();
+	return table.load()->capacity;
+}
+
+
+template <typename ElementType, typename Hasher>
+std::size_t ConcurrentHashSet<ElementType, Hasher>::hashOf(const ElementType& element) const
+{
+	//the low bits pick both the stripe and the chain, so they need mixing
+	return mixHash(hashFunction(element));
+}
+
+
+template <typename ElementType, typename Hasher>
+typename ConcurrentHashSet<ElementType, Hasher>::Table* ConcurrentHashSet<ElementType, Hasher>::newTable(std::size_t capacity)
+{
+	std::atomic<Node*>* chains = new std::atomic<Node*>[capacity];
+	for(std::size_t i = 0; i < capacity; i++)
+		chains[i].store(nullptr, std::memory_order_relaxed);
+	return new Table{capacity, chains};
+}
+
+
+template <typename ElementType, typename Hasher>
+void ConcurrentHashSet<ElementType, Hasher>::deleteTable(Table* t) noexcept
+{
+	for(std::size_t i = 0; i < t->capacity; i++)
+	{
+		Node* n = t->chains[i].load(std::memory_order_relaxed);
+		while(n != nullptr)
+		{
+			Node* next = n->next;
+			delete n;
+			n = next;
+		}
+	}
+	delete[] t->chains;
+	delete t;
+}
+
+
+template <typename ElementType, typename Hasher>
+void ConcurrentHashSet<ElementType, Hasher>::resize(std::size_t newCapacity)
+{
+	for(Stripe& stripe : stripes)
+		stripe.mutex.lock();
+
+	Table* old = table.load();
+
+	//another writer may have resized while we waited for the locks
+	if(newCapacity > old->capacity)
+	{
+		Table* t = newTable(newCapacity);
+
+		//readers may be walking the old chains, so their nodes can't be
+		//relinked; the new array gets copies instead
+		for(std::size_t i = 0; i < old->capacity; i++)
+		{
+			for(Node* n = old->chains[i].load(std::memory_order_relaxed); n != nullptr; n = n->next)
+			{
+				std::atomic<Node*>& chain = t->chains[n->hash & (newCapacity - 1)];
+				chain.store(
+					new Node{n->value, n->hash, chain.load(std::memory_order_relaxed)},
+					std::memory_order_relaxed);
+			}
+		}
+
+		table.store(t);
+		reclaimer.retire([old]() { deleteTable(old); });
+	}
+
+	for(Stripe& stripe : stripes)
+		stripe.mutex.unlock();
+}
+
+
+
+#endif // CONCURRENTHASHSET_HPP
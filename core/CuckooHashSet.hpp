@@ -0,0 +1,371 @@
+// CuckooHashSet.hpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+//
+// A CuckooHashSet is an implementation of a Set whose lookups have a
+// bounded worst case, however unevenly the elements hash.  Every element
+// lives in one of exactly two buckets, and each bucket has SLOTS_PER_BUCKET
+// slots, so contains() examines at most two buckets (plus a small stash,
+// described below) and never walks a chain.
+//
+// The elements themselves are kept in a separate array, in the order they
+// were added.  A slot holds a 32-bit tag taken from the element's hash,
+// along with the element's index in that array.  A bucket is 32 bytes and
+// aligned to 32, so it never straddles a cache line: a lookup reads at
+// most two cache lines of buckets, and compares an element only when its
+// tag matches.
+//
+// The two buckets are found in the style of "partial-key" cuckoo hashing:
+// the first comes from the low bits of the hash, and the second is the
+// first XORed with a hash of the tag.  Either can be computed from the
+// other and the tag alone, so elements can be moved without hashing them
+// again.  When both of a new element's buckets are full, it takes a slot
+// anyway, and the element it evicted moves to its own other bucket, and
+// so on, for up to MAX_KICKS moves.  An element still homeless after that
+// goes into the stash, which holds up to STASH_SIZE elements and is
+// searched on every lookup while it's nonempty.  When the stash is full,
+// or the buckets are more than MAX_LOAD full, the bucket array doubles
+// and every element is placed again.
+//
+// The bound assumes the hash function tells the elements apart.  If it
+// doesn't (say, it returns zero for everything), no number of buckets
+// will hold them; once doubling MAX_EXTRA_DOUBLINGS more times than the
+// load requires still leaves elements homeless, the stash is allowed to
+// grow without limit, and lookups degrade to a linear search of it.  The
+// limit is only lifted for that resize: the next one tries again to
+// place every element with the stash held to STASH_SIZE.
+//
+// Slots hold 32-bit indexes to keep a bucket within 32 bytes, so a
+// CuckooHashSet holds at most 2^32 - 1 elements; add() and reserve()
+// throw a std::length_error rather than go past that.  Sets larger than
+// that belong in a HashSet or SwissHashSet.
+
+#ifndef CUCKOOHASHSET_HPP
+#define CUCKOOHASHSET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "HashMixing.hpp"
+#include "HasherTraits.hpp"
+#include "Set.hpp"
+
+
+
+template <typename ElementType, typename Hasher = std::function<unsigned int(const ElementType&)>>
+class CuckooHashSet : public Set<ElementType>
+{
+public:
+	static constexpr unsigned int SLOTS_PER_BUCKET = 4;
+
+	// The number of buckets in a CuckooHashSet before anything has been
+	// added to it.  The bucket count is always a power of two.
+	static constexpr unsigned int DEFAULT_BUCKET_COUNT = 16;
+
+	// The largest number of evictions one add() will make before giving
+	// up and putting an element in the stash.
+	static constexpr unsigned int MAX_KICKS = 256;
+
+	static constexpr unsigned int STASH_SIZE = 8;
+
+	// The number of times a resize will double the buckets beyond the
+	// size it was asked for, trying to place every element, before it
+	// concludes that the hash function is to blame.
+	static constexpr unsigned int MAX_EXTRA_DOUBLINGS = 2;
+
+	// The fraction of slots that can be full before the buckets double.
+	static constexpr double MAX_LOAD = 0.9;
+
+	using HashFunction = std::function<unsigned int(const ElementType&)>;
+
+public:
+	explicit CuckooHashSet(Hasher hashFunction);
+
+	// Only a function object Hasher can be left to default (see HashSet).
+	template <typename DefaultHasher = Hasher, typename = std::enable_if_t<impl_::CAN_DEFAULT_HASHER<DefaultHasher>>>
+	CuckooHashSet();
+
+
+	virtual bool isImplemented() const noexcept override;
+
+
+	// add() adds an element to the set.  If the element is already in the
+	// set, this function has no effect.  It runs in amortized constant time.
+	// It throws a std::length_error if the set already holds as many
+	// elements as it can.
+	virtual void add(const ElementType& element) override;
+
+
+	// contains() returns true if the given element is already in the set,
+	// false otherwise.  It examines at most 2 * SLOTS_PER_BUCKET slots and
+	// STASH_SIZE stashed elements, unless the hash function fails to tell
+	// the elements apart (see above), in which case the whole stash is
+	// searched.
+	virtual bool contains(const ElementType& element) const override;
+
+
+	virtual std::size_t size() const noexcept override;
+
+
+	// reserve() grows the bucket array, if necessary, so that expectedSize
+	// elements fit without exceeding MAX_LOAD.  It throws a
+	// std::length_error if that's more elements than the set can hold.
+	virtual void reserve(std::size_t expectedSize) override;
+
+
+	// bucketCount() returns the number of buckets; stashSize() returns the
+	// number of elements currently in the stash.
+	std::size_t bucketCount() const noexcept;
+	std::size_t stashSize() const noexcept;
+
+
+private:
+	static constexpr std::uint32_t EMPTY = 0xFFFFFFFF;
+
+	//every index is below EMPTY, so that's how many elements fit
+	static constexpr std::size_t MAX_ELEMENTS = EMPTY;
+
+	struct alignas(32) Bucket
+	{
+		std::uint32_t tags[SLOTS_PER_BUCKET];
+		std::uint32_t indexes[SLOTS_PER_BUCKET];
+	};
+
+	Hasher hashFunction;
+	std::vector<ElementType> elements;
+	std::vector<Bucket> buckets;
+	std::vector<std::uint32_t> stash;
+	std::uint32_t bucketmask;
+	std::uint32_t kickcursor;
+	std::size_t stashlimit;
+
+	std::uint64_t hashOf(const ElementType& element) const;
+	std::uint32_t alternateBucket(std::uint32_t bucket, std::uint32_t tag) const noexcept;
+	bool findInBucket(const ElementType& element, std::uint32_t bucket, std::uint32_t tag) const;
+	bool placeInBucket(std::uint32_t bucket, std::uint32_t tag, std::uint32_t index) noexcept;
+	bool place(std::uint32_t index);
+	void resize(std::size_t newBucketCount);
+};
+
+
+
+template <typename ElementType, typename Hasher>
+CuckooHashSet<ElementType, Hasher>::CuckooHashSet(Hasher hashFunction)
+	: hashFunction{hashFunction}, kickcursor{0}, stashlimit{STASH_SIZE}
+{
+	resize(DEFAULT_BUCKET_COUNT);
+}
+
+
+template <typename ElementType, typename Hasher>
+template <typename DefaultHasher, typename>
+CuckooHashSet<ElementType, Hasher>::CuckooHashSet()
+	: CuckooHashSet{Hasher{}}
+{
+}
+
+
+template <typename ElementType, typename Hasher>
+bool CuckooHashSet<ElementType, Hasher>::isImplemented() const noexcept
+{
+	return true;
+}
+
+
+template <typename ElementType, typename Hasher>
+void CuckooHashSet<ElementType, Hasher>::add(const ElementType& element)
+{
+	if(contains(element))
+		return;
+
+	if(elements.size() >= MAX_ELEMENTS)
+		throw std::length_error{"CuckooHashSet can't hold that many elements"};
+
+	if(elements.size() + 1 > buckets.size() * SLOTS_PER_BUCKET * MAX_LOAD)
+		resize(buckets.size() * 2);
+
+	elements.push_back(element);
+
+	//a failed placement leaves some element (not necessarily this one)
+	//homeless; resizing places every element again, including that one
+	if(!place(elements.size() - 1))
+		resize(buckets.size() * 2);
+}
+
+
+template <typename ElementType, typename Hasher>
+bool CuckooHashSet<ElementType, Hasher>::contains(const ElementType& element) const
+{
+	std::uint64_t hash = hashOf(element);
+	std::uint32_t tag = static_cast<std::uint32_t>(hash >> 32);
+	std::uint32_t first = static_cast<std::uint32_t>(hash) & bucketmask;
+
+	if(findInBucket(element, first, tag) || findInBucket(element, alternateBucket(first, tag), tag))
+		return true;
+
+	for(std::uint32_t index : stash)
+	{
+		if(elements[index] == element)
+			return true;
+	}
+	return false;
+}
+
+
+template <typename ElementType, typename Hasher>
+std::size_t CuckooHashSet<ElementType, Hasher>::size() const noexcept
+{
+	return elements.size();
+}
+
+
+template <typename ElementType, typename Hasher>
+void CuckooHashSet<ElementType, Hasher>::reserve(std::size_t expectedSize)
+{
+	if(expectedSize > MAX_ELEMENTS)
+		throw std::length_error{"CuckooHashSet can't hold that many elements"};
+
+	std::size_t newBucketCount = buckets.size();
+	while(newBucketCount * SLOTS_PER_BUCKET * MAX_LOAD < expectedSize)
+		newBucketCount *= 2;
+	if(newBucketCount > buckets.size())
+		resize(newBucketCount);
+	elements.reserve(expectedSize);
+}
+
+
+template <typename ElementType, typename Hasher>
+std::size_t CuckooHashSet<ElementType, Hasher>::bucketCount() const noexcept
+{
+	return buckets.size();
+}
+
+
+template <typename ElementType, typename Hasher>
+std::size_t CuckooHashSet<ElementType, Hasher>::stashSize() const noexcept
+{
+	return stash.size();
+}
+
+
+template <typename ElementType, typename Hasher>
+std::uint64_t CuckooHashSet<ElementType, Hasher>::hashOf(const ElementType& element) const
+{
+	//the low bits pick the bucket and the high bits are the tag, so both
+	//need to depend on the whole hash
+	return mixHash(hashFunction(element));
+}
+
+
+template <typename ElementType, typename Hasher>
+std::uint32_t CuckooHashSet<ElementType, Hasher>::alternateBucket(std::uint32_t bucket, std::uint32_t tag) const noexcept
+{
+	//XOR is its own inverse, so this maps each of an element's buckets to
+	//the other; the | 1 keeps the two from being the same bucket
+	return (bucket ^ (static_cast<std::uint32_t>(mixHash(tag)) | 1)) & bucketmask;
+}
+
+
+template <typename ElementType, typename Hasher>
+bool CuckooHashSet<ElementType, Hasher>::findInBucket(const ElementType& element, std::uint32_t bucket, std::uint32_t tag) const
+{
+	const Bucket& b = buckets[bucket];
+	for(unsigned int slot = 0; slot < SLOTS_PER_BUCKET; slot++)
+	{
+		if(b.tags[slot] == tag && b.indexes[slot] != EMPTY && elements[b.indexes[slot]] == element)
+			return true;
+	}
+	return false;
+}
+
+
+template <typename ElementType, typename Hasher>
+bool CuckooHashSet<ElementType, Hasher>::placeInBucket(std::uint32_t bucket, std::uint32_t tag, std::uint32_t index) noexcept
+{
+	Bucket& b = buckets[bucket];
+	for(unsigned int slot = 0; slot < SLOTS_PER_BUCKET; slot++)
+	{
+		if(b.indexes[slot] == EMPTY)
+		{
+			b.tags[slot] = tag;
+			b.indexes[slot] = index;
+			return true;
+		}
+	}
+	return false;
+}
+
+
+template <typename ElementType, typename Hasher>
+bool CuckooHashSet<ElementType, Hasher>::place(std::uint32_t index)
+{
+	std::uint64_t hash = hashOf(elements[index]);
+	std::uint32_t tag = static_cast<std::uint32_t>(hash >> 32);
+	std::uint32_t bucket = static_cast<std::uint32_t>(hash) & bucketmask;
+
+	if(placeInBucket(bucket, tag, index) || placeInBucket(alternateBucket(bucket, tag), tag, index))
+		return true;
+
+	//evict someone from a full bucket, and carry the evicted element on
+	//to its other bucket; the slot chosen rotates so the walk doesn't
+	//just bounce one element back and forth
+	for(unsigned int kick = 0; kick < MAX_KICKS; kick++)
+	{
+		Bucket& b = buckets[bucket];
+		unsigned int slot = kickcursor++ % SLOTS_PER_BUCKET;
+		std::swap(tag, b.tags[slot]);
+		std::swap(index, b.indexes[slot]);
+
+		bucket = alternateBucket(bucket, tag);
+		if(placeInBucket(bucket, tag, index))
+			return true;
+	}
+
+	if(stash.size() < stashlimit)
+	{
+		stash.push_back(index);
+		return true;
+	}
+	return false;
+}
+
+
+template <typename ElementType, typename Hasher>
+void CuckooHashSet<ElementType, Hasher>::resize(std::size_t newBucketCount)
+{
+	Bucket empty;
+	for(unsigned int slot = 0; slot < SLOTS_PER_BUCKET; slot++)
+	{
+		empty.tags[slot] = 0;
+		empty.indexes[slot] = EMPTY;
+	}
+
+	//keep doubling until every element fits; with a good hash function,
+	//the first attempt almost always succeeds.  The stash is only allowed
+	//to grow without limit on the last attempt, and is held to STASH_SIZE
+	//again by the next resize.
+	for(unsigned int attempt = 0; ; attempt++, newBucketCount *= 2)
+	{
+		stashlimit = (attempt < MAX_EXTRA_DOUBLINGS ? STASH_SIZE : std::numeric_limits<std::size_t>::max());
+
+		buckets.assign(newBucketCount, empty);
+		bucketmask = newBucketCount - 1;
+		stash.clear();
+
+		bool placed = true;
+		for(std::uint32_t index = 0; index < elements.size() && placed; index++)
+			placed = place(index);
+		if(placed)
+			return;
+	}
+}
+
+
+
+#endif // CUCKOOHASHSET_HPP
@@ -22,18 +22,217 @@
 
 #ifndef HASHSET_HPP
 #define HASHSET_HPP
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
 #include <iostream>
 #include <functional>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "HashMixing.hpp"
+#include "HasherTraits.hpp"
+#include "KeyStorage.hpp"
+#include "NodeAllocator.hpp"
 #include "Set.hpp"
 
+// Each node remembers the full hash of its value.  Lookups compare hashes
+// before comparing values, so most nodes in a chain are rejected without
+// touching the value at all, and rehash() can move a node to its new
+// index without calling the hash function again.
 template<typename ElementType>
 struct HashNode
 {
 	ElementType value;
+	std::size_t hash;
 	HashNode* next;
 };
 
-template <typename ElementType>
+
+// An Indexing policy decides how a hash becomes an index into the array,
+// and how large the array is to begin with (it always doubles when it
+// grows).  ModuloIndexing is the original scheme: any capacity, with the
+// hash taken modulo the capacity, which costs an integer division on
+// every lookup.  MaskedIndexing keeps the capacity a power of two, mixes
+// the hash with mixHash() so that weak hashes still spread out, and then
+// masks off the low bits instead of dividing.  capacityFor() returns the
+// smallest capacity the policy allows that is at least the given one.
+struct ModuloIndexing
+{
+	static constexpr unsigned int INITIAL_CAPACITY = 10000;
+
+	static std::size_t capacityFor(std::size_t minimum) noexcept
+	{
+		return minimum;
+	}
+
+	static std::size_t index(std::size_t hash, std::size_t capacity) noexcept
+	{
+		return hash % capacity;
+	}
+};
+
+
+struct MaskedIndexing
+{
+	static constexpr unsigned int INITIAL_CAPACITY = 16384;
+
+	static std::size_t capacityFor(std::size_t minimum) noexcept
+	{
+		std::size_t capacity = 1;
+		while(capacity < minimum)
+			capacity *= 2;
+		return capacity;
+	}
+
+	static std::size_t index(std::size_t hash, std::size_t capacity) noexcept
+	{
+		return static_cast<std::size_t>(mixHash(hash)) & (capacity - 1);
+	}
+};
+
+
+// A HashSetResize says what a HashSet does when it outgrows its array.
+// Immediate resizing moves every node into the new array during the add()
+// that crossed the threshold.  Incremental resizing allocates the new
+// array at that point, then moves a few of the old array's chains each
+// time add() or contains() is called; until they are all moved, both
+// arrays are searched.  Incremental resizing bounds the cost of any one
+// add(), at the price of a little work on lookups while a resize is in
+// progress.
+enum class HashSetResize
+{
+	Immediate,
+	Incremental
+};
+
+
+// A LookupCounting policy decides whether contains() counts its lookups,
+// and the probes they take, for statistics().  UncountedLookups is the
+// default: it keeps no counters, so contains() stores nothing and can be
+// called from several threads at once (unless an incremental resize is in
+// progress).  CountedLookups keeps them, at the price of a few stores on
+// every lookup, for when the counts are what's being measured.
+struct UncountedLookups
+{
+	static constexpr bool COUNTED = false;
+	static constexpr unsigned long long hits = 0;
+	static constexpr unsigned long long hitProbes = 0;
+	static constexpr unsigned long long misses = 0;
+	static constexpr unsigned long long missProbes = 0;
+
+	void record(bool found, unsigned int probes) noexcept
+	{
+	}
+};
+
+
+struct CountedLookups
+{
+	static constexpr bool COUNTED = true;
+	unsigned long long hits = 0;
+	unsigned long long hitProbes = 0;
+	unsigned long long misses = 0;
+	unsigned long long missProbes = 0;
+
+	void record(bool found, unsigned int probes) noexcept
+	{
+		if(found)
+		{
+			hits++;
+			hitProbes += probes;
+		}
+		else
+		{
+			misses++;
+			missProbes += probes;
+		}
+	}
+};
+
+
+// HashSetStatistics is a snapshot of how well a HashSet's hash function is
+// spreading its elements out.  chainLengths[k] is the number of chains
+// holding exactly k elements.  A probe is one node compared during a call
+// to contains(); only contains() is counted, not add(), and only when the
+// HashSet counts its lookups (see CountedLookups).  Resizes include
+// those caused by reserve(), and their time includes any incremental
+// migration that followed.
+struct HashSetStatistics
+{
+	std::size_t size;
+	std::size_t capacity;
+	double loadFactor;
+	std::vector<std::size_t> chainLengths;
+	unsigned int longestChain;
+	bool lookupsCounted;
+	unsigned long long successfulLookups;
+	unsigned long long successfulProbes;
+	unsigned long long failedLookups;
+	unsigned long long failedProbes;
+	unsigned int resizeCount;
+	double resizeMicroseconds;
+
+	double averageProbesPerSuccess() const noexcept
+	{
+		return successfulLookups == 0 ? 0.0 : (double)successfulProbes / successfulLookups;
+	}
+
+	double averageProbesPerFailure() const noexcept
+	{
+		return failedLookups == 0 ? 0.0 : (double)failedProbes / failedLookups;
+	}
+
+	// print() writes the statistics as a small table, with chain lengths
+	// of 8 and above grouped into power-of-two ranges.  The lookup counts
+	// are left out if they weren't kept.
+	void print(std::ostream& out) const;
+};
+
+
+inline void HashSetStatistics::print(std::ostream& out) const
+{
+	out << std::left << std::fixed << std::setprecision(2);
+	out << std::setw(24) << "Size" << size << '\n';
+	out << std::setw(24) << "Capacity" << capacity << '\n';
+	out << std::setw(24) << "Load factor" << loadFactor << '\n';
+	out << std::setw(24) << "Longest chain" << longestChain << '\n';
+	out << "Chain lengths" << '\n';
+
+	for(unsigned int low = 0; low < chainLengths.size(); low = (low < 8 ? low + 1 : low * 2))
+	{
+		unsigned int high = (low < 8 ? low : std::min<std::size_t>(low * 2, chainLengths.size()) - 1);
+		unsigned long long chains = 0;
+		for(unsigned int length = low; length <= high; length++)
+			chains += chainLengths[length];
+		if(chains == 0)
+			continue;
+
+		std::string label = (low == high ? std::to_string(low) : std::to_string(low) + "-" + std::to_string(high));
+		out << "    " << std::setw(20) << label << chains << '\n';
+	}
+
+	if(lookupsCounted)
+	{
+		out << std::setw(24) << "Successful lookups" << successfulLookups
+			<< " (" << averageProbesPerSuccess() << " probes each)" << '\n';
+		out << std::setw(24) << "Failed lookups" << failedLookups
+			<< " (" << averageProbesPerFailure() << " probes each)" << '\n';
+	}
+	out << std::setw(24) << "Resizes" << resizeCount
+		<< " (" << std::setprecision(0) << resizeMicroseconds << "usec)" << '\n';
+	out << std::right;
+}
+
+
+template <
+	typename ElementType,
+	typename Hasher = std::function<unsigned int(const ElementType&)>,
+	typename NodeAllocator = HeapNodeAllocator,
+	typename Indexing = ModuloIndexing,
+	typename KeyStorage = DirectKeys,
+	typename LookupCounting = UncountedLookups>
 class HashSet : public Set<ElementType>
 {
 public:
@@ -41,14 +240,29 @@ public:
 	// added to it.
 	static constexpr unsigned int DEFAULT_CAPACITY = 10;
 
+	// The number of old chains moved by each add() or contains() during
+	// an incremental resize.  Since the array doubles, anything above
+	// 1 / 0.8 guarantees that a resize finishes before the next begins.
+	static constexpr unsigned int MIGRATION_STEP = 4;
+
 	// A HashFunction is a function that takes a reference to a const
-	// ElementType and returns an unsigned int.
+	// ElementType and returns an unsigned int.  This is the default
+	// Hasher; it can hold any function, at the cost of an indirect call
+	// every time an element is hashed.
 	using HashFunction = std::function<unsigned int(const ElementType&)>;
 
 public:
 	// Initializes a HashSet to be empty, so that it will use the given
-	// hash function whenever it needs to hash an element.
-	explicit HashSet(HashFunction hashFunction);
+	// hasher whenever it needs to hash an element.  When Hasher is a
+	// function object type (e.g., ProductHash), its call is resolved at
+	// compile time and can be inlined into add() and contains().
+	explicit HashSet(Hasher hashFunction, HashSetResize resize = HashSetResize::Immediate);
+
+	// Initializes a HashSet to be empty, hashing with a default-constructed
+	// Hasher.  Only a function object type can be left to default this
+	// way; the default Hasher has to be given a function to call.
+	template <typename DefaultHasher = Hasher, typename = std::enable_if_t<impl_::CAN_DEFAULT_HASHER<DefaultHasher>>>
+	explicit HashSet(HashSetResize resize = HashSetResize::Immediate);
 
 	// Cleans up the HashSet so that it leaks no memory.
 	virtual ~HashSet() noexcept;
@@ -89,47 +303,93 @@ public:
 
 
 	// size() returns the number of elements in the set.
-	virtual unsigned int size() const noexcept override;
+	virtual std::size_t size() const noexcept override;
+
+
+	// reserve() grows the array, if necessary, so that expectedSize
+	// elements can be added without exceeding the 0.8 load factor and
+	// triggering any further resizing.
+	virtual void reserve(std::size_t expectedSize) override;
 
 
 	// elementsAtIndex() returns the number of elements that hashed to a
 	// particular index in the array.  If the index is out of the boundaries
-	// of the array, this function returns 0.
-	unsigned int elementsAtIndex(unsigned int index) const;
+	// of the array, this function returns 0.  (If an incremental resize is
+	// in progress, this and isElementAtIndex() finish it first, so that
+	// they always describe the current array.)
+	unsigned int elementsAtIndex(std::size_t index) const;
 
 
 	// isElementAtIndex() returns true if the given element hashed to a
 	// particular index in the array, false otherwise.  If the index is
 	// out of the boundaries of the array, this functions returns 0.
-	bool isElementAtIndex(const ElementType& element, unsigned int index) const;
+	bool isElementAtIndex(const ElementType& element, std::size_t index) const;
+
+
+	// statistics() walks the array to measure its chains, and reports the
+	// resize counters kept since the HashSet was created, along with the
+	// lookup counters if LookupCounting keeps them.  (It finishes any
+	// incremental resize in progress first.)
+	HashSetStatistics statistics() const;
+
+
+	// freeze() gives back whatever room the KeyStorage has set aside for
+	// elements that haven't been added.
+	virtual void freeze() override;
+
+
+	// printStatistics() prints statistics() to the given stream.
+	virtual void printStatistics(std::ostream& out) const override;
 
 
 private:
-	HashFunction hashFunction;
-	unsigned int setsize;
-	unsigned int capacity;
+	Hasher hashFunction;
+	std::size_t setsize;
+	std::size_t capacity;
 	double DEFAULT_LOADFACTOR = 0.8;
-	HashNode<ElementType>** nodearray;
-
-	HashNode<ElementType>* newNode(const ElementType& val, HashNode<ElementType>* next);
-	HashNode<ElementType>* copyNode(HashNode<ElementType>* head);
-	void deleteNode(HashNode<ElementType>* head);
-	unsigned int generateIndex(const ElementType& val);
+	HashNode<StoredKey<KeyStorage, ElementType>>** nodearray;
+	typename NodeAllocator::template Pool<HashNode<StoredKey<KeyStorage, ElementType>>> nodes;
+	typename KeyStorage::template Store<ElementType> keys;
+
+	//incremental resize state; oldarray is nullptr unless a resize is in
+	//progress, in which case chains below oldmigrated have been moved
+	HashSetResize resizemode;
+	mutable HashNode<StoredKey<KeyStorage, ElementType>>** oldarray;
+	mutable std::size_t oldcapacity;
+	mutable std::size_t oldmigrated;
+
+	//statistics counters; the lookup counts are updated by contains(), but
+	//don't affect the contents of the set
+	mutable LookupCounting lookups;
+	unsigned int resizecount = 0;
+	mutable double resizetime = 0.0;
+
+	HashNode<StoredKey<KeyStorage, ElementType>>* newNode(const StoredKey<KeyStorage, ElementType>& key, std::size_t hash, HashNode<StoredKey<KeyStorage, ElementType>>* next);
+	HashNode<StoredKey<KeyStorage, ElementType>>* copyNode(HashNode<StoredKey<KeyStorage, ElementType>>* head);
+	void deleteNode(HashNode<StoredKey<KeyStorage, ElementType>>* head);
+	std::size_t generateIndex(std::size_t hash) const;
+	bool findInChain(const ElementType& val, std::size_t hash, HashNode<StoredKey<KeyStorage, ElementType>>* head) const;
+	bool findInChain(const ElementType& val, std::size_t hash, HashNode<StoredKey<KeyStorage, ElementType>>* head, unsigned int& probes) const;
 	void insertNode(const ElementType& val);
 	void rehash();
-	HashNode<ElementType>** copyArray(HashNode<ElementType>** other, unsigned int arraysize);
-	void deleteArray(HashNode<ElementType>**& other, unsigned int arraysize);
+	void beginResize(std::size_t newCapacity);
+	void migrateChains(std::size_t count) const;
+	void finishResize() const;
+	void relinkChain(HashNode<StoredKey<KeyStorage, ElementType>>* head) const;
+	HashNode<StoredKey<KeyStorage, ElementType>>** copyArray(HashNode<StoredKey<KeyStorage, ElementType>>** other, std::size_t arraysize);
+	void deleteArray(HashNode<StoredKey<KeyStorage, ElementType>>**& other, std::size_t arraysize);
+	void deleteArrays();
 
 	void print()
 	{
 		std::cout << "\nloadfactor: " << (double)setsize / capacity << '\n';
-		for(int i = 0; i < capacity; i++)
+		for(std::size_t i = 0; i < capacity; i++)
 		{
 			std::cout << '[' << i << ']';
-			HashNode<ElementType>* head = nodearray[i];
+			HashNode<StoredKey<KeyStorage, ElementType>>* head = nodearray[i];
 			while(head != nullptr)
 			{
-				std::cout << head->value << ' ';
+				std::cout << keys.element(head->value) << ' ';
 				head = head->next; 
 			}
 			std::cout << '\n';
@@ -139,111 +399,146 @@ private:
 
 
 
-namespace impl_
+template <typename ElementType, typename Hasher, typename NodeAllocator, typename Indexing, typename KeyStorage, typename LookupCounting>
+HashSet<ElementType, Hasher, NodeAllocator, Indexing, KeyStorage, LookupCounting>::HashSet(Hasher hashFunction, HashSetResize resize)
+	: hashFunction{hashFunction}, setsize{0}, capacity{Indexing::INITIAL_CAPACITY},
+	  resizemode{resize}, oldarray{nullptr}, oldcapacity{0}, oldmigrated{0}
 {
-	template <typename ElementType>
-	unsigned int HashSet__undefinedHashFunction(const ElementType& element)
-	{
-		return 0;
-	}
+	nodearray = NodeAllocator::template allocateArray<HashNode<StoredKey<KeyStorage, ElementType>>*>(capacity);
+	for(std::size_t i = 0; i < capacity; i++)
+		nodearray[i] = nullptr;
 }
 
 
-template <typename ElementType>
-HashSet<ElementType>::HashSet(HashFunction hashFunction)
-	: hashFunction{hashFunction}, setsize{0}, capacity{10000}
+template <typename ElementType, typename Hasher, typename NodeAllocator, typename Indexing, typename KeyStorage, typename LookupCounting>
+template <typename DefaultHasher, typename>
+HashSet<ElementType, Hasher, NodeAllocator, Indexing, KeyStorage, LookupCounting>::HashSet(HashSetResize resize)
+	: HashSet{Hasher{}, resize}
 {
-	nodearray = new HashNode<ElementType>*[capacity];
-	for(int i = 0; i < capacity; i++)
-		nodearray[i] = nullptr;
 }
 
 
-template <typename ElementType>
-HashSet<ElementType>::~HashSet() noexcept
+template <typename ElementType, typename Hasher, typename NodeAllocator, typename Indexing, typename KeyStorage, typename LookupCounting>
+HashSet<ElementType, Hasher, NodeAllocator, Indexing, KeyStorage, LookupCounting>::~HashSet() noexcept
 {
-	deleteArray(nodearray, capacity);
+	deleteArrays();
 }
 
 
-template <typename ElementType>
-HashSet<ElementType>::HashSet(const HashSet& s)
-	: hashFunction{impl_::HashSet__undefinedHashFunction<ElementType>}
+template <typename ElementType, typename Hasher, typename NodeAllocator, typename Indexing, typename KeyStorage, typename LookupCounting>
+HashSet<ElementType, Hasher, NodeAllocator, Indexing, KeyStorage, LookupCounting>::HashSet(const HashSet& s)
+	: hashFunction{s.hashFunction}, keys{s.keys}, resizemode{s.resizemode}, oldarray{nullptr}, oldcapacity{0}, oldmigrated{0}
 {
+	s.finishResize();
 	setsize = s.setsize;
 	capacity = s.capacity;
 	nodearray = copyArray(s.nodearray, s.capacity);
 }
 
 
-template <typename ElementType>
-HashSet<ElementType>::HashSet(HashSet&& s) noexcept
-	: hashFunction{impl_::HashSet__undefinedHashFunction<ElementType>}
+template <typename ElementType, typename Hasher, typename NodeAllocator, typename Indexing, typename KeyStorage, typename LookupCounting>
+HashSet<ElementType, Hasher, NodeAllocator, Indexing, KeyStorage, LookupCounting>::HashSet(HashSet&& s) noexcept
+	: hashFunction{s.hashFunction}, keys{s.keys}, resizemode{s.resizemode}, oldarray{nullptr}, oldcapacity{0}, oldmigrated{0}
 {
+	s.finishResize();
 	setsize = s.setsize;
 	capacity = s.capacity;
 	nodearray = copyArray(s.nodearray, s.capacity);
 }
 
 
-template <typename ElementType>
-HashSet<ElementType>& HashSet<ElementType>::operator=(const HashSet& s)
+template <typename ElementType, typename Hasher, typename NodeAllocator, typename Indexing, typename KeyStorage, typename LookupCounting>
+HashSet<ElementType, Hasher, NodeAllocator, Indexing, KeyStorage, LookupCounting>& HashSet<ElementType, Hasher, NodeAllocator, Indexing, KeyStorage, LookupCounting>::operator=(const HashSet& s)
 {
-	deleteArray(nodearray, capacity);
+	if(this == &s) return *this;
+	deleteArrays();
+	s.finishResize();
 	setsize = s.setsize;
 	capacity = s.capacity;
 	hashFunction = s.hashFunction;
+	keys = s.keys;
+	resizemode = s.resizemode;
 	nodearray = copyArray(s.nodearray, s.capacity);
 	return *this;
 }
 
 
-template <typename ElementType>
-HashSet<ElementType>& HashSet<ElementType>::operator=(HashSet&& s) noexcept
+template <typename ElementType, typename Hasher, typename NodeAllocator, typename Indexing, typename KeyStorage, typename LookupCounting>
+HashSet<ElementType, Hasher, NodeAllocator, Indexing, KeyStorage, LookupCounting>& HashSet<ElementType, Hasher, NodeAllocator, Indexing, KeyStorage, LookupCounting>::operator=(HashSet&& s) noexcept
 {
-	deleteArray(nodearray, capacity);
+	if(this == &s) return *this;
+	deleteArrays();
+	s.finishResize();
 	setsize = s.setsize;
 	capacity = s.capacity;
 	hashFunction = s.hashFunction;
+	keys = s.keys;
+	resizemode = s.resizemode;
 	nodearray = copyArray(s.nodearray, s.capacity);
 	return *this;
 }
 
 
-template <typename ElementType>
-bool HashSet<ElementType>::isImplemented() const noexcept
+template <typename ElementType, typename Hasher, typename NodeAllocator, typename Indexing, typename KeyStorage, typename LookupCounting>
+bool HashSet<ElementType, Hasher, NodeAllocator, Indexing, KeyStorage, LookupCounting>::isImplemented() const noexcept
 {
 	return true;
 }
 
 
-template <typename ElementType>
-void HashSet<ElementType>::add(const ElementType& element)
+template <typename ElementType, typename Hasher, typename NodeAllocator, typename Indexing, typename KeyStorage, typename LookupCounting>
+void HashSet<ElementType, Hasher, NodeAllocator, Indexing, KeyStorage, LookupCounting>::add(const ElementType& element)
 {
 	insertNode(element);
 }
 
 
-template <typename ElementType>
-bool HashSet<ElementType>::contains(const ElementType& element) const
+template <typename ElementType, typename Hasher, typename NodeAllocator, typename Indexing, typename KeyStorage, typename LookupCounting>
+bool HashSet<ElementType, Hasher, NodeAllocator, Indexing, KeyStorage, LookupCounting>::contains(const ElementType& element) const
 {
-	unsigned int hash_index = hashFunction(element) % capacity;
-	return isElementAtIndex(element, hash_index);
+	std::size_t hash = hashFunction(element);
+	unsigned int probes = 0;
+	bool found = false;
+	if(oldarray != nullptr)
+	{
+		migrateChains(MIGRATION_STEP);
+		if(oldarray != nullptr)
+			found = findInChain(element, hash, oldarray[Indexing::index(hash, oldcapacity)], probes);
+	}
+	if(!found)
+		found = findInChain(element, hash, nodearray[generateIndex(hash)], probes);
+	lookups.record(found, probes);
+	return found;
 }
 
 
-template <typename ElementType>
-unsigned int HashSet<ElementType>::size() const noexcept
+template <typename ElementType, typename Hasher, typename NodeAllocator, typename Indexing, typename KeyStorage, typename LookupCounting>
+std::size_t HashSet<ElementType, Hasher, NodeAllocator, Indexing, KeyStorage, LookupCounting>::size() const noexcept
 {
 	return setsize;
 }
 
 
-template <typename ElementType>
-unsigned int HashSet<ElementType>::elementsAtIndex(unsigned int index) const
+template <typename ElementType, typename Hasher, typename NodeAllocator, typename Indexing, typename KeyStorage, typename LookupCounting>
+void HashSet<ElementType, Hasher, NodeAllocator, Indexing, KeyStorage, LookupCounting>::reserve(std::size_t expectedSize)
 {
+	std::size_t newCapacity = Indexing::capacityFor(
+		static_cast<std::size_t>(expectedSize / DEFAULT_LOADFACTOR) + 1);
+	if(newCapacity <= capacity)
+		return;
+	finishResize();
+	beginResize(newCapacity);
+	finishResize();
+}
+
+
+template <typename ElementType, typename Hasher, typename NodeAllocator, typename Indexing, typename KeyStorage, typename LookupCounting>
+unsigned int HashSet<ElementType, Hasher, NodeAllocator, Indexing, KeyStorage, LookupCounting>::elementsAtIndex(std::size_t index) const
+{
+	if(index >= capacity) return 0;
+	finishResize();
 	unsigned int node_num = 0;
-	HashNode<ElementType>* head = nodearray[index];
+	HashNode<StoredKey<KeyStorage, ElementType>>* head = nodearray[index];
 	while (head != nullptr)
 	{
 		node_num++;
@@ -253,117 +548,234 @@ unsigned int HashSet<ElementType>::elementsAtIndex(unsigned int index) const
 }
 
 
-template <typename ElementType>
-bool HashSet<ElementType>::isElementAtIndex(const ElementType& element, unsigned int index) const
+template <typename ElementType, typename Hasher, typename NodeAllocator, typename Indexing, typename KeyStorage, typename LookupCounting>
+bool HashSet<ElementType, Hasher, NodeAllocator, Indexing, KeyStorage, LookupCounting>::isElementAtIndex(const ElementType& element, std::size_t index) const
 {
 	if(index >= capacity) return false;
-	HashNode<ElementType>* head = nodearray[index];
+	finishResize();
+	return findInChain(element, hashFunction(element), nodearray[index]);
+}
+
+
+template <typename ElementType, typename Hasher, typename NodeAllocator, typename Indexing, typename KeyStorage, typename LookupCounting>
+HashSetStatistics HashSet<ElementType, Hasher, NodeAllocator, Indexing, KeyStorage, LookupCounting>::statistics() const
+{
+	finishResize();
+	HashSetStatistics stats{
+		setsize, capacity, (double)setsize / capacity, {}, 0, LookupCounting::COUNTED,
+		lookups.hits, lookups.hitProbes, lookups.misses, lookups.missProbes, resizecount, resizetime};
+
+	for(std::size_t i = 0; i < capacity; i++)
+	{
+		unsigned int length = 0;
+		for(HashNode<StoredKey<KeyStorage, ElementType>>* head = nodearray[i]; head != nullptr; head = head->next)
+			length++;
+		if(length >= stats.chainLengths.size())
+			stats.chainLengths.resize(length + 1, 0);
+		stats.chainLengths[length]++;
+		if(length > stats.longestChain)
+			stats.longestChain = length;
+	}
+	return stats;
+}
+
+
+template <typename ElementType, typename Hasher, typename NodeAllocator, typename Indexing, typename KeyStorage, typename LookupCounting>
+void HashSet<ElementType, Hasher, NodeAllocator, Indexing, KeyStorage, LookupCounting>::freeze()
+{
+	keys.shrinkToFit();
+}
+
+
+template <typename ElementType, typename Hasher, typename NodeAllocator, typename Indexing, typename KeyStorage, typename LookupCounting>
+void HashSet<ElementType, Hasher, NodeAllocator, Indexing, KeyStorage, LookupCounting>::printStatistics(std::ostream& out) const
+{
+	statistics().print(out);
+}
+template <typename ElementType, typename Hasher, typename NodeAllocator, typename Indexing, typename KeyStorage, typename LookupCounting>
+HashNode<StoredKey<KeyStorage, ElementType>>* HashSet<ElementType, Hasher, NodeAllocator, Indexing, KeyStorage, LookupCounting>::newNode(const StoredKey<KeyStorage, ElementType>& key, std::size_t hash, HashNode<StoredKey<KeyStorage, ElementType>>* next)
+{
+	return nodes.create(key, hash, next);
+}
+
+template <typename ElementType, typename Hasher, typename NodeAllocator, typename Indexing, typename KeyStorage, typename LookupCounting>
+void HashSet<ElementType, Hasher, NodeAllocator, Indexing, KeyStorage, LookupCounting>::deleteNode(HashNode<StoredKey<KeyStorage, ElementType>>* head)
+{
 	while(head != nullptr)
 	{
-		if(head->value == element) return true;
-		head = head->next;
+		HashNode<StoredKey<KeyStorage, ElementType>>* next = head->next;
+		nodes.destroy(head);
+		head = next;
 	}
-	return false;
 }
-template <typename ElementType>
-HashNode<ElementType>* HashSet<ElementType>::newNode(const ElementType& val, HashNode<ElementType>* next)
+
+template <typename ElementType, typename Hasher, typename NodeAllocator, typename Indexing, typename KeyStorage, typename LookupCounting>
+std::size_t HashSet<ElementType, Hasher, NodeAllocator, Indexing, KeyStorage, LookupCounting>::generateIndex(std::size_t hash) const
+{
+	return Indexing::index(hash, capacity);
+}
+
+template <typename ElementType, typename Hasher, typename NodeAllocator, typename Indexing, typename KeyStorage, typename LookupCounting>
+bool HashSet<ElementType, Hasher, NodeAllocator, Indexing, KeyStorage, LookupCounting>::findInChain(const ElementType& val, std::size_t hash, HashNode<StoredKey<KeyStorage, ElementType>>* head) const
 {
-	HashNode<ElementType>* head = new HashNode<ElementType>;
-	head->value = val;
-	head->next = next;
-	return head;
+	unsigned int probes = 0;
+	return findInChain(val, hash, head, probes);
 }
 
-template <typename ElementType>
-void HashSet<ElementType>::deleteNode(HashNode<ElementType>* head)
+template <typename ElementType, typename Hasher, typename NodeAllocator, typename Indexing, typename KeyStorage, typename LookupCounting>
+bool HashSet<ElementType, Hasher, NodeAllocator, Indexing, KeyStorage, LookupCounting>::findInChain(const ElementType& val, std::size_t hash, HashNode<StoredKey<KeyStorage, ElementType>>* head, unsigned int& probes) const
 {
-	if(head != nullptr)
+	while(head != nullptr)
 	{
-		deleteNode(head->next);
-		delete head;
+		probes++;
+		if(head->hash == hash && keys.equals(head->value, val)) return true;
+		head = head->next;
 	}
-	return;
+	return false;
 }
 
-template <typename ElementType>
-unsigned int HashSet<ElementType>::generateIndex(const ElementType& val)
+template <typename ElementType, typename Hasher, typename NodeAllocator, typename Indexing, typename KeyStorage, typename LookupCounting>
+void HashSet<ElementType, Hasher, NodeAllocator, Indexing, KeyStorage, LookupCounting>::rehash()
 {
-	return hashFunction(val) % capacity;
+	//relink the existing nodes into the larger array by their stored hash;
+	//no node is allocated and no element is hashed again
+	beginResize(2 * capacity);
+	finishResize();
 }
 
-template <typename ElementType>
-void HashSet<ElementType>::rehash()
+template <typename ElementType, typename Hasher, typename NodeAllocator, typename Indexing, typename KeyStorage, typename LookupCounting>
+void HashSet<ElementType, Hasher, NodeAllocator, Indexing, KeyStorage, LookupCounting>::beginResize(std::size_t newCapacity)
 {
-	HashNode<ElementType>** old_array = nodearray;
-	int old_capacity = capacity;
-	nodearray = new HashNode<ElementType>*[capacity * 2];
-	setsize = 0;
-	capacity = 2 * capacity;
-	for(int i = 0; i < capacity; i++)
+	auto start = std::chrono::steady_clock::now();
+	resizecount++;
+	oldarray = nodearray;
+	oldcapacity = capacity;
+	oldmigrated = 0;
+	capacity = newCapacity;
+	nodearray = NodeAllocator::template allocateArray<HashNode<StoredKey<KeyStorage, ElementType>>*>(capacity);
+	for(std::size_t i = 0; i < capacity; i++)
 		nodearray[i] = nullptr;
-	for(int i = 0; i < old_capacity; i++)
+	resizetime += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+template <typename ElementType, typename Hasher, typename NodeAllocator, typename Indexing, typename KeyStorage, typename LookupCounting>
+void HashSet<ElementType, Hasher, NodeAllocator, Indexing, KeyStorage, LookupCounting>::migrateChains(std::size_t count) const
+{
+	if(oldarray == nullptr)
+		return;
+	auto start = std::chrono::steady_clock::now();
+	while(oldarray != nullptr && count > 0)
 	{
-		HashNode<ElementType>* head = old_array[i];
-		while(head != nullptr)
+		relinkChain(oldarray[oldmigrated]);
+		oldarray[oldmigrated] = nullptr;
+		oldmigrated++;
+		count--;
+		if(oldmigrated == oldcapacity)
 		{
-			insertNode(head->value);
-			head = head->next;
+			NodeAllocator::releaseArray(oldarray, oldcapacity);
+			oldarray = nullptr;
 		}
 	}
-	deleteArray(old_array, old_capacity);
+	resizetime += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+template <typename ElementType, typename Hasher, typename NodeAllocator, typename Indexing, typename KeyStorage, typename LookupCounting>
+void HashSet<ElementType, Hasher, NodeAllocator, Indexing, KeyStorage, LookupCounting>::finishResize() const
+{
+	if(oldarray != nullptr)
+		migrateChains(oldcapacity - oldmigrated);
 }
 
-template <typename ElementType>
-void HashSet<ElementType>::insertNode(const ElementType& val)
+template <typename ElementType, typename Hasher, typename NodeAllocator, typename Indexing, typename KeyStorage, typename LookupCounting>
+void HashSet<ElementType, Hasher, NodeAllocator, Indexing, KeyStorage, LookupCounting>::relinkChain(HashNode<StoredKey<KeyStorage, ElementType>>* head) const
 {
-	int array_index = generateIndex(val);
-	HashNode<ElementType>* index_head = nodearray[array_index];
-	if(index_head == nullptr)
+	while(head != nullptr)
 	{
-		nodearray[array_index] = newNode(val, nullptr);
+		HashNode<StoredKey<KeyStorage, ElementType>>* next = head->next;
+		std::size_t array_index = generateIndex(head->hash);
+		head->next = nodearray[array_index];
+		nodearray[array_index] = head;
+		head = next;
 	}
-	else
-	{
+}
 
-		while(index_head->next != nullptr)
-		{
-			if(index_head->value == val)
-				return;
-			index_head = index_head->next;
-		}
-		if(index_head->value != val)
-			index_head->next = newNode(val, nullptr);
+template <typename ElementType, typename Hasher, typename NodeAllocator, typename Indexing, typename KeyStorage, typename LookupCounting>
+void HashSet<ElementType, Hasher, NodeAllocator, Indexing, KeyStorage, LookupCounting>::insertNode(const ElementType& val)
+{
+	std::size_t hash = hashFunction(val);
+	if(oldarray != nullptr)
+	{
+		migrateChains(MIGRATION_STEP);
+		if(oldarray != nullptr && findInChain(val, hash, oldarray[Indexing::index(hash, oldcapacity)]))
+			return;
 	}
+	std::size_t array_index = generateIndex(hash);
+	if(findInChain(val, hash, nodearray[array_index]))
+		return;
+	nodearray[array_index] = newNode(keys.keep(val), hash, nodearray[array_index]);
 
 	setsize++;
 	double loadfactor = (double)setsize / capacity;
 	if(loadfactor > DEFAULT_LOADFACTOR)
-		rehash();
+	{
+		if(resizemode == HashSetResize::Incremental)
+		{
+			finishResize();
+			beginResize(2 * capacity);
+		}
+		else
+		{
+			rehash();
+		}
+	}
 }
 
-template <typename ElementType>
-HashNode<ElementType>* HashSet<ElementType>::copyNode(HashNode<ElementType>* head)
+template <typename ElementType, typename Hasher, typename NodeAllocator, typename Indexing, typename KeyStorage, typename LookupCounting>
+HashNode<StoredKey<KeyStorage, ElementType>>* HashSet<ElementType, Hasher, NodeAllocator, Indexing, KeyStorage, LookupCounting>::copyNode(HashNode<StoredKey<KeyStorage, ElementType>>* head)
 {
-	if(head == nullptr) return nullptr;
-	return newNode(head->value, copyNode(head->next));
+	HashNode<StoredKey<KeyStorage, ElementType>>* copy_head = nullptr;
+	HashNode<StoredKey<KeyStorage, ElementType>>** tail = &copy_head;
+	while(head != nullptr)
+	{
+		*tail = newNode(head->value, head->hash, nullptr);
+		tail = &(*tail)->next;
+		head = head->next;
+	}
+	return copy_head;
 }
 
-template <typename ElementType>
-HashNode<ElementType>** HashSet<ElementType>::copyArray(HashNode<ElementType>** other, unsigned int arraysize)
+template <typename ElementType, typename Hasher, typename NodeAllocator, typename Indexing, typename KeyStorage, typename LookupCounting>
+HashNode<StoredKey<KeyStorage, ElementType>>** HashSet<ElementType, Hasher, NodeAllocator, Indexing, KeyStorage, LookupCounting>::copyArray(HashNode<StoredKey<KeyStorage, ElementType>>** other, std::size_t arraysize)
 {
-	HashNode<ElementType>** temp = new HashNode<ElementType>*[arraysize];
-	for(int i = 0; i < arraysize; i++)
+	HashNode<StoredKey<KeyStorage, ElementType>>** temp = NodeAllocator::template allocateArray<HashNode<StoredKey<KeyStorage, ElementType>>*>(arraysize);
+	for(std::size_t i = 0; i < arraysize; i++)
 		temp[i] = copyNode(other[i]);
 	return temp;
 }
 
-template <typename ElementType>
-void HashSet<ElementType>::deleteArray(HashNode<ElementType>**& other, unsigned int arraysize)
+template <typename ElementType, typename Hasher, typename NodeAllocator, typename Indexing, typename KeyStorage, typename LookupCounting>
+void HashSet<ElementType, Hasher, NodeAllocator, Indexing, KeyStorage, LookupCounting>::deleteArray(HashNode<StoredKey<KeyStorage, ElementType>>**& other, std::size_t arraysize)
 {
-	for(int i = 0; i < arraysize; i++)
+	if constexpr (decltype(nodes)::RELEASES_IN_BULK)
 	{
-		deleteNode(other[i]);
+		nodes.releaseAll();
 	}
-	delete[] other;
+	else
+	{
+		for(std::size_t i = 0; i < arraysize; i++)
+			deleteNode(other[i]);
+	}
+	NodeAllocator::releaseArray(other, arraysize);
+}
+
+template <typename ElementType, typename Hasher, typename NodeAllocator, typename Indexing, typename KeyStorage, typename LookupCounting>
+void HashSet<ElementType, Hasher, NodeAllocator, Indexing, KeyStorage, LookupCounting>::deleteArrays()
+{
+	if(oldarray != nullptr)
+	{
+		deleteArray(oldarray, oldcapacity);
+		oldarray = nullptr;
+	}
+	deleteArray(nodearray, capacity);
 }
 #endif // HASHSET_HPP
\ No newline at end of file
@@ -0,0 +1,289 @@
+// PackedWordSet.cpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+
+#include "PackedWordSet.hpp"
+#include <array>
+#include <iomanip>
+#include "HashMixing.hpp"
+
+
+
+namespace
+{
+	// LETTER_CODES[c] is the code character c packs to, from 1 to 28, or 0
+	// if it can't be packed.
+	constexpr std::array<unsigned char, 256> makeLetterCodes()
+	{
+		std::array<unsigned char, 256> codes{};
+		for(unsigned int c = 'A'; c <= 'Z'; c++)
+			codes[c] = static_cast<unsigned char>(c - 'A' + 1);
+		codes['\''] = 27;
+		codes['-'] = 28;
+		return codes;
+	}
+
+	constexpr std::array<unsigned char, 256> LETTER_CODES = makeLetterCodes();
+
+
+	// Appends the codes of the characters in [first, last) to packed.
+	// Returns false if any of them can't be packed.
+	bool packRange(const char* first, const char* last, std::uint64_t& packed) noexcept
+	{
+		//an unpackable character is noted rather than returned on at once,
+		//so the loop has no branch but its own
+		bool packable = true;
+		for(; first != last; first++)
+		{
+			unsigned char code = LETTER_CODES[static_cast<unsigned char>(*first)];
+			packable &= (code != 0);
+			packed = (packed << PackedWordSet::BITS_PER_LETTER) | code;
+		}
+		return packable;
+	}
+}
+
+
+
+template <typename Key>
+PackedWordSet::Table<Key>::Table()
+	: count{0}
+{
+}
+
+
+template <typename Key>
+bool PackedWordSet::Table<Key>::add(const Key& key)
+{
+	if(contains(key))
+		return false;
+	if(count + 1 > slots.size() * MAX_LOAD)
+		grow();
+
+	std::size_t mask = slots.size() / SLOTS_PER_BUCKET - 1;
+	for(std::size_t bucket = hashOf(key) & mask; ; bucket = (bucket + 1) & mask)
+	{
+		Key* first = &slots[bucket * SLOTS_PER_BUCKET];
+		for(std::size_t slot = 0; slot < SLOTS_PER_BUCKET; slot++)
+		{
+			if(isEmpty(first[slot]))
+			{
+				first[slot] = key;
+				count++;
+				return true;
+			}
+		}
+	}
+}
+
+
+template <typename Key>
+bool PackedWordSet::Table<Key>::contains(const Key& key) const noexcept
+{
+	if(count == 0)
+		return false;
+
+	//every slot in a bucket is compared, without branching on each one;
+	//a bucket with an empty slot ends the search, since add() would have
+	//put the key there
+	std::size_t mask = slots.size() / SLOTS_PER_BUCKET - 1;
+	for(std::size_t bucket = hashOf(key) & mask; ; bucket = (bucket + 1) & mask)
+	{
+		const Key* first = &slots[bucket * SLOTS_PER_BUCKET];
+		bool found = false;
+		bool empty = false;
+		for(std::size_t slot = 0; slot < SLOTS_PER_BUCKET; slot++)
+		{
+			found |= (first[slot] == key);
+			empty |= isEmpty(first[slot]);
+		}
+		if(found)
+			return true;
+		if(empty)
+			return false;
+	}
+}
+
+
+template <typename Key>
+std::size_t PackedWordSet::Table<Key>::size() const noexcept
+{
+	return count;
+}
+
+
+template <typename Key>
+std::size_t PackedWordSet::Table<Key>::capacity() const noexcept
+{
+	return slots.size();
+}
+
+
+template <typename Key>
+void PackedWordSet::Table<Key>::grow()
+{
+	std::vector<Key> old(slots.size() == 0 ? 2 * SLOTS_PER_BUCKET : slots.size() * 2, Key{});
+	old.swap(slots);
+	count = 0;
+
+	for(const Key& key : old)
+	{
+		if(!isEmpty(key))
+			add(key);
+	}
+}
+
+
+
+PackedWordSet::PackedWordSet()
+{
+}
+
+
+bool PackedWordSet::isImplemented() const noexcept
+{
+	return true;
+}
+
+
+void PackedWordSet::add(const std::string& element)
+{
+	std::size_t length = element.length();
+	if(length <= MAX_SHORT_LENGTH)
+	{
+		std::uint64_t packed;
+		if(pack(element, packed))
+		{
+			tables64[length].add(packed);
+			return;
+		}
+	}
+	else if(length <= MAX_PACKED_LENGTH)
+	{
+		Packed128 packed;
+		if(pack(element, packed))
+		{
+			tables128[length].add(packed);
+			return;
+		}
+	}
+	unpacked.add(element);
+}
+
+
+bool PackedWordSet::contains(const std::string& element) const
+{
+	std::size_t length = element.length();
+	if(length <= MAX_SHORT_LENGTH)
+	{
+		std::uint64_t packed;
+		if(pack(element, packed))
+			return tables64[length].contains(packed);
+	}
+	else if(length <= MAX_PACKED_LENGTH)
+	{
+		Packed128 packed;
+		if(pack(element, packed))
+			return tables128[length].contains(packed);
+	}
+	return unpacked.size() != 0 && unpacked.contains(element);
+}
+
+
+std::size_t PackedWordSet::size() const noexcept
+{
+	return packedCount() + unpackedCount();
+}
+
+
+void PackedWordSet::printStatistics(std::ostream& out) const
+{
+	out << std::left << std::fixed << std::setprecision(2);
+	out << std::setw(24) << "Packed words" << packedCount()
+		<< " (" << tableBytes() << " bytes of tables)" << '\n';
+	out << std::setw(24) << "Unpacked words" << unpackedCount() << '\n';
+	out << "Words by length" << '\n';
+
+	for(unsigned int length = 1; length <= MAX_PACKED_LENGTH; length++)
+	{
+		std::size_t words = (length <= MAX_SHORT_LENGTH ? tables64[length].size() : tables128[length].size());
+		std::size_t slots = (length <= MAX_SHORT_LENGTH ? tables64[length].capacity() : tables128[length].capacity());
+		if(words == 0)
+			continue;
+		out << "    " << std::setw(20) << length << words << " in " << slots << " slots" << '\n';
+	}
+	out << std::right;
+}
+
+
+std::size_t PackedWordSet::packedCount() const noexcept
+{
+	std::size_t count = 0;
+	for(unsigned int length = 0; length <= MAX_SHORT_LENGTH; length++)
+		count += tables64[length].size();
+	for(unsigned int length = MAX_SHORT_LENGTH + 1; length <= MAX_PACKED_LENGTH; length++)
+		count += tables128[length].size();
+	return count;
+}
+
+
+std::size_t PackedWordSet::unpackedCount() const noexcept
+{
+	return unpacked.size();
+}
+
+
+std::size_t PackedWordSet::tableBytes() const noexcept
+{
+	std::size_t bytes = 0;
+	for(unsigned int length = 0; length <= MAX_SHORT_LENGTH; length++)
+		bytes += tables64[length].capacity() * sizeof(std::uint64_t);
+	for(unsigned int length = MAX_SHORT_LENGTH + 1; length <= MAX_PACKED_LENGTH; length++)
+		bytes += tables128[length].capacity() * sizeof(Packed128);
+	return bytes;
+}
+
+
+bool PackedWordSet::pack(const std::string& word, std::uint64_t& packed) noexcept
+{
+	//the empty word would pack to zero, which marks an empty slot
+	packed = 0;
+	return !word.empty() && packRange(word.data(), word.data() + word.length(), packed);
+}
+
+
+bool PackedWordSet::pack(const std::string& word, Packed128& packed) noexcept
+{
+	//the first MAX_SHORT_LENGTH characters go in the high word and the
+	//rest (at least one) in the low word, so neither is ever zero
+	const char* middle = word.data() + MAX_SHORT_LENGTH;
+	packed.high = 0;
+	packed.low = 0;
+	return packRange(word.data(), middle, packed.high)
+		&& packRange(middle, word.data() + word.length(), packed.low);
+}
+
+
+bool PackedWordSet::isEmpty(std::uint64_t key) noexcept
+{
+	return key == 0;
+}
+
+
+bool PackedWordSet::isEmpty(const Packed128& key) noexcept
+{
+	return key.high == 0;
+}
+
+
+std::uint64_t PackedWordSet::hashOf(std::uint64_t key) noexcept
+{
+	return mixHash(key);
+}
+
+
+std::uint64_t PackedWordSet::hashOf(const Packed128& key) noexcept
+{
+	return mixHash(key.high ^ mixHash(key.low));
+}
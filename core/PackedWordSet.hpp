@@ -0,0 +1,135 @@
+// PackedWordSet.hpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+//
+// A PackedWordSet is a Set of strings that stores most words as integers
+// rather than as strings.  A word made only of the letters A-Z, the
+// apostrophe and the hyphen can be written in BITS_PER_LETTER bits per
+// character, so a word of up to MAX_SHORT_LENGTH characters packs into 64
+// bits, and one of up to MAX_PACKED_LENGTH characters into 128.  Since no
+// character is written as zero, the packed form can't be zero, and two
+// words of the same length pack to the same integer only if they're equal.
+//
+// The words are partitioned by length, one open-addressing table per
+// length, so a lookup packs the word, hashes the integer, and compares
+// integers in the one table for its length (usually in one cache line): no
+// string is stored or compared, and every table is small.  (The edits
+// WordChecker tries change a word's length by at most one, so each one
+// goes to one of three tables, each of which stays in cache.)  Words that
+// can't be packed, because they're longer or contain other characters
+// (digits, or lowercase letters), go into an ordinary SwissHashSet.
+
+#ifndef PACKEDWORDSET_HPP
+#define PACKEDWORDSET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "Set.hpp"
+#include "StringHashing.hpp"
+#include "SwissHashSet.hpp"
+
+
+
+class PackedWordSet : public Set<std::string>
+{
+public:
+	static constexpr unsigned int BITS_PER_LETTER = 5;
+	static constexpr unsigned int MAX_SHORT_LENGTH = 64 / BITS_PER_LETTER;
+	static constexpr unsigned int MAX_PACKED_LENGTH = 2 * MAX_SHORT_LENGTH;
+
+	// The fraction of a table's slots that can be full before it doubles.
+	static constexpr double MAX_LOAD = 0.8;
+
+public:
+	PackedWordSet();
+
+	virtual bool isImplemented() const noexcept override;
+
+
+	// add() adds an element to the set.  If the element is already in the
+	// set, this function has no effect.
+	virtual void add(const std::string& element) override;
+
+
+	// contains() returns true if the given element is already in the set,
+	// false otherwise.
+	virtual bool contains(const std::string& element) const override;
+
+
+	virtual std::size_t size() const noexcept override;
+
+
+	// printStatistics() prints the number of words and slots in each
+	// length's table, and the number of words that couldn't be packed.
+	virtual void printStatistics(std::ostream& out) const override;
+
+
+	// packedCount() returns the number of words stored as integers, and
+	// unpackedCount() the number stored as strings.
+	std::size_t packedCount() const noexcept;
+	std::size_t unpackedCount() const noexcept;
+
+
+	// tableBytes() returns the size, in bytes, of the integer tables.
+	std::size_t tableBytes() const noexcept;
+
+
+private:
+	struct Packed128
+	{
+		std::uint64_t high;
+		std::uint64_t low;
+
+		bool operator==(const Packed128& other) const noexcept
+		{
+			return high == other.high && low == other.low;
+		}
+	};
+
+	// A Table is an array of 64-byte buckets, probed linearly; a key goes
+	// in the first bucket, starting from the one its hash picks, that has
+	// an empty slot.
+	template <typename Key>
+	class Table
+	{
+	public:
+		static constexpr std::size_t SLOTS_PER_BUCKET = 64 / sizeof(Key);
+
+		Table();
+
+		bool add(const Key& key);
+		bool contains(const Key& key) const noexcept;
+
+		std::size_t size() const noexcept;
+		std::size_t capacity() const noexcept;
+
+	private:
+		std::vector<Key> slots;
+		std::size_t count;
+
+		void grow();
+	};
+
+	// tables64[n] and tables128[n] hold the packable words of length n;
+	// only one of the two is ever used for any given length.
+	Table<std::uint64_t> tables64[MAX_SHORT_LENGTH + 1];
+	Table<Packed128> tables128[MAX_PACKED_LENGTH + 1];
+	SwissHashSet<std::string, WordMixHash> unpacked;
+
+	static bool pack(const std::string& word, std::uint64_t& packed) noexcept;
+	static bool pack(const std::string& word, Packed128& packed) noexcept;
+
+	// A slot holding zero (which no word packs to) is empty.
+	static bool isEmpty(std::uint64_t key) noexcept;
+	static bool isEmpty(const Packed128& key) noexcept;
+	static std::uint64_t hashOf(std::uint64_t key) noexcept;
+	static std::uint64_t hashOf(const Packed128& key) noexcept;
+};
+
+
+
+#endif // PACKEDWORDSET_HPP
@@ -0,0 +1,308 @@
+// PerfectHashSet.cpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+
+#include "PerfectHashSet.hpp"
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include "HashMixing.hpp"
+
+
+PerfectHashSet::PerfectHashSet()
+	: table{0, 0, 0, 0, {}, {}, {0}, {}}
+{
+}
+
+
+bool PerfectHashSet::isImplemented() const noexcept
+{
+	return true;
+}
+
+
+void PerfectHashSet::add(const std::string& element)
+{
+	if(tableContains(element))
+		return;
+	pending.insert(element);
+}
+
+
+bool PerfectHashSet::contains(const std::string& element) const
+{
+	return tableContains(element) || (!pending.empty() && pending.count(element) != 0);
+}
+
+
+std::size_t PerfectHashSet::size() const noexcept
+{
+	return table.keyCount + pending.size();
+}
+
+
+void PerfectHashSet::reserve(std::size_t expectedSize)
+{
+	pending.reserve(expectedSize);
+}
+
+
+void PerfectHashSet::freeze()
+{
+	if(!pending.empty())
+		build();
+}
+
+
+std::size_t PerfectHashSet::hashFunctionBits() const
+{
+	return table.pilots.size() * 16 + table.remap.size() * 32;
+}
+
+
+std::size_t PerfectHashSet::storageBytes() const
+{
+	return table.pilots.size() * sizeof(std::uint16_t)
+		+ table.remap.size() * sizeof(std::uint32_t)
+		+ table.offsets.size() * sizeof(std::uint32_t)
+		+ table.keys.size();
+}
+
+
+bool PerfectHashSet::tableContains(const std::string& element) const noexcept
+{
+	if(table.keyCount == 0)
+		return false;
+
+	std::uint64_t hash = hashKey(element, table.seed);
+	std::uint32_t slot = slotOf(hash, table.pilots[bucketOf(hash, table.bucketCount)], table.slotCount);
+	if(slot >= table.keyCount)
+		slot = table.remap[slot - table.keyCount];
+
+	std::uint32_t start = table.offsets[slot];
+	std::uint32_t length = table.offsets[slot + 1] - start;
+	return length == element.length()
+		&& std::memcmp(table.keys.data() + start, element.data(), length) == 0;
+}
+
+
+void PerfectHashSet::build()
+{
+	std::vector<std::string> words;
+	words.reserve(table.keyCount + pending.size());
+
+	for(std::uint32_t i = 0; i < table.keyCount; i++)
+		words.emplace_back(table.keys.data() + table.offsets[i], table.offsets[i + 1] - table.offsets[i]);
+	words.insert(words.end(), pending.begin(), pending.end());
+
+	std::size_t totalLength = 0;
+	for(const std::string& word : words)
+		totalLength += word.length();
+	if(words.size() >= 0xFFFFFFFFULL || totalLength > 0xFFFFFFFFULL)
+		throw BuildFailedException{};
+
+	for(unsigned int attempt = 0; attempt < MAX_ATTEMPTS; attempt++)
+	{
+		if(tryBuild(words, mixHash(0x9e3779b97f4a7c15ULL * (attempt + 1))))
+		{
+			std::unordered_set<std::string>{}.swap(pending);
+			return;
+		}
+	}
+
+	throw BuildFailedException{};
+}
+
+
+bool PerfectHashSet::tryBuild(const std::vector<std::string>& words, std::uint64_t seed)
+{
+	//hash every word, sort by hash, and drop duplicates; two different
+	//words with the same hash can never be told apart, so that needs a
+	//new seed
+	std::vector<std::pair<std::uint64_t, std::uint32_t>> hashed;
+	hashed.reserve(words.size());
+	for(std::uint32_t i = 0; i < words.size(); i++)
+		hashed.emplace_back(hashKey(words[i], seed), i);
+	std::sort(hashed.begin(), hashed.end());
+
+	std::vector<std::uint64_t> hashes;
+	std::vector<std::uint32_t> wordIndexes;
+	hashes.reserve(hashed.size());
+	wordIndexes.reserve(hashed.size());
+
+	for(const auto& h : hashed)
+	{
+		if(!hashes.empty() && hashes.back() == h.first)
+		{
+			if(words[wordIndexes.back()] == words[h.second])
+				continue;
+			return false;
+		}
+		hashes.push_back(h.first);
+		wordIndexes.push_back(h.second);
+	}
+
+	Table t{seed, static_cast<std::uint32_t>(hashes.size()), 0, 0, {}, {}, {0}, {}};
+	std::uint32_t n = t.keyCount;
+
+	if(n == 0)
+	{
+		table = std::move(t);
+		return true;
+	}
+
+	t.slotCount = std::max(n, static_cast<std::uint32_t>(n / SLOT_LOAD));
+	t.bucketCount = (n + BUCKET_SIZE - 1) / BUCKET_SIZE;
+
+	//group the keys by bucket (a counting sort), then order the buckets
+	//from largest to smallest, since large buckets are hardest to place
+	//once the table starts filling up
+	std::vector<std::uint32_t> bucketStart(t.bucketCount + 1, 0);
+	for(std::uint64_t hash : hashes)
+		bucketStart[bucketOf(hash, t.bucketCount) + 1]++;
+	for(std::uint32_t b = 0; b < t.bucketCount; b++)
+		bucketStart[b + 1] += bucketStart[b];
+
+	std::vector<std::uint32_t> bucketKeys(n);
+	std::vector<std::uint32_t> fill(bucketStart.begin(), bucketStart.end() - 1);
+	for(std::uint32_t k = 0; k < n; k++)
+		bucketKeys[fill[bucketOf(hashes[k], t.bucketCount)]++] = k;
+
+	std::vector<std::uint32_t> bucketOrder(t.bucketCount);
+	for(std::uint32_t b = 0; b < t.bucketCount; b++)
+		bucketOrder[b] = b;
+	std::stable_sort(bucketOrder.begin(), bucketOrder.end(),
+		[&](std::uint32_t a, std::uint32_t b)
+		{
+			return bucketStart[a + 1] - bucketStart[a] > bucketStart[b + 1] - bucketStart[b];
+		});
+
+	t.pilots.assign(t.bucketCount, 0);
+	std::vector<unsigned char> taken(t.slotCount, false);
+	std::vector<std::uint64_t> bucketHashes;
+	std::vector<std::uint32_t> slots;
+
+	for(std::uint32_t b : bucketOrder)
+	{
+		std::uint32_t first = bucketStart[b];
+		std::uint32_t last = bucketStart[b + 1];
+		if(first == last)
+			break;
+
+		bucketHashes.clear();
+		for(std::uint32_t i = first; i < last; i++)
+			bucketHashes.push_back(hashes[bucketKeys[i]]);
+
+		bool placed = false;
+		for(std::uint32_t pilot = 0; pilot <= MAX_PILOT && !placed; pilot++)
+		{
+			slots.clear();
+			placed = true;
+			for(std::uint64_t hash : bucketHashes)
+			{
+				std::uint32_t slot = slotOf(hash, pilot, t.slotCount);
+				if(taken[slot] || std::find(slots.begin(), slots.end(), slot) != slots.end())
+				{
+					placed = false;
+					break;
+				}
+				slots.push_back(slot);
+			}
+
+			if(placed)
+			{
+				for(std::uint32_t slot : slots)
+					taken[slot] = true;
+				t.pilots[b] = static_cast<std::uint16_t>(pilot);
+			}
+		}
+
+		if(!placed)
+			return false;
+	}
+
+	//every taken slot past n - 1 is sent to one of the slots below n that
+	//nothing landed in; there are exactly as many of one as the other
+	t.remap.assign(t.slotCount - n, 0);
+	std::uint32_t freeSlot = 0;
+	for(std::uint32_t slot = n; slot < t.slotCount; slot++)
+	{
+		if(!taken[slot])
+			continue;
+		while(taken[freeSlot])
+			freeSlot++;
+		t.remap[slot - n] = freeSlot++;
+	}
+
+	//lay the words out contiguously, in slot order
+	std::vector<std::uint32_t> wordAt(n);
+	std::size_t totalLength = 0;
+	for(std::uint32_t k = 0; k < n; k++)
+	{
+		std::uint32_t slot = slotOf(hashes[k], t.pilots[bucketOf(hashes[k], t.bucketCount)], t.slotCount);
+		if(slot >= n)
+			slot = t.remap[slot - n];
+		wordAt[slot] = wordIndexes[k];
+		totalLength += words[wordIndexes[k]].length();
+	}
+
+	t.offsets.reserve(n + 1);
+	t.keys.reserve(totalLength);
+	for(std::uint32_t slot = 0; slot < n; slot++)
+	{
+		const std::string& word = words[wordAt[slot]];
+		t.keys.insert(t.keys.end(), word.begin(), word.end());
+		t.offsets.push_back(static_cast<std::uint32_t>(t.keys.size()));
+	}
+
+	table = std::move(t);
+	return true;
+}
+
+
+std::uint64_t PerfectHashSet::hashKey(const std::string& key, std::uint64_t seed) noexcept
+{
+	//eight characters at a time, each chunk folded in through mixHash()
+	std::uint64_t hash = seed ^ (key.length() * 0x9e3779b97f4a7c15ULL);
+	const char* data = key.data();
+	std::size_t remaining = key.length();
+
+	for(; remaining >= 8; data += 8, remaining -= 8)
+	{
+		std::uint64_t chunk;
+		std::memcpy(&chunk, data, 8);
+		hash = mixHash(hash ^ chunk);
+	}
+
+	std::uint64_t tail = 0;
+	std::memcpy(&tail, data, remaining);
+	return mixHash(hash ^ tail ^ seed);
+}
+
+
+std::uint32_t PerfectHashSet::bucketOf(std::uint64_t hash, std::uint32_t bucketCount) noexcept
+{
+	//the high 32 bits pick the bucket; as in PTHash, the distribution is
+	//skewed so that 60% of the keys land in the first 30% of the buckets,
+	//which are placed while the table is still mostly empty (both
+	//divisions are by constants, so they compile to multiplications)
+	constexpr std::uint64_t DENSE_KEYS = 0x99999999ULL;
+	std::uint64_t high = hash >> 32;
+	std::uint64_t denseBuckets = bucketCount * 3ULL / 10;
+
+	if(high < DENSE_KEYS)
+		return static_cast<std::uint32_t>(high * denseBuckets / DENSE_KEYS);
+	else
+		return static_cast<std::uint32_t>(
+			denseBuckets + (high - DENSE_KEYS) * (bucketCount - denseBuckets) / (0x100000000ULL - DENSE_KEYS));
+}
+
+
+std::uint32_t PerfectHashSet::slotOf(std::uint64_t hash, std::uint16_t pilot, std::uint32_t slotCount) noexcept
+{
+	//the low 32 bits (the high ones chose the bucket, so they're similar
+	//for every key in it), scaled into [0, slotCount) without a division
+	std::uint32_t low = static_cast<std::uint32_t>(hash ^ mixHash(pilot));
+	return static_cast<std::uint32_t>((static_cast<std::uint64_t>(low) * slotCount) >> 32);
+}
@@ -0,0 +1,151 @@
+// PerfectHashSet.hpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+//
+// A PerfectHashSet is a Set of strings meant for a word set that is built
+// once and then only searched.  Once its words are known, it builds a
+// minimal perfect hash function over them: a function that maps each of
+// the n words to a different index from 0 to n - 1.  The words are then
+// stored back to back, in index order, in one contiguous block of
+// characters, so a lookup hashes the word, computes its index, and does
+// exactly one comparison against the only word that could match.  There
+// are no chains, no empty buckets and no load factor.
+//
+// The hash function is built in the style of PTHash.  Each word is hashed
+// once to 64 bits, and the hash picks one of about n / BUCKET_SIZE
+// buckets.  Buckets are then placed from largest to smallest: for each,
+// the builder searches for the smallest "pilot" value that sends all of
+// the bucket's words (hash XOR mixHash(pilot)) to slots nobody has taken
+// yet, and records that pilot in 16 bits.  The slot table is a little
+// larger than n (n / SLOT_LOAD), which keeps the last few buckets from
+// needing enormous pilots; slots past n - 1 are then remapped, through a
+// small table, to the slots below n that were left empty.  If some bucket
+// can't be placed, the whole build is retried with a new seed.
+//
+// Words added by add() are held aside, in an ordinary hash table, until
+// freeze() builds the perfect hash table from them (WordSetLoader calls
+// it after loading).  Until then, contains() searches the waiting words
+// too, so they're found either way, just without the benefit of the
+// perfect hash.  Adding words after freeze() is allowed, but the next
+// freeze() rebuilds the whole table, so it's best avoided.  contains()
+// and size() never build anything, so any number of threads can search
+// a PerfectHashSet at once, as long as none is adding to it.
+//
+// Word indexes and character offsets are stored in 32 bits, which keeps
+// the table compact but limits it to fewer than 2^32 words totalling
+// fewer than 2^32 characters.
+
+#ifndef PERFECTHASHSET_HPP
+#define PERFECTHASHSET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "Set.hpp"
+
+
+
+class PerfectHashSet : public Set<std::string>
+{
+public:
+	// The average number of words per bucket.  Larger buckets make the
+	// pilot table smaller but the build slower.
+	static constexpr unsigned int BUCKET_SIZE = 4;
+
+	// The fraction of the slot table that ends up holding words.
+	static constexpr double SLOT_LOAD = 0.97;
+
+	// Pilots are stored in 16 bits, so a bucket that can't be placed with
+	// any pilot up to MAX_PILOT makes the build start over.
+	static constexpr unsigned int MAX_PILOT = 0xFFFF;
+
+	// The number of seeds tried before giving up on building.
+	static constexpr unsigned int MAX_ATTEMPTS = 100;
+
+	// A BuildFailedException is thrown if no seed leads to a perfect hash
+	// function, which in practice happens only if two different words have
+	// the same 64-bit hash under every seed, or if the words exceed the
+	// 32-bit limits described above.
+	class BuildFailedException { };
+
+
+public:
+	PerfectHashSet();
+
+	virtual bool isImplemented() const noexcept override;
+
+
+	// add() adds an element to the set.  If the element is already in the
+	// set, this function has no effect.  The element waits to be built
+	// into the table by the next freeze().
+	virtual void add(const std::string& element) override;
+
+
+	// contains() returns true if the given element is already in the set,
+	// false otherwise.  It runs in constant time, with one hash and one
+	// string comparison, once the table has been built; while words are
+	// waiting, they're searched as well.
+	virtual bool contains(const std::string& element) const override;
+
+
+	// size() returns the number of elements in the set, counting the ones
+	// waiting to be built.
+	virtual std::size_t size() const noexcept override;
+
+
+	// reserve() makes room for expectedSize words waiting to be built.
+	virtual void reserve(std::size_t expectedSize) override;
+
+
+	// freeze() builds the table from every word added so far.  It throws
+	// a BuildFailedException if that can't be done.
+	virtual void freeze() override;
+
+
+	// hashFunctionBits() returns the size of the perfect hash function
+	// itself (the pilots and the remapping table), in bits, not counting
+	// the words or their offsets.
+	std::size_t hashFunctionBits() const;
+
+
+	// storageBytes() returns the total size, in bytes, of everything the
+	// table keeps: pilots, remapping table, word offsets and characters.
+	std::size_t storageBytes() const;
+
+
+private:
+	struct Table
+	{
+		std::uint64_t seed;
+		std::uint32_t keyCount;
+		std::uint32_t slotCount;
+		std::uint32_t bucketCount;
+		std::vector<std::uint16_t> pilots;
+		std::vector<std::uint32_t> remap;
+		std::vector<std::uint32_t> offsets;
+		std::vector<char> keys;
+	};
+
+	Table table;
+
+	//the words added since the table was last built, none of which are in
+	//it; they're kept in a hash table so that contains() and size() can
+	//answer for them without building anything
+	std::unordered_set<std::string> pending;
+
+	bool tableContains(const std::string& element) const noexcept;
+	void build();
+	bool tryBuild(const std::vector<std::string>& words, std::uint64_t seed);
+
+	static std::uint64_t hashKey(const std::string& key, std::uint64_t seed) noexcept;
+	static std::uint32_t bucketOf(std::uint64_t hash, std::uint32_t bucketCount) noexcept;
+	static std::uint32_t slotOf(std::uint64_t hash, std::uint16_t pilot, std::uint32_t slotCount) noexcept;
+};
+
+
+
+#endif // PERFECTHASHSET_HPP
+
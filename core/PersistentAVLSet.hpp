@@ -0,0 +1,467 @@
+// PersistentAVLSet.hpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+//
+// A PersistentAVLSet is an AVL tree whose nodes can be shared by several
+// versions of the set.  Copying one (or calling snapshot()) takes
+// constant time: the copy just points to the same root.  Each node counts
+// the links to it -- from parents, in any version, and from the sets
+// whose root it is -- and is deleted when the last of them goes away.
+//
+// A node that more than one link leads to is never changed.  Instead,
+// add() copies the nodes on the path from the root down to where the new
+// element goes (which, in a balanced tree, is O(log n) of them), and
+// links the copies to the untouched subtrees on either side of the path,
+// so the other versions still see exactly the nodes they saw before.
+// Rotations only rearrange nodes on that path, which belong to the set
+// being added to.  A node that only one link leads to belongs to just
+// one version, so it's changed in place rather than copied, which means
+// a set that has never been copied is built as cheaply as an AVLSet.
+//
+// The counts are atomic, so versions of a set can be used and destroyed
+// on different threads at the same time, as long as each version (like
+// any other Set) is only changed by one thread at a time.  A reader
+// holding an older version never sees a partly finished add(), since the
+// nodes it can reach are never changed.
+//
+// Nodes are allocated one at a time, since they can outlive the set that
+// created them, and the elements are kept in the nodes themselves.
+
+#ifndef PERSISTENTAVLSET_HPP
+#define PERSISTENTAVLSET_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include "KeyStorage.hpp"
+#include "OrderedSet.hpp"
+
+
+
+template <typename ElementType>
+class PersistentAVLSet : public OrderedSet<ElementType>
+{
+public:
+	// A VisitFunction is a function that takes a reference to a const
+	// ElementType and returns no value.
+	using VisitFunction = std::function<void(const ElementType&)>;
+
+	// A WhileFunction is a visit function that returns false to stop the
+	// visiting (see OrderedSet).
+	using WhileFunction = typename OrderedSet<ElementType>::WhileFunction;
+
+public:
+	// Initializes a PersistentAVLSet to be empty.
+	PersistentAVLSet() noexcept;
+
+	// Gives up this version's links to its nodes, deleting the ones that
+	// no other version shares.
+	virtual ~PersistentAVLSet() noexcept;
+
+	// Initializes a new PersistentAVLSet to be a copy of an existing one,
+	// sharing all of its nodes, in constant time.
+	PersistentAVLSet(const PersistentAVLSet& s) noexcept;
+
+	// Initializes a new PersistentAVLSet whose contents are moved from an
+	// expiring one.
+	PersistentAVLSet(PersistentAVLSet&& s) noexcept;
+
+	// Assigns an existing PersistentAVLSet into another, sharing all of
+	// its nodes, in constant time.
+	PersistentAVLSet& operator=(const PersistentAVLSet& s) noexcept;
+
+	// Assigns an expiring PersistentAVLSet into another.
+	PersistentAVLSet& operator=(PersistentAVLSet&& s) noexcept;
+
+
+	virtual bool isImplemented() const noexcept override;
+
+
+	// add() adds an element to the set.  If the element is already in the
+	// set, this function has no effect (and copies nothing).  Otherwise,
+	// it copies whichever nodes on the path to the new element are shared
+	// with another version.  This function runs in O(log n) time when
+	// there are n elements in the set.
+	virtual void add(const ElementType& element) override;
+
+
+	// contains() returns true if the given element is already in the set,
+	// false otherwise.  This function runs in O(log n) time when there
+	// are n elements in the set.
+	virtual bool contains(const ElementType& element) const override;
+
+
+	// size() returns the number of elements in the set.
+	virtual std::size_t size() const noexcept override;
+
+
+	// snapshot() returns a copy of the set as it is now, in constant time.
+	// Neither the copy nor the original is affected by what is later added
+	// to the other.
+	PersistentAVLSet snapshot() const noexcept;
+
+
+	// ownedNodeCount() returns the number of nodes that belong to this
+	// version alone (i.e., the nodes that destroying it would delete).
+	// This function runs in time proportional to that number.
+	std::size_t ownedNodeCount() const noexcept;
+
+
+	// height() returns the height of the AVL tree.  As in AVLSet, the
+	// height of an empty tree is -1.
+	int height() const noexcept;
+
+
+	// inorder() calls the given "visit" function for each of the elements
+	// in the set, in ascending order.
+	void inorder(VisitFunction visit) const;
+
+
+	// visitFrom() calls the given "visit" function for each element that
+	// is not less than low, in ascending order, until it returns false.
+	// This runs in O(log n + k) time when k elements are visited.
+	virtual std::size_t visitFrom(const ElementType& low, WhileFunction visit) const override;
+
+
+private:
+	struct Node
+	{
+		ElementType data;
+		Node* left;
+		Node* right;
+		int height;
+		std::atomic<unsigned int> links;
+	};
+
+	Node* root;
+	std::size_t treesize;
+	DirectKeys::Store<ElementType> keys;
+
+	static void retain(Node* node) noexcept;
+	static void release(Node* node) noexcept;
+	static int getHeight(const Node* node) noexcept;
+	static void updateHeight(Node* node) noexcept;
+	static Node* leftRotate(Node* node) noexcept;
+	static Node* rightRotate(Node* node) noexcept;
+	static Node* rebalance(Node* node) noexcept;
+	static std::size_t countOwned(const Node* node) noexcept;
+	Node* writable(Node* node);
+	Node* insertNode(Node* node, const ElementType& element);
+	void invisitnode(VisitFunction& visit, const Node* node) const;
+	bool visitFromNode(const ElementType& low, WhileFunction& visit, const Node* node, std::size_t& visited) const;
+	bool visitAllNode(WhileFunction& visit, const Node* node, std::size_t& visited) const;
+};
+
+
+
+template <typename ElementType>
+PersistentAVLSet<ElementType>::PersistentAVLSet() noexcept
+	: root{nullptr}, treesize{0}
+{
+}
+
+
+template <typename ElementType>
+PersistentAVLSet<ElementType>::~PersistentAVLSet() noexcept
+{
+	release(root);
+}
+
+
+template <typename ElementType>
+PersistentAVLSet<ElementType>::PersistentAVLSet(const PersistentAVLSet& s) noexcept
+	: root{s.root}, treesize{s.treesize}
+{
+	retain(root);
+}
+
+
+template <typename ElementType>
+PersistentAVLSet<ElementType>::PersistentAVLSet(PersistentAVLSet&& s) noexcept
+	: root{s.root}, treesize{s.treesize}
+{
+	s.root = nullptr;
+	s.treesize = 0;
+}
+
+
+template <typename ElementType>
+PersistentAVLSet<ElementType>& PersistentAVLSet<ElementType>::operator=(const PersistentAVLSet& s) noexcept
+{
+	//the new root is retained before the old one is released, in case
+	//they're the same
+	retain(s.root);
+	release(root);
+	root = s.root;
+	treesize = s.treesize;
+	return *this;
+}
+
+
+template <typename ElementType>
+PersistentAVLSet<ElementType>& PersistentAVLSet<ElementType>::operator=(PersistentAVLSet&& s) noexcept
+{
+	std::swap(root, s.root);
+	std::swap(treesize, s.treesize);
+	return *this;
+}
+
+
+template <typename ElementType>
+bool PersistentAVLSet<ElementType>::isImplemented() const noexcept
+{
+	return true;
+}
+
+
+template <typename ElementType>
+void PersistentAVLSet<ElementType>::add(const ElementType& element)
+{
+	//searching first means that adding an element that's already there
+	//copies nothing
+	if(contains(element))
+		return;
+	root = insertNode(root, element);
+	treesize++;
+}
+
+
+template <typename ElementType>
+bool PersistentAVLSet<ElementType>::contains(const ElementType& element) const
+{
+	const Node* node = root;
+	while(node != nullptr)
+	{
+		int order = keys.compare(element, node->data);
+		if(order == 0)
+			return true;
+		node = (order < 0 ? node->left : node->right);
+	}
+	return false;
+}
+
+
+template <typename ElementType>
+std::size_t PersistentAVLSet<ElementType>::size() const noexcept
+{
+	return treesize;
+}
+
+
+template <typename ElementType>
+PersistentAVLSet<ElementType> PersistentAVLSet<ElementType>::snapshot() const noexcept
+{
+	return PersistentAVLSet{*this};
+}
+
+
+template <typename ElementType>
+std::size_t PersistentAVLSet<ElementType>::ownedNodeCount() const noexcept
+{
+	return countOwned(root);
+}
+
+
+template <typename ElementType>
+int PersistentAVLSet<ElementType>::height() const noexcept
+{
+	return getHeight(root) - 1;
+}
+
+
+template <typename ElementType>
+void PersistentAVLSet<ElementType>::inorder(VisitFunction visit) const
+{
+	invisitnode(visit, root);
+}
+
+
+template <typename ElementType>
+std::size_t PersistentAVLSet<ElementType>::visitFrom(const ElementType& low, WhileFunction visit) const
+{
+	std::size_t visited = 0;
+	visitFromNode(low, visit, root, visited);
+	return visited;
+}
+
+
+template <typename ElementType>
+void PersistentAVLSet<ElementType>::retain(Node* node) noexcept
+{
+	if(node != nullptr)
+		node->links.fetch_add(1, std::memory_order_relaxed);
+}
+
+
+template <typename ElementType>
+void PersistentAVLSet<ElementType>::release(Node* node) noexcept
+{
+	//whoever gives up the last link deletes the node, after everything
+	//the other threads did with it (hence acq_rel)
+	if(node != nullptr && node->links.fetch_sub(1, std::memory_order_acq_rel) == 1)
+	{
+		release(node->left);
+		release(node->right);
+		delete node;
+	}
+}
+
+
+template <typename ElementType>
+int PersistentAVLSet<ElementType>::getHeight(const Node* node) noexcept
+{
+	return node == nullptr ? 0 : node->height;
+}
+
+
+template <typename ElementType>
+void PersistentAVLSet<ElementType>::updateHeight(Node* node) noexcept
+{
+	node->height = 1 + std::max(getHeight(node->left), getHeight(node->right));
+}
+
+
+template <typename ElementType>
+typename PersistentAVLSet<ElementType>::Node* PersistentAVLSet<ElementType>::leftRotate(Node* node) noexcept
+{
+	//a link is moved from one node to another, so no counts change
+	Node* pivot = node->right;
+	node->right = pivot->left;
+	pivot->left = node;
+	updateHeight(node);
+	updateHeight(pivot);
+	return pivot;
+}
+
+
+template <typename ElementType>
+typename PersistentAVLSet<ElementType>::Node* PersistentAVLSet<ElementType>::rightRotate(Node* node) noexcept
+{
+	Node* pivot = node->left;
+	node->left = pivot->right;
+	pivot->right = node;
+	updateHeight(node);
+	updateHeight(pivot);
+	return pivot;
+}
+
+
+template <typename ElementType>
+typename PersistentAVLSet<ElementType>::Node* PersistentAVLSet<ElementType>::rebalance(Node* node) noexcept
+{
+	//only called on the path an element was just added along, whose nodes
+	//(including the child on the taller side, and its child on the path)
+	//all belong to this version
+	updateHeight(node);
+	int balance = getHeight(node->left) - getHeight(node->right);
+	if(balance > 1)
+	{
+		if(getHeight(node->left->left) < getHeight(node->left->right))
+			node->left = leftRotate(node->left);
+		return rightRotate(node);
+	}
+	if(balance < -1)
+	{
+		if(getHeight(node->right->right) < getHeight(node->right->left))
+			node->right = rightRotate(node->right);
+		return leftRotate(node);
+	}
+	return node;
+}
+
+
+template <typename ElementType>
+std::size_t PersistentAVLSet<ElementType>::countOwned(const Node* node) noexcept
+{
+	if(node == nullptr || node->links.load(std::memory_order_relaxed) != 1)
+		return 0;
+	return 1 + countOwned(node->left) + countOwned(node->right);
+}
+
+
+template <typename ElementType>
+typename PersistentAVLSet<ElementType>::Node* PersistentAVLSet<ElementType>::writable(Node* node)
+{
+	//a node with only one link belongs to this version alone (another
+	//version can't gain a link to it without going through this one), so
+	//it can be changed in place; otherwise, this version's link is moved
+	//to a copy, which adds a link to each of the node's children
+	if(node->links.load(std::memory_order_acquire) == 1)
+		return node;
+
+	Node* copy = new Node{node->data, node->left, node->right, node->height, {1}};
+	retain(copy->left);
+	retain(copy->right);
+	release(node);
+	return copy;
+}
+
+
+template <typename ElementType>
+typename PersistentAVLSet<ElementType>::Node* PersistentAVLSet<ElementType>::insertNode(Node* node, const ElementType& element)
+{
+	//takes over the caller's link to node, and returns the root of the
+	//subtree with the element added to it
+	if(node == nullptr)
+		return new Node{element, nullptr, nullptr, 1, {1}};
+
+	node = writable(node);
+	if(keys.compare(element, node->data) < 0)
+		node->left = insertNode(node->left, element);
+	else
+		node->right = insertNode(node->right, element);
+	return rebalance(node);
+}
+
+
+template <typename ElementType>
+void PersistentAVLSet<ElementType>::invisitnode(VisitFunction& visit, const Node* node) const
+{
+	if(node == nullptr) return;
+	invisitnode(visit, node->left);
+	visit(node->data);
+	invisitnode(visit, node->right);
+}
+
+
+template <typename ElementType>
+bool PersistentAVLSet<ElementType>::visitFromNode(const ElementType& low, WhileFunction& visit, const Node* node, std::size_t& visited) const
+{
+	//as in AVLSet, subtrees whose elements are all less than low are
+	//skipped on the way down
+	while(node != nullptr)
+	{
+		if(keys.compare(low, node->data) > 0)
+		{
+			node = node->right;
+			continue;
+		}
+		if(!visitFromNode(low, visit, node->left, visited))
+			return false;
+		visited++;
+		if(!visit(node->data))
+			return false;
+		return visitAllNode(visit, node->right, visited);
+	}
+	return true;
+}
+
+
+template <typename ElementType>
+bool PersistentAVLSet<ElementType>::visitAllNode(WhileFunction& visit, const Node* node, std::size_t& visited) const
+{
+	if(node == nullptr) return true;
+	if(!visitAllNode(visit, node->left, visited))
+		return false;
+	visited++;
+	if(!visit(node->data))
+		return false;
+	return visitAllNode(visit, node->right, visited);
+}
+
+
+
+#endif // PERSISTENTAVLSET_HPP
@@ -24,6 +24,7 @@
 #ifndef SKIPLISTSET_HPP
 #define SKIPLISTSET_HPP
 
+#include <cstddef>
 #include <memory>
 #include <random>
 #include "Set.hpp"
@@ -215,7 +216,7 @@ public:
 
 
     // size() returns the number of elements in the set.
-    virtual unsigned int size() const noexcept override;
+    virtual std::size_t size() const noexcept override;
 
 
     // levelCount() returns the number of levels in the skip list.
@@ -227,7 +228,7 @@ public:
     // level 1 is the one above level 0; and so on.  If the given level
     // doesn't exist, this function returns 0.  (Note that the -INF
     // and +INF shouldn't be counted.)
-    unsigned int elementsOnLevel(unsigned int level) const noexcept;
+    std::size_t elementsOnLevel(unsigned int level) const noexcept;
 
 
     // isElementOnLevel() returns true if the given element is on the
@@ -310,7 +311,7 @@ bool SkipListSet<ElementType>::contains(const ElementType& element) const
 
 
 template <typename ElementType>
-unsigned int SkipListSet<ElementType>::size() const noexcept
+std::size_t SkipListSet<ElementType>::size() const noexcept
 {
     return 0;
 }
@@ -324,7 +325,7 @@ unsigned int SkipListSet<ElementType>::levelCount() const noexcept
 
 
 template <typename ElementType>
-unsigned int SkipListSet<ElementType>::elementsOnLevel(unsigned int level) const noexcept
+std::size_t SkipListSet<ElementType>::elementsOnLevel(unsigned int level) const noexcept
 {
     return 0;
 }
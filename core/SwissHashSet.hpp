@@ -0,0 +1,433 @@
+// SwissHashSet.hpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+//
+// A SwissHashSet is an implementation of a Set that is an open-addressing
+// hash table in the style of the "Swiss table."  Rather than a linked list
+// per array cell, every element lives directly in a flat array of slots,
+// and a parallel array holds one control byte per slot.  A control byte
+// is either EMPTY or a 7-bit tag taken from the element's hash.
+//
+// Slots are grouped sixteen at a time.  A lookup hashes the element once,
+// picks a starting group, and compares all sixteen control bytes in that
+// group against the tag with a single SSE2 comparison.  Only slots whose
+// tag matches have their element compared, so a miss almost never touches
+// the slot array at all; it ends as soon as a group containing an EMPTY
+// byte is reached.  Because elements are never removed from a Set, there
+// is no need for tombstones.
+//
+// The capacity is always a power of two (and a multiple of the group
+// width), and the table doubles whenever it would become more than 7/8
+// full.
+
+#ifndef SWISSHASHSET_HPP
+#define SWISSHASHSET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include "HashMixing.hpp"
+#include "HasherTraits.hpp"
+#include "Set.hpp"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+
+
+namespace impl_
+{
+	// A SwissGroup is a view of sixteen consecutive control bytes.  match()
+	// returns a bitmask with bit i set when control byte i equals the tag;
+	// matchEmpty() does the same for EMPTY control bytes.
+	class SwissGroup
+	{
+	public:
+		static constexpr unsigned int WIDTH = 16;
+		static constexpr unsigned char EMPTY = 0x80;
+
+		explicit SwissGroup(const unsigned char* control) noexcept
+			: control{control}
+		{
+		}
+
+		std::uint32_t match(unsigned char tag) const noexcept
+		{
+#ifdef __SSE2__
+			__m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(control));
+			__m128i tags = _mm_set1_epi8(static_cast<char>(tag));
+			return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, tags)));
+#else
+			std::uint32_t mask = 0;
+			for(unsigned int i = 0; i < WIDTH; i++)
+			{
+				if(control[i] == tag)
+					mask |= 1u << i;
+			}
+			return mask;
+#endif
+		}
+
+		std::uint32_t matchEmpty() const noexcept
+		{
+			return match(EMPTY);
+		}
+
+	private:
+		const unsigned char* control;
+	};
+
+
+	inline unsigned int SwissHashSet__lowestBit(std::uint32_t mask) noexcept
+	{
+		return static_cast<unsigned int>(__builtin_ctz(mask));
+	}
+}
+
+
+
+template <typename ElementType, typename Hasher = std::function<unsigned int(const ElementType&)>>
+class SwissHashSet : public Set<ElementType>
+{
+public:
+	// The number of slots in a SwissHashSet before anything has been
+	// added to it.
+	static constexpr unsigned int DEFAULT_CAPACITY = 16;
+
+	// A HashFunction is a function that takes a reference to a const
+	// ElementType and returns an unsigned int.  As in HashSet, this is
+	// the default Hasher; a function object type can be used instead.
+	using HashFunction = std::function<unsigned int(const ElementType&)>;
+
+public:
+	// Initializes a SwissHashSet to be empty, so that it will use the
+	// given hasher whenever it needs to hash an element.
+	explicit SwissHashSet(Hasher hashFunction);
+
+	// Initializes a SwissHashSet to be empty, hashing with a
+	// default-constructed Hasher, which only a function object type can
+	// be (see HashSet).
+	template <typename DefaultHasher = Hasher, typename = std::enable_if_t<impl_::CAN_DEFAULT_HASHER<DefaultHasher>>>
+	SwissHashSet();
+
+	// Cleans up the SwissHashSet so that it leaks no memory.
+	virtual ~SwissHashSet() noexcept;
+
+	// Initializes a new SwissHashSet to be a copy of an existing one.
+	SwissHashSet(const SwissHashSet& s);
+
+	// Initializes a new SwissHashSet whose contents are moved from an
+	// expiring one.
+	SwissHashSet(SwissHashSet&& s) noexcept;
+
+	// Assigns an existing SwissHashSet into another.
+	SwissHashSet& operator=(const SwissHashSet& s);
+
+	// Assigns an expiring SwissHashSet into another.
+	SwissHashSet& operator=(SwissHashSet&& s) noexcept;
+
+
+	virtual bool isImplemented() const noexcept override;
+
+
+	// add() adds an element to the set.  If the element is already in the
+	// set, this function has no effect.  This function doubles the capacity
+	// when the table would become more than 7/8 full, in which case it
+	// runs in linear time; otherwise, it runs in constant time (assuming
+	// a good hash function).
+	virtual void add(const ElementType& element) override;
+
+
+	// contains() returns true if the given element is already in the set,
+	// false otherwise.  This function runs in constant time (assuming a
+	// good hash function).
+	virtual bool contains(const ElementType& element) const override;
+
+
+	// size() returns the number of elements in the set.
+	virtual std::size_t size() const noexcept override;
+
+
+	// reserve() grows the table, if necessary, so that expectedSize
+	// elements fit without any further growth.
+	virtual void reserve(std::size_t expectedSize) override;
+
+
+	// capacity() returns the number of slots in the table.
+	std::size_t capacity() const noexcept;
+
+
+private:
+	Hasher hashFunction;
+	std::size_t setsize;
+	std::size_t slotcount;
+	unsigned char* control;
+	ElementType* slots;
+
+	std::uint64_t hashOf(const ElementType& element) const;
+	bool findSlot(const ElementType& element, std::uint64_t hash, std::size_t& slot) const;
+	void placeElement(ElementType&& element, std::uint64_t hash);
+	void allocateTable(std::size_t newSlotCount);
+	void destroyTable() noexcept;
+	void copyTable(const SwissHashSet& s);
+	void rehash(std::size_t newSlotCount);
+};
+
+
+
+template <typename ElementType, typename Hasher>
+SwissHashSet<ElementType, Hasher>::SwissHashSet(Hasher hashFunction)
+	: hashFunction{hashFunction}, setsize{0}, slotcount{0}, control{nullptr}, slots{nullptr}
+{
+	allocateTable(DEFAULT_CAPACITY);
+}
+
+
+template <typename ElementType, typename Hasher>
+template <typename DefaultHasher, typename>
+SwissHashSet<ElementType, Hasher>::SwissHashSet()
+	: SwissHashSet{Hasher{}}
+{
+}
+
+
+template <typename ElementType, typename Hasher>
+SwissHashSet<ElementType, Hasher>::~SwissHashSet() noexcept
+{
+	destroyTable();
+}
+
+
+template <typename ElementType, typename Hasher>
+SwissHashSet<ElementType, Hasher>::SwissHashSet(const SwissHashSet& s)
+	: hashFunction{s.hashFunction}, setsize{0}, slotcount{0}, control{nullptr}, slots{nullptr}
+{
+	copyTable(s);
+}
+
+
+template <typename ElementType, typename Hasher>
+SwissHashSet<ElementType, Hasher>::SwissHashSet(SwissHashSet&& s) noexcept
+	: hashFunction{s.hashFunction}, setsize{s.setsize}, slotcount{s.slotcount},
+	  control{s.control}, slots{s.slots}
+{
+	s.setsize = 0;
+	s.slotcount = 0;
+	s.control = nullptr;
+	s.slots = nullptr;
+}
+
+
+template <typename ElementType, typename Hasher>
+SwissHashSet<ElementType, Hasher>& SwissHashSet<ElementType, Hasher>::operator=(const SwissHashSet& s)
+{
+	if(this != &s)
+	{
+		destroyTable();
+		hashFunction = s.hashFunction;
+		copyTable(s);
+	}
+	return *this;
+}
+
+
+template <typename ElementType, typename Hasher>
+SwissHashSet<ElementType, Hasher>& SwissHashSet<ElementType, Hasher>::operator=(SwissHashSet&& s) noexcept
+{
+	std::swap(hashFunction, s.hashFunction);
+	std::swap(setsize, s.setsize);
+	std::swap(slotcount, s.slotcount);
+	std::swap(control, s.control);
+	std::swap(slots, s.slots);
+	return *this;
+}
+
+
+template <typename ElementType, typename Hasher>
+bool SwissHashSet<ElementType, Hasher>::isImplemented() const noexcept
+{
+	return true;
+}
+
+
+template <typename ElementType, typename Hasher>
+void SwissHashSet<ElementType, Hasher>::add(const ElementType& element)
+{
+	std::uint64_t hash = hashOf(element);
+	std::size_t slot;
+	if(findSlot(element, hash, slot))
+		return;
+
+	if(slotcount == 0 || (setsize + 1) > slotcount / 8 * 7)
+		rehash(slotcount == 0 ? DEFAULT_CAPACITY : slotcount * 2);
+
+	placeElement(ElementType{element}, hash);
+	setsize++;
+}
+
+
+template <typename ElementType, typename Hasher>
+bool SwissHashSet<ElementType, Hasher>::contains(const ElementType& element) const
+{
+	std::size_t slot;
+	return findSlot(element, hashOf(element), slot);
+}
+
+
+template <typename ElementType, typename Hasher>
+std::size_t SwissHashSet<ElementType, Hasher>::size() const noexcept
+{
+	return setsize;
+}
+
+
+template <typename ElementType, typename Hasher>
+void SwissHashSet<ElementType, Hasher>::reserve(std::size_t expectedSize)
+{
+	std::size_t newSlotCount = DEFAULT_CAPACITY;
+	while(newSlotCount / 8 * 7 < expectedSize)
+		newSlotCount *= 2;
+	if(newSlotCount > slotcount)
+		rehash(newSlotCount);
+}
+
+
+template <typename ElementType, typename Hasher>
+std::size_t SwissHashSet<ElementType, Hasher>::capacity() const noexcept
+{
+	return slotcount;
+}
+
+
+template <typename ElementType, typename Hasher>
+std::uint64_t SwissHashSet<ElementType, Hasher>::hashOf(const ElementType& element) const
+{
+	//mix so that both the group index and the 7-bit tag are well distributed
+	return mixHash(hashFunction(element));
+}
+
+
+template <typename ElementType, typename Hasher>
+bool SwissHashSet<ElementType, Hasher>::findSlot(const ElementType& element, std::uint64_t hash, std::size_t& slot) const
+{
+	if(slotcount == 0) return false;
+
+	std::size_t groupmask = slotcount / impl_::SwissGroup::WIDTH - 1;
+	std::size_t group = static_cast<std::size_t>(hash >> 7) & groupmask;
+	unsigned char tag = static_cast<unsigned char>(hash & 0x7F);
+
+	//probe groups triangularly; this visits every group once when the
+	//group count is a power of two
+	for(std::size_t step = 1; step <= groupmask + 1; step++)
+	{
+		std::size_t base = group * impl_::SwissGroup::WIDTH;
+		impl_::SwissGroup controlgroup{control + base};
+
+		for(std::uint32_t match = controlgroup.match(tag); match != 0; match &= match - 1)
+		{
+			std::size_t candidate = base + impl_::SwissHashSet__lowestBit(match);
+			if(slots[candidate] == element)
+			{
+				slot = candidate;
+				return true;
+			}
+		}
+
+		//elements are never removed, so an EMPTY byte ends the probe sequence
+		if(controlgroup.matchEmpty() != 0)
+			return false;
+
+		group = (group + step) & groupmask;
+	}
+	return false;
+}
+
+
+template <typename ElementType, typename Hasher>
+void SwissHashSet<ElementType, Hasher>::placeElement(ElementType&& element, std::uint64_t hash)
+{
+	std::size_t groupmask = slotcount / impl_::SwissGroup::WIDTH - 1;
+	std::size_t group = static_cast<std::size_t>(hash >> 7) & groupmask;
+
+	for(std::size_t step = 1; ; step++)
+	{
+		std::size_t base = group * impl_::SwissGroup::WIDTH;
+		std::uint32_t empty = impl_::SwissGroup{control + base}.matchEmpty();
+		if(empty != 0)
+		{
+			std::size_t slot = base + impl_::SwissHashSet__lowestBit(empty);
+			control[slot] = static_cast<unsigned char>(hash & 0x7F);
+			slots[slot] = std::move(element);
+			return;
+		}
+		group = (group + step) & groupmask;
+	}
+}
+
+
+template <typename ElementType, typename Hasher>
+void SwissHashSet<ElementType, Hasher>::allocateTable(std::size_t newSlotCount)
+{
+	control = new unsigned char[newSlotCount];
+	slots = new ElementType[newSlotCount];
+	slotcount = newSlotCount;
+	for(std::size_t i = 0; i < slotcount; i++)
+		control[i] = impl_::SwissGroup::EMPTY;
+}
+
+
+template <typename ElementType, typename Hasher>
+void SwissHashSet<ElementType, Hasher>::destroyTable() noexcept
+{
+	delete[] control;
+	delete[] slots;
+	control = nullptr;
+	slots = nullptr;
+	slotcount = 0;
+	setsize = 0;
+}
+
+
+template <typename ElementType, typename Hasher>
+void SwissHashSet<ElementType, Hasher>::copyTable(const SwissHashSet& s)
+{
+	if(s.slotcount == 0) return;
+	allocateTable(s.slotcount);
+	for(std::size_t i = 0; i < slotcount; i++)
+	{
+		control[i] = s.control[i];
+		if(control[i] != impl_::SwissGroup::EMPTY)
+			slots[i] = s.slots[i];
+	}
+	setsize = s.setsize;
+}
+
+
+template <typename ElementType, typename Hasher>
+void SwissHashSet<ElementType, Hasher>::rehash(std::size_t newSlotCount)
+{
+	unsigned char* old_control = control;
+	ElementType* old_slots = slots;
+	std::size_t old_slotcount = slotcount;
+
+	allocateTable(newSlotCount);
+	for(std::size_t i = 0; i < old_slotcount; i++)
+	{
+		if(old_control[i] != impl_::SwissGroup::EMPTY)
+		{
+			std::uint64_t hash = hashOf(old_slots[i]);
+			placeElement(std::move(old_slots[i]), hash);
+		}
+	}
+
+	delete[] old_control;
+	delete[] old_slots;
+}
+
+
+
+#endif // SWISSHASHSET_HPP
@@ -0,0 +1,201 @@
+// BTreeBenchmark.cpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+//
+// Compares BTreeSet, at a few node sizes, with AVLSet and HashSet: how
+// much memory each takes, and how long a lookup takes when it finds its
+// word (a hit) and when it doesn't (a miss), timed separately.  This is
+// done on the words in a word file and on a large synthetic dictionary,
+// whose misses are other synthetic words.
+//
+// The sets are built with addAll(), so AVLSet and BTreeSet are built in
+// bulk (BTreeSet's with full nodes); one BTreeSet is also built with
+// add(), one word at a time, whose nodes are only partly full.  AVLSet is
+// timed both as a tree and, built to freeze into an array, after freeze()
+// has laid it out in one.
+// Memory is measured as in the INTERNING benchmark (see allocatedBytes()).
+// Each lookup workload is run several times, and the fastest run is
+// reported.
+
+#include <algorithm>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "AVLSet.hpp"
+#include "BTreeSet.hpp"
+#include "BenchmarkSupport.hpp"
+#include "Benchmarks.hpp"
+#include "HashSet.hpp"
+#include "KeyStorage.hpp"
+#include "NodeAllocator.hpp"
+#include "Stopwatch.hpp"
+#include "StringHashing.hpp"
+
+
+
+namespace
+{
+    constexpr std::size_t LOOKUP_COUNT = 1000000;
+    constexpr unsigned int ROUNDS = 3;
+
+    volatile std::size_t foundSink;
+
+
+    enum class Build
+    {
+        AllAtOnce,
+        OneAtATime,
+        AllAtOnceThenFreeze
+    };
+
+
+    double fastestLookups(const Set<std::string>& wordSet, const std::vector<std::string>& lookups)
+    {
+        double fastest = 0.0;
+
+        for (unsigned int round = 0; round < ROUNDS; ++round)
+        {
+            Stopwatch stopwatch;
+            std::size_t found = 0;
+
+            stopwatch.start();
+
+            for (const std::string& lookup : lookups)
+            {
+                found += wordSet.contains(lookup);
+            }
+
+            stopwatch.stop();
+            foundSink = found;
+
+            double time = nanosecondsPer(stopwatch.lastDuration(), lookups.size());
+            fastest = (round == 0 ? time : std::min(fastest, time));
+        }
+
+        return fastest;
+    }
+
+
+    // An AVLSet only lays its keys out in an array when it's frozen if
+    // it's asked to when it's constructed; the other sets are built as
+    // usual.
+    template <typename SetType>
+    SetType makeSet(Build build)
+    {
+        if constexpr (std::is_same_v<SetType, AVLSet<std::string>>)
+        {
+            return SetType{true, build == Build::AllAtOnceThenFreeze};
+        }
+        else
+        {
+            return SetType{};
+        }
+    }
+
+
+    template <typename SetType>
+    void report(
+        const std::string& name, Build build, const std::vector<std::string>& words,
+        const std::vector<std::string>& hits, const std::vector<std::string>& misses)
+    {
+        std::size_t allocatedBefore = allocatedBytes();
+
+        SetType wordSet = makeSet<SetType>(build);
+
+        if (build == Build::OneAtATime)
+        {
+            for (const std::string& word : words)
+            {
+                wordSet.add(word);
+            }
+        }
+        else
+        {
+            wordSet.addAll(words);
+        }
+
+        if (build == Build::AllAtOnceThenFreeze)
+        {
+            wordSet.freeze();
+        }
+
+        std::size_t allocatedAfter = allocatedBytes();
+        std::size_t bytes = allocatedAfter > allocatedBefore ? allocatedAfter - allocatedBefore : 0;
+
+        std::cout << std::left << std::setw(22) << name << std::right
+                  << std::fixed << std::setprecision(1)
+                  << std::setw(10) << bytes / 1048576.0
+                  << std::setw(12) << static_cast<double>(bytes) / words.size()
+                  << std::setw(10) << fastestLookups(wordSet, hits)
+                  << std::setw(11) << fastestLookups(wordSet, misses)
+                  << std::endl;
+    }
+
+
+    void reportAll(const std::vector<std::string>& words, const std::vector<std::string>& missSource)
+    {
+        std::mt19937_64 random{46};
+        std::uniform_int_distribution<std::size_t> wordIndex{0, words.size() - 1};
+        std::uniform_int_distribution<std::size_t> missIndex{0, missSource.size() - 1};
+
+        std::vector<std::string> hits;
+        std::vector<std::string> misses;
+        hits.reserve(LOOKUP_COUNT);
+        misses.reserve(LOOKUP_COUNT);
+
+        for (std::size_t i = 0; i < LOOKUP_COUNT; ++i)
+        {
+            hits.push_back(words[wordIndex(random)]);
+            misses.push_back(missSource[missIndex(random)]);
+        }
+
+        std::cout << "Words: " << words.size() << std::endl;
+        std::cout << "Structure                   MiB  Bytes/word  Hit (ns)  Miss (ns)" << std::endl;
+
+        report<HashSet<std::string, WordMixHash, HeapNodeAllocator, MaskedIndexing>>(
+            "HASH WORDMIX MASKED", Build::AllAtOnce, words, hits, misses);
+        report<AVLSet<std::string>>("AVL", Build::AllAtOnce, words, hits, misses);
+        report<AVLSet<std::string>>("AVL FROZEN", Build::AllAtOnceThenFreeze, words, hits, misses);
+        report<BTreeSet<std::string, HeapNodeAllocator, DirectKeys, 256>>(
+            "BTREE 256", Build::AllAtOnce, words, hits, misses);
+        report<BTreeSet<std::string, HeapNodeAllocator, DirectKeys, 512>>(
+            "BTREE 512", Build::AllAtOnce, words, hits, misses);
+        report<BTreeSet<std::string, HeapNodeAllocator, DirectKeys, 1024>>(
+            "BTREE 1024", Build::AllAtOnce, words, hits, misses);
+        report<BTreeSet<std::string, HeapNodeAllocator, DirectKeys, 512>>(
+            "BTREE 512 ONE-BY-ONE", Build::OneAtATime, words, hits, misses);
+        report<BTreeSet<std::string, HeapNodeAllocator, InternedKeys, 512>>(
+            "BTREE 512 INTERNED", Build::AllAtOnceThenFreeze, words, hits, misses);
+
+        std::cout << std::endl;
+    }
+}
+
+
+
+void runBTreeBenchmark()
+{
+    std::string wordFilePath = readLine();
+    std::size_t syntheticWordCount = std::stoull(readLine());
+
+    std::vector<std::string> words = readWords(wordFilePath);
+    reportAll(words, makeMisspellings(words));
+
+    std::vector<std::string> syntheticWords;
+    std::vector<std::string> syntheticMisses;
+    syntheticWords.reserve(syntheticWordCount);
+    syntheticMisses.reserve(syntheticWordCount);
+
+    for (std::size_t i = 0; i < syntheticWordCount; ++i)
+    {
+        syntheticWords.push_back(syntheticWordAt(i));
+        syntheticMisses.push_back(syntheticWordAt(syntheticWordCount + i));
+    }
+
+    reportAll(syntheticWords, syntheticMisses);
+}
@@ -0,0 +1,125 @@
+// BenchmarkSupport.cpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <unistd.h>
+#include "BenchmarkSupport.hpp"
+#include "HashMixing.hpp"
+
+// mallinfo2() is glibc's; elsewhere allocatedBytes() falls back to the
+// resident set size, which needs only sysconf() from <unistd.h>
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+#include <malloc.h>
+#endif
+
+
+
+std::string readLine()
+{
+    std::string line;
+    std::getline(std::cin, line);
+    return line;
+}
+
+
+std::vector<std::string> readWords(const std::string& wordFilePath)
+{
+    std::ifstream wordFile{wordFilePath};
+    std::vector<std::string> words;
+    std::string word;
+
+    while (std::getline(wordFile, word))
+    {
+        std::transform(
+            word.begin(), word.end(), word.begin(),
+            [](auto c) { return std::toupper(c); });
+
+        word.erase(
+            std::remove_if(
+                word.begin(), word.end(),
+                [](auto c) { return c == '\r' || c == '\n'; }),
+            word.end());
+
+        words.push_back(word);
+    }
+
+    return words;
+}
+
+
+std::vector<std::string> makeMisspellings(const std::vector<std::string>& words)
+{
+    std::vector<std::string> misspellings;
+    misspellings.reserve(words.size());
+
+    for (const std::string& word : words)
+    {
+        std::string misspelling = word;
+
+        if (!misspelling.empty())
+        {
+            char& c = misspelling[misspelling.length() / 2];
+            c = (c == 'Z') ? 'Q' : 'Z';
+        }
+
+        misspellings.push_back(misspelling);
+    }
+
+    return misspellings;
+}
+
+
+std::string syntheticWordAt(std::size_t index)
+{
+    std::uint64_t hash = mixHash(index + 1);
+    std::string word(5 + hash % 16, 'A');
+    hash /= 16;
+
+    for (std::size_t i = 0; i < word.length(); ++i)
+    {
+        // a 64-bit hash only has enough randomness for 13 letters, so
+        // it's stirred again partway through the longer words
+        if (i == 12)
+        {
+            hash = mixHash(hash + index);
+        }
+
+        word[i] = static_cast<char>('A' + hash % 26);
+        hash /= 26;
+    }
+
+    return word;
+}
+
+
+double nanosecondsPer(double microseconds, double operations)
+{
+    return operations > 0 ? microseconds * 1000.0 / operations : 0.0;
+}
+
+
+
+std::size_t allocatedBytes()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+#else
+    std::ifstream statm{"/proc/self/statm"};
+    std::size_t totalPages = 0;
+    std::size_t residentPages = 0;
+
+    if (!(statm >> totalPages >> residentPages))
+    {
+        return 0;
+    }
+
+    return residentPages * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
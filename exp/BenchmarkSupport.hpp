@@ -0,0 +1,54 @@
+// BenchmarkSupport.hpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+//
+// Helpers shared by the benchmarks in the "exp" directory.
+
+#ifndef BENCHMARKSUPPORT_HPP
+#define BENCHMARKSUPPORT_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+
+
+// Reads one line from standard input, the same way SpellCheckShell does.
+std::string readLine();
+
+
+// Reads the words in a word file, normalized the same way WordSetLoader
+// normalizes them (uppercased, with line endings removed).
+std::vector<std::string> readWords(const std::string& wordFilePath);
+
+
+// Returns one misspelling of each of the given words, made by replacing
+// a letter the same way WordChecker::findSuggestions does.  Almost none
+// of them are words themselves, so they make a good supply of misses.
+std::vector<std::string> makeMisspellings(const std::vector<std::string>& words);
+
+
+// Returns the synthetic word with the given index: 5 to 20 letters, chosen
+// by hashing the index, so that, as in a real dictionary, most fit in a
+// std::string's own small-string buffer but the longest ones need a heap
+// block of their own.  Different indexes almost always give different
+// words.
+std::string syntheticWordAt(std::size_t index);
+
+
+// Returns the number of nanoseconds per operation, given a duration in
+// microseconds (as reported by Stopwatch) and a number of operations.
+double nanosecondsPer(double microseconds, double operations);
+
+
+// Returns the number of bytes currently allocated from the heap, counting
+// the allocator's own overhead per allocation.  This needs glibc; on other
+// systems, it returns the process's resident memory instead, which is
+// coarser, since memory the allocator has kept for reuse still counts.
+std::size_t allocatedBytes();
+
+
+
+#endif // BENCHMARKSUPPORT_HPP
+
@@ -0,0 +1,102 @@
+// Benchmarks.hpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+//
+// The benchmarks that can be run from expmain.  Each one reads whatever
+// else it needs (such as the path to a word file) from standard input,
+// one line at a time, and writes its results to standard output.
+
+#ifndef BENCHMARKS_HPP
+#define BENCHMARKS_HPP
+
+
+
+// CONCURRENT: N reader threads look up words in a shared
+// ConcurrentHashSet while one writer thread adds new ones.
+// Input: the path to a word file.
+void runConcurrentLookupBenchmark();
+
+
+// PERFECT: load time, lookup latency and memory use of PerfectHashSet,
+// compared with HashSet and SwissHashSet.
+// Input: the path to a word file.
+void runPerfectHashBenchmark();
+
+
+// HASHING: throughput of each string hash function on the words in a word
+// file and on synthetic keys of several lengths, and the chain lengths
+// and probe counts of a HashSet using each one.
+// Input: the path to a word file.
+void runHashQualityBenchmark();
+
+
+// LATENCY: the distribution (median, p99, p99.9, maximum) of the time
+// taken by individual lookups in CuckooHashSet and in the other hash
+// tables, on a shuffled mix of words and misspellings.
+// Input: the path to a word file.
+void runLookupLatencyBenchmark();
+
+
+// SCALING: load time, memory per key and lookup time of the hash tables
+// and AVLSet, on synthetic 64-bit keys, at sizes from a million keys up.
+// Input: the largest number of keys to load.
+void runScalingBenchmark();
+
+
+// HUGEPAGES: lookup throughput and data TLB misses of a HashSet holding a
+// large synthetic dictionary, with and without huge page backing.
+// Input: the number of words in the dictionary.
+void runHugePageBenchmark();
+
+
+// INTERNING: memory use and lookup time of HashSet and AVLSet with their
+// words kept in each node and with them kept in a StringPool, on the
+// words in a word file and on a large synthetic dictionary.
+// Input: the path to a word file, then the number of synthetic words.
+void runInterningBenchmark();
+
+
+// FROZEN: lookup time and findSuggestions() time of AVLSet as a linked
+// tree and after freeze() has laid it out in an Eytzinger array.
+// Input: the path to a word file.
+void runFrozenTreeBenchmark();
+
+
+// PREFIX: the time taken by each top-k prefix completion with AVLSet's
+// visitPrefix(), compared with walking the whole set with inorder().
+// Input: the path to a word file.
+void runPrefixCompletionBenchmark();
+
+
+// BTREE: memory use, and lookup time for hits and for misses, of BTreeSet
+// at a few node sizes, compared with AVLSet and HashSet, on the words in
+// a word file and on a large synthetic dictionary.
+// Input: the path to a word file, then the number of synthetic words.
+void runBTreeBenchmark();
+
+
+// SNAPSHOT: the time and memory taken to copy a loaded AVLSet and a
+// PersistentAVLSet, and then to add words to the copy, and the lookup
+// time of each.
+// Input: the path to a word file.
+void runSnapshotBenchmark();
+
+
+// TRAVERSAL: the time taken to dump every word in an AVLSet into a string
+// by each of its traversals, with a VisitFunction, with a lambda, and by
+// iterating over it.
+// Input: the path to a word file.
+void runTraversalBenchmark();
+
+
+// COMPACT: memory per word and lookup time (hits and misses) of
+// CompactAVLSet, in both node layouts, compared with AVLSet, on a word
+// file and on a synthetic dictionary.
+// Input: the path to a word file, then the number of synthetic words.
+void runCompactAVLBenchmark();
+
+
+
+#endif // BENCHMARKS_HPP
+
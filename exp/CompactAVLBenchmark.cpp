@@ -0,0 +1,193 @@
+// CompactAVLBenchmark.cpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+//
+// Compares CompactAVLSet, in both of its node layouts, with AVLSet, whose
+// nodes are linked by pointers: how much memory each takes per word, and
+// how long a lookup takes when it finds its word (a hit) and when it
+// doesn't (a miss), timed separately.  As in the BTREE benchmark, this is
+// done on the words in a word file and on a large synthetic dictionary.
+//
+// The sets are built with addAll(), in bulk, and then frozen, which only
+// gives back room they set aside and haven't used; the AVLSets aren't
+// asked to freeze into an array, since their lookups would then search
+// it instead of the tree, and the tree is the layout being compared.  A second build of each adds the words one
+// at a time, in random order, so its nodes are in no particular order in
+// memory.
+// Memory is measured as in the INTERNING benchmark (see allocatedBytes()),
+// so it includes the characters of words too long to fit in a string.
+
+#include <algorithm>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "AVLSet.hpp"
+#include "BenchmarkSupport.hpp"
+#include "Benchmarks.hpp"
+#include "CompactAVLSet.hpp"
+#include "KeyStorage.hpp"
+#include "NodeAllocator.hpp"
+#include "Stopwatch.hpp"
+
+
+
+namespace
+{
+    constexpr std::size_t LOOKUP_COUNT = 1000000;
+    constexpr unsigned int ROUNDS = 3;
+
+    volatile std::size_t foundSink;
+
+
+    enum class Build
+    {
+        AllAtOnce,
+        OneAtATime
+    };
+
+
+    double fastestLookups(const Set<std::string>& wordSet, const std::vector<std::string>& lookups)
+    {
+        double fastest = 0.0;
+
+        for (unsigned int round = 0; round < ROUNDS; ++round)
+        {
+            Stopwatch stopwatch;
+            std::size_t found = 0;
+
+            stopwatch.start();
+
+            for (const std::string& lookup : lookups)
+            {
+                found += wordSet.contains(lookup);
+            }
+
+            stopwatch.stop();
+            foundSink = found;
+
+            double time = nanosecondsPer(stopwatch.lastDuration(), lookups.size());
+            fastest = (round == 0 ? time : std::min(fastest, time));
+        }
+
+        return fastest;
+    }
+
+
+    template <typename SetType>
+    void report(
+        const std::string& name, Build build, const std::vector<std::string>& words,
+        const std::vector<std::string>& shuffledWords,
+        const std::vector<std::string>& hits, const std::vector<std::string>& misses)
+    {
+        std::size_t allocatedBefore = allocatedBytes();
+
+        SetType wordSet;
+
+        if (build == Build::OneAtATime)
+        {
+            for (const std::string& word : shuffledWords)
+            {
+                wordSet.add(word);
+            }
+        }
+        else
+        {
+            wordSet.addAll(words, true);
+        }
+
+        wordSet.freeze();
+
+        std::size_t allocatedAfter = allocatedBytes();
+        std::size_t bytes = allocatedAfter > allocatedBefore ? allocatedAfter - allocatedBefore : 0;
+
+        std::cout << std::left << std::setw(30) << name << std::right
+                  << std::fixed << std::setprecision(1)
+                  << std::setw(8) << bytes / 1048576.0
+                  << std::setw(12) << static_cast<double>(bytes) / words.size()
+                  << std::setw(10) << fastestLookups(wordSet, hits)
+                  << std::setw(11) << fastestLookups(wordSet, misses)
+                  << std::endl;
+    }
+
+
+    void reportAll(const std::vector<std::string>& words, const std::vector<std::string>& missSource)
+    {
+        std::mt19937_64 random{46};
+        std::uniform_int_distribution<std::size_t> wordIndex{0, words.size() - 1};
+        std::uniform_int_distribution<std::size_t> missIndex{0, missSource.size() - 1};
+
+        std::vector<std::string> hits;
+        std::vector<std::string> misses;
+        hits.reserve(LOOKUP_COUNT);
+        misses.reserve(LOOKUP_COUNT);
+
+        for (std::size_t i = 0; i < LOOKUP_COUNT; ++i)
+        {
+            hits.push_back(words[wordIndex(random)]);
+            misses.push_back(missSource[missIndex(random)]);
+        }
+
+        // the words are sorted, and made unique, so that addAll() can take
+        // them as they are
+        std::vector<std::string> sortedWords{words};
+        std::sort(sortedWords.begin(), sortedWords.end());
+        sortedWords.erase(std::unique(sortedWords.begin(), sortedWords.end()), sortedWords.end());
+
+        std::vector<std::string> shuffledWords{sortedWords};
+        std::shuffle(shuffledWords.begin(), shuffledWords.end(), random);
+
+        std::cout << "Words: " << sortedWords.size() << std::endl;
+        std::cout << "Structure                          MiB  Bytes/word  Hit (ns)  Miss (ns)" << std::endl;
+
+        report<AVLSet<std::string>>(
+            "AVL", Build::AllAtOnce, sortedWords, shuffledWords, hits, misses);
+        report<AVLSet<std::string, ArenaNodeAllocator>>(
+            "AVL ARENA", Build::AllAtOnce, sortedWords, shuffledWords, hits, misses);
+        report<CompactAVLSet<std::string, DirectKeys, InterleavedNodes>>(
+            "AVL COMPACT", Build::AllAtOnce, sortedWords, shuffledWords, hits, misses);
+        report<CompactAVLSet<std::string, DirectKeys, SplitNodes>>(
+            "AVL COMPACT SPLIT", Build::AllAtOnce, sortedWords, shuffledWords, hits, misses);
+        report<AVLSet<std::string, ArenaNodeAllocator, InternedKeys>>(
+            "AVL INTERNED ARENA", Build::AllAtOnce, sortedWords, shuffledWords, hits, misses);
+        report<CompactAVLSet<std::string, InternedKeys, InterleavedNodes>>(
+            "AVL COMPACT INTERNED", Build::AllAtOnce, sortedWords, shuffledWords, hits, misses);
+        report<CompactAVLSet<std::string, InternedKeys, SplitNodes>>(
+            "AVL COMPACT SPLIT INTERNED", Build::AllAtOnce, sortedWords, shuffledWords, hits, misses);
+        report<AVLSet<std::string>>(
+            "AVL ONE-BY-ONE", Build::OneAtATime, sortedWords, shuffledWords, hits, misses);
+        report<CompactAVLSet<std::string, DirectKeys, InterleavedNodes>>(
+            "AVL COMPACT ONE-BY-ONE", Build::OneAtATime, sortedWords, shuffledWords, hits, misses);
+        report<CompactAVLSet<std::string, DirectKeys, SplitNodes>>(
+            "AVL COMPACT SPLIT ONE-BY-ONE", Build::OneAtATime, sortedWords, shuffledWords, hits, misses);
+
+        std::cout << std::endl;
+    }
+}
+
+
+
+void runCompactAVLBenchmark()
+{
+    std::string wordFilePath = readLine();
+    std::size_t syntheticWordCount = std::stoull(readLine());
+
+    std::vector<std::string> words = readWords(wordFilePath);
+    reportAll(words, makeMisspellings(words));
+
+    std::vector<std::string> syntheticWords;
+    std::vector<std::string> syntheticMisses;
+    syntheticWords.reserve(syntheticWordCount);
+    syntheticMisses.reserve(syntheticWordCount);
+
+    for (std::size_t i = 0; i < syntheticWordCount; ++i)
+    {
+        syntheticWords.push_back(syntheticWordAt(i));
+        syntheticMisses.push_back(syntheticWordAt(syntheticWordCount + i));
+    }
+
+    reportAll(syntheticWords, syntheticMisses);
+}
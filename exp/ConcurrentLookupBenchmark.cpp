@@ -0,0 +1,158 @@
+// ConcurrentLookupBenchmark.cpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+//
+// Loads a word file into a ConcurrentHashSet, then, for each reader
+// thread count from 1 to MAX_READERS, runs that many threads calling
+// WordChecker::wordExists() (half on real words, half on misspellings)
+// for a fixed amount of time, while one writer thread keeps adding
+// "learned" words.  Reports lookup throughput for each thread count.
+
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "BenchmarkSupport.hpp"
+#include "Benchmarks.hpp"
+#include "ConcurrentHashSet.hpp"
+#include "Stopwatch.hpp"
+#include "StringHashing.hpp"
+#include "WordChecker.hpp"
+
+
+
+namespace
+{
+    constexpr unsigned int MAX_READERS = 32;
+    constexpr unsigned int RUN_MILLISECONDS = 250;
+
+
+    struct RunResult
+    {
+        double lookupsPerSecond;
+        unsigned long long wordsAdded;
+    };
+
+
+    RunResult runReaders(
+        ConcurrentHashSet<std::string, ProductHash>& wordSet,
+        const std::vector<std::string>& lookups,
+        unsigned int readerCount, unsigned long long& learnedCount)
+    {
+        std::atomic<bool> stop{false};
+        std::vector<unsigned long long> counts(readerCount, 0);
+        std::vector<std::thread> readers;
+
+        Stopwatch stopwatch;
+        stopwatch.start();
+
+        for (unsigned int r = 0; r < readerCount; ++r)
+        {
+            readers.emplace_back(
+                [&, r]()
+                {
+                    WordChecker checker{wordSet};
+                    std::size_t next = (lookups.size() / readerCount) * r;
+                    unsigned long long count = 0;
+
+                    while (!stop.load(std::memory_order_relaxed))
+                    {
+                        for (unsigned int i = 0; i < 256; ++i)
+                        {
+                            checker.wordExists(lookups[next]);
+                            next = (next + 1 == lookups.size()) ? 0 : next + 1;
+                        }
+
+                        count += 256;
+                    }
+
+                    counts[r] = count;
+                });
+        }
+
+        unsigned long long addedBefore = learnedCount;
+
+        std::thread writer{
+            [&]()
+            {
+                while (!stop.load(std::memory_order_relaxed))
+                {
+                    wordSet.add("LEARNED" + std::to_string(learnedCount++));
+                }
+            }};
+
+        std::this_thread::sleep_for(std::chrono::milliseconds{RUN_MILLISECONDS});
+        stop.store(true);
+
+        for (std::thread& reader : readers)
+        {
+            reader.join();
+        }
+
+        writer.join();
+        stopwatch.stop();
+
+        unsigned long long total = 0;
+
+        for (unsigned long long count : counts)
+        {
+            total += count;
+        }
+
+        return RunResult{
+            total / (stopwatch.lastDuration() / 1000000.0),
+            learnedCount - addedBefore};
+    }
+}
+
+
+
+void runConcurrentLookupBenchmark()
+{
+    std::string wordFilePath = readLine();
+
+    std::vector<std::string> words = readWords(wordFilePath);
+    std::vector<std::string> misspellings = makeMisspellings(words);
+
+    std::vector<std::string> lookups;
+
+    for (std::size_t i = 0; i < words.size(); ++i)
+    {
+        lookups.push_back(words[i]);
+        lookups.push_back(misspellings[i]);
+    }
+
+    ConcurrentHashSet<std::string, ProductHash> wordSet;
+
+    for (const std::string& word : words)
+    {
+        wordSet.add(word);
+    }
+
+    std::cout << "Loaded " << wordSet.size() << " words from " << wordFilePath << std::endl;
+    std::cout << "Hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+    std::cout << std::endl;
+    std::cout << "Readers    Lookups/sec    Per reader    Words added" << std::endl;
+
+    unsigned long long learnedCount = 0;
+
+    for (unsigned int readers = 1; readers <= MAX_READERS; readers *= 2)
+    {
+        RunResult result = runReaders(wordSet, lookups, readers, learnedCount);
+
+        std::cout << std::right << std::setw(7) << readers
+                  << std::fixed << std::setprecision(0)
+                  << std::setw(15) << result.lookupsPerSecond
+                  << std::setw(14) << result.lookupsPerSecond / readers
+                  << std::setw(15) << result.wordsAdded
+                  << std::endl;
+    }
+
+    std::cout << std::endl;
+    std::cout << "Final size: " << wordSet.size() << std::endl;
+}
+
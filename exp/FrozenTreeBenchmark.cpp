@@ -0,0 +1,161 @@
+// FrozenTreeBenchmark.cpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+//
+// Compares an AVLSet searched as a tree of linked nodes with the same set
+// after freeze() has laid its keys out in an Eytzinger array.  Two
+// workloads are timed: random lookups (half words, half misspellings),
+// and WordChecker::findSuggestions() on misspellings, which looks up a few
+// hundred closely related candidates for each one.  Each is run several
+// times, and the fastest run is reported, since the slower ones mostly
+// measure whatever else the machine was doing.
+
+#include <algorithm>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "AVLSet.hpp"
+#include "BenchmarkSupport.hpp"
+#include "Benchmarks.hpp"
+#include "KeyStorage.hpp"
+#include "NodeAllocator.hpp"
+#include "Stopwatch.hpp"
+#include "WordChecker.hpp"
+
+
+
+namespace
+{
+    constexpr std::size_t LOOKUP_COUNT = 1000000;
+    constexpr std::size_t SUGGESTION_COUNT = 2000;
+    constexpr unsigned int ROUNDS = 5;
+
+    volatile std::size_t resultSink;
+
+
+    double fastestLookups(const Set<std::string>& wordSet, const std::vector<std::string>& lookups)
+    {
+        double fastest = 0.0;
+
+        for (unsigned int round = 0; round < ROUNDS; ++round)
+        {
+            Stopwatch stopwatch;
+            std::size_t found = 0;
+
+            stopwatch.start();
+
+            for (const std::string& lookup : lookups)
+            {
+                found += wordSet.contains(lookup);
+            }
+
+            stopwatch.stop();
+            resultSink = found;
+
+            double time = nanosecondsPer(stopwatch.lastDuration(), lookups.size());
+            fastest = (round == 0 ? time : std::min(fastest, time));
+        }
+
+        return fastest;
+    }
+
+
+    // Returns the fastest time, in microseconds, to find suggestions for
+    // one misspelling.
+    double fastestSuggestions(const Set<std::string>& wordSet, const std::vector<std::string>& misspellings)
+    {
+        WordChecker checker{wordSet};
+        double fastest = 0.0;
+
+        for (unsigned int round = 0; round < ROUNDS; ++round)
+        {
+            Stopwatch stopwatch;
+            std::size_t suggestions = 0;
+
+            stopwatch.start();
+
+            for (const std::string& misspelling : misspellings)
+            {
+                suggestions += checker.findSuggestions(misspelling).size();
+            }
+
+            stopwatch.stop();
+            resultSink = suggestions;
+
+            double time = stopwatch.lastDuration() / misspellings.size();
+            fastest = (round == 0 ? time : std::min(fastest, time));
+        }
+
+        return fastest;
+    }
+
+
+    template <typename SetType>
+    void report(
+        const std::string& name, const std::vector<std::string>& words,
+        const std::vector<std::string>& lookups, const std::vector<std::string>& misspellings)
+    {
+        SetType wordSet{true, true};
+
+        for (const std::string& word : words)
+        {
+            wordSet.add(word);
+        }
+
+        std::cout << std::left << std::setw(20) << name << std::right
+                  << std::fixed << std::setprecision(1)
+                  << std::setw(13) << fastestLookups(wordSet, lookups)
+                  << std::setw(16) << fastestSuggestions(wordSet, misspellings);
+
+        Stopwatch stopwatch;
+        stopwatch.start();
+        wordSet.freeze();
+        stopwatch.stop();
+
+        std::cout << std::setw(14) << fastestLookups(wordSet, lookups)
+                  << std::setw(16) << fastestSuggestions(wordSet, misspellings)
+                  << std::setw(15) << std::setprecision(0) << stopwatch.lastDuration()
+                  << std::endl;
+    }
+}
+
+
+
+void runFrozenTreeBenchmark()
+{
+    std::vector<std::string> words = readWords(readLine());
+    std::vector<std::string> misspellings = makeMisspellings(words);
+
+    std::mt19937_64 random{46};
+    std::uniform_int_distribution<std::size_t> index{0, words.size() - 1};
+
+    std::vector<std::string> lookups;
+    lookups.reserve(LOOKUP_COUNT);
+
+    for (std::size_t i = 0; i < LOOKUP_COUNT / 2; ++i)
+    {
+        lookups.push_back(words[index(random)]);
+        lookups.push_back(misspellings[index(random)]);
+    }
+
+    std::vector<std::string> suggestionInputs;
+
+    for (std::size_t i = 0; i < SUGGESTION_COUNT; ++i)
+    {
+        suggestionInputs.push_back(misspellings[index(random)]);
+    }
+
+    std::cout << "Words: " << words.size() << std::endl;
+    std::cout << std::endl;
+    std::cout << "                         --------- Tree ---------      -------- Frozen --------" << std::endl;
+    std::cout << "Structure             Lookup (ns)  Suggest (usec)   Lookup (ns)  Suggest (usec)  Freeze (usec)" << std::endl;
+
+    report<AVLSet<std::string>>("AVL", words, lookups, suggestionInputs);
+    report<AVLSet<std::string, ArenaNodeAllocator>>("AVL ARENA", words, lookups, suggestionInputs);
+    report<AVLSet<std::string, ArenaNodeAllocator, InternedKeys>>(
+        "AVL INTERNED ARENA", words, lookups, suggestionInputs);
+}
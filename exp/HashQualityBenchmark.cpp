@@ -0,0 +1,199 @@
+// HashQualityBenchmark.cpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+//
+// Measures each of the string hash functions in StringHashing.hpp two
+// ways: how fast it hashes (on the words in a word file, and on random
+// keys of several fixed lengths), and how well a HashSet using it spreads
+// its elements out (on the word file, and on sequentially numbered keys
+// like "KEY0000123", which share long prefixes and differ only slightly).
+
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "BenchmarkSupport.hpp"
+#include "Benchmarks.hpp"
+#include "HashSet.hpp"
+#include "KeyStorage.hpp"
+#include "NodeAllocator.hpp"
+#include "Stopwatch.hpp"
+#include "StringHashing.hpp"
+
+
+
+namespace
+{
+    constexpr unsigned int THROUGHPUT_BYTES = 64 << 20;
+    constexpr unsigned int SEQUENTIAL_KEYS = 200000;
+
+    volatile std::uint64_t hashSink;
+
+
+    std::vector<std::string> makeRandomKeys(std::size_t length, std::size_t count)
+    {
+        std::mt19937_64 random{length};
+        std::uniform_int_distribution<int> letter{'A', 'Z'};
+        std::vector<std::string> keys(count, std::string(length, ' '));
+
+        for (std::string& key : keys)
+        {
+            for (char& c : key)
+            {
+                c = static_cast<char>(letter(random));
+            }
+        }
+
+        return keys;
+    }
+
+
+    std::vector<std::string> makeSequentialKeys(std::size_t count)
+    {
+        std::vector<std::string> keys;
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            std::string number = std::to_string(i);
+            keys.push_back("KEY" + std::string(7 - number.length(), '0') + number);
+        }
+
+        return keys;
+    }
+
+
+    // Returns the hashing throughput in MB/s and the time per key in ns,
+    // hashing the keys repeatedly until about THROUGHPUT_BYTES are hashed.
+    template <typename Hasher>
+    std::pair<double, double> measureThroughput(const std::vector<std::string>& keys)
+    {
+        std::size_t bytesPerRound = 0;
+
+        for (const std::string& key : keys)
+        {
+            bytesPerRound += key.length();
+        }
+
+        std::size_t rounds = THROUGHPUT_BYTES / bytesPerRound + 1;
+
+        Hasher hasher;
+        std::uint64_t combined = 0;
+        Stopwatch stopwatch;
+        stopwatch.start();
+
+        for (std::size_t round = 0; round < rounds; ++round)
+        {
+            for (const std::string& key : keys)
+            {
+                combined += hasher(key);
+            }
+        }
+
+        stopwatch.stop();
+        hashSink = combined;
+
+        double bytes = static_cast<double>(bytesPerRound) * rounds;
+        return {
+            bytes / stopwatch.lastDuration(),
+            nanosecondsPer(stopwatch.lastDuration(), static_cast<double>(keys.size()) * rounds)};
+    }
+
+
+    template <typename Hasher>
+    HashSetStatistics measureDistribution(
+        const std::vector<std::string>& keys, const std::vector<std::string>& misses)
+    {
+        HashSet<std::string, Hasher, HeapNodeAllocator, ModuloIndexing, DirectKeys, CountedLookups> set;
+        set.reserve(keys.size());
+
+        for (const std::string& key : keys)
+        {
+            set.add(key);
+        }
+
+        for (const std::string& key : keys)
+        {
+            set.contains(key);
+        }
+
+        for (const std::string& miss : misses)
+        {
+            set.contains(miss);
+        }
+
+        return set.statistics();
+    }
+
+
+    template <typename Hasher>
+    void report(
+        const std::string& name,
+        const std::vector<std::string>& words, const std::vector<std::string>& misspellings,
+        const std::vector<std::vector<std::string>>& randomKeys,
+        const std::vector<std::string>& sequentialKeys, const std::vector<std::string>& sequentialMisses)
+    {
+        std::cout << name << std::endl;
+        std::cout << std::fixed;
+
+        std::pair<double, double> wordThroughput = measureThroughput<Hasher>(words);
+        std::cout << "  Throughput  words        " << std::setprecision(0) << std::setw(8)
+                  << wordThroughput.first << " MB/s  " << std::setprecision(1) << std::setw(8)
+                  << wordThroughput.second << " ns/key" << std::endl;
+
+        for (const std::vector<std::string>& keys : randomKeys)
+        {
+            std::pair<double, double> throughput = measureThroughput<Hasher>(keys);
+            std::cout << "              " << std::left << std::setw(13)
+                      << (std::to_string(keys.front().length()) + " bytes") << std::right
+                      << std::setprecision(0) << std::setw(8) << throughput.first << " MB/s  "
+                      << std::setprecision(1) << std::setw(8) << throughput.second << " ns/key"
+                      << std::endl;
+        }
+
+        HashSetStatistics wordStats = measureDistribution<Hasher>(words, misspellings);
+        HashSetStatistics sequentialStats = measureDistribution<Hasher>(sequentialKeys, sequentialMisses);
+
+        for (const auto& [label, stats] :
+            {std::make_pair("words", &wordStats), std::make_pair("sequential", &sequentialStats)})
+        {
+            std::cout << "  Chains      " << std::left << std::setw(13) << label << std::right
+                      << "longest " << std::setw(6) << stats->longestChain
+                      << "  empty " << std::setprecision(1) << std::setw(5)
+                      << 100.0 * stats->chainLengths[0] / stats->capacity << "%"
+                      << "  probes/hit " << std::setprecision(2) << std::setw(7)
+                      << stats->averageProbesPerSuccess()
+                      << "  probes/miss " << std::setw(7) << stats->averageProbesPerFailure()
+                      << std::endl;
+        }
+
+        std::cout << std::endl;
+    }
+}
+
+
+
+void runHashQualityBenchmark()
+{
+    std::string wordFilePath = readLine();
+
+    std::vector<std::string> words = readWords(wordFilePath);
+    std::vector<std::string> misspellings = makeMisspellings(words);
+
+    std::vector<std::vector<std::string>> randomKeys;
+
+    for (std::size_t length : {8, 32, 128, 1024})
+    {
+        randomKeys.push_back(makeRandomKeys(length, (1 << 20) / length));
+    }
+
+    std::vector<std::string> sequentialKeys = makeSequentialKeys(2 * SEQUENTIAL_KEYS);
+    std::vector<std::string> sequentialMisses(sequentialKeys.begin() + SEQUENTIAL_KEYS, sequentialKeys.end());
+    sequentialKeys.resize(SEQUENTIAL_KEYS);
+
+    report<SumHash>("HASH SUM", words, misspellings, randomKeys, sequentialKeys, sequentialMisses);
+    report<ProductHash>("HASH PRODUCT", words, misspellings, randomKeys, sequentialKeys, sequentialMisses);
+    report<WordMixHash>("HASH WORDMIX", words, misspellings, randomKeys, sequentialKeys, sequentialMisses);
+    report<StripesHash>("HASH STRIPES", words, misspellings, randomKeys, sequentialKeys, sequentialMisses);
+}
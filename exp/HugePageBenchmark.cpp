@@ -0,0 +1,234 @@
+// HugePageBenchmark.cpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+//
+// Loads a large synthetic dictionary into a HashSet twice, once with its
+// nodes and array from an ArenaNodeAllocator and once from a
+// HugePageNodeAllocator, and compares the throughput of random lookups
+// (half hits, half misses) and the number of data TLB misses they cause.
+// The synthetic words are 6 to 12 letters long, so, like most real words,
+// they fit in a std::string without a separate allocation.
+//
+// TLB misses are counted with perf_event_open(), which needs Linux and a
+// processor (or virtual machine) that exposes the counter; where it isn't
+// available, they're reported as "n/a".  The amount of memory the kernel
+// actually backed with transparent huge pages is read from
+// /proc/self/smaps_rollup.
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "BenchmarkSupport.hpp"
+#include "Benchmarks.hpp"
+#include "HashMixing.hpp"
+#include "HashSet.hpp"
+#include "NodeAllocator.hpp"
+#include "Stopwatch.hpp"
+#include "StringHashing.hpp"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+
+
+namespace
+{
+    constexpr std::size_t LOOKUP_COUNT = 4000000;
+
+    volatile bool foundSink;
+
+
+    std::string wordAt(std::size_t index)
+    {
+        std::uint64_t hash = mixHash(index + 1);
+        std::string word(6 + hash % 7, 'A');
+        hash /= 7;
+
+        for (char& c : word)
+        {
+            c = static_cast<char>('A' + hash % 26);
+            hash /= 26;
+        }
+
+        return word;
+    }
+
+
+    // Counts data TLB load misses in this thread, in user mode only, which
+    // is all an unprivileged process is usually allowed to count.
+    class TlbMissCounter
+    {
+    public:
+        TlbMissCounter()
+            : fd{-1}
+        {
+#if defined(__linux__)
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_DTLB
+                | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+
+            fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+        }
+
+        ~TlbMissCounter()
+        {
+#if defined(__linux__)
+            if (fd >= 0)
+            {
+                close(fd);
+            }
+#endif
+        }
+
+        TlbMissCounter(const TlbMissCounter&) = delete;
+        TlbMissCounter& operator=(const TlbMissCounter&) = delete;
+
+        bool isAvailable() const noexcept
+        {
+            return fd >= 0;
+        }
+
+        void start()
+        {
+#if defined(__linux__)
+            if (fd >= 0)
+            {
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+#endif
+        }
+
+        unsigned long long stop()
+        {
+            unsigned long long count = 0;
+
+#if defined(__linux__)
+            if (fd >= 0)
+            {
+                ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+
+                if (read(fd, &count, sizeof(count)) != sizeof(count))
+                {
+                    count = 0;
+                }
+            }
+#endif
+
+            return count;
+        }
+
+    private:
+        int fd;
+    };
+
+
+    // Returns the number of KiB of this process's memory that the kernel
+    // has backed with transparent huge pages, or 0 if it can't be told.
+    std::size_t anonymousHugePageKiB()
+    {
+        std::ifstream rollup{"/proc/self/smaps_rollup"};
+        std::string field;
+
+        while (rollup >> field)
+        {
+            std::size_t kib;
+
+            if (field == "AnonHugePages:" && rollup >> kib)
+            {
+                return kib;
+            }
+        }
+
+        return 0;
+    }
+
+
+    template <typename NodeAllocator>
+    void report(
+        const std::string& name, std::size_t wordCount,
+        const std::vector<std::string>& lookups)
+    {
+        HashSet<std::string, WordMixHash, NodeAllocator, MaskedIndexing> wordSet;
+        wordSet.reserve(wordCount);
+
+        for (std::size_t i = 0; i < wordCount; ++i)
+        {
+            wordSet.add(wordAt(i));
+        }
+
+        TlbMissCounter tlbMisses;
+        Stopwatch stopwatch;
+
+        stopwatch.start();
+        tlbMisses.start();
+
+        for (const std::string& lookup : lookups)
+        {
+            foundSink = wordSet.contains(lookup);
+        }
+
+        unsigned long long misses = tlbMisses.stop();
+        stopwatch.stop();
+
+        std::cout << std::left << std::setw(12) << name << std::right
+                  << std::fixed << std::setprecision(1)
+                  << std::setw(14) << lookups.size() / stopwatch.lastDuration()
+                  << std::setw(12) << nanosecondsPer(stopwatch.lastDuration(), lookups.size());
+
+        if (tlbMisses.isAvailable())
+        {
+            std::cout << std::setprecision(3) << std::setw(18)
+                      << static_cast<double>(misses) / lookups.size();
+        }
+        else
+        {
+            std::cout << std::setw(18) << "n/a";
+        }
+
+        std::cout << std::setw(14) << anonymousHugePageKiB() / 1024 << std::endl;
+    }
+}
+
+
+
+void runHugePageBenchmark()
+{
+    std::size_t wordCount = std::stoull(readLine());
+
+    std::mt19937_64 random{46};
+    std::uniform_int_distribution<std::size_t> index{0, wordCount - 1};
+
+    std::vector<std::string> lookups;
+    lookups.reserve(LOOKUP_COUNT);
+
+    for (std::size_t i = 0; i < LOOKUP_COUNT / 2; ++i)
+    {
+        lookups.push_back(wordAt(index(random)));
+        lookups.push_back(wordAt(wordCount + index(random)));
+    }
+
+    std::cout << "Words: " << wordCount << ", lookups: " << lookups.size() << std::endl;
+    std::cout << std::endl;
+    std::cout << "Pages       Mlookups/sec   ns/lookup  dTLB miss/lookup     THP (MiB)" << std::endl;
+
+    report<ArenaNodeAllocator>("Ordinary", wordCount, lookups);
+    report<HugePageNodeAllocator>("Huge", wordCount, lookups);
+}
@@ -0,0 +1,160 @@
+// InterningBenchmark.cpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+//
+// Loads the words in a word file, and then a large synthetic dictionary,
+// into HashSets and AVLSets that keep each word in its node as a
+// std::string (DirectKeys) and ones that keep only a handle into a
+// StringPool (InternedKeys), and reports how much memory each one takes
+// and how long a lookup takes.
+//
+// The synthetic words are 5 to 20 letters long, so that, as in a real
+// dictionary, most fit in a std::string's own small-string buffer but
+// the longest ones need a heap block of their own.  ListSet isn't
+// included, since loading a list is quadratic.
+//
+// Memory is measured as the growth in allocated bytes across a set's
+// construction (see allocatedBytes()), after freeze() has given back any
+// room the pool set aside for words that never came.
+
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "AVLSet.hpp"
+#include "BenchmarkSupport.hpp"
+#include "Benchmarks.hpp"
+#include "HashSet.hpp"
+#include "KeyStorage.hpp"
+#include "NodeAllocator.hpp"
+#include "Stopwatch.hpp"
+#include "StringHashing.hpp"
+
+
+
+namespace
+{
+    constexpr std::size_t LOOKUP_COUNT = 1000000;
+
+    volatile bool foundSink;
+
+
+    // Returns the number of bytes allocated to build a set of the given
+    // type from the given words.
+    template <typename SetType>
+    std::size_t report(
+        const std::string& name, const std::vector<std::string>& words,
+        const std::vector<std::string>& lookups, std::size_t directBytes)
+    {
+        std::size_t allocatedBefore = allocatedBytes();
+
+        SetType wordSet;
+
+        for (const std::string& word : words)
+        {
+            wordSet.add(word);
+        }
+
+        wordSet.freeze();
+
+        std::size_t allocatedAfter = allocatedBytes();
+        std::size_t bytes = allocatedAfter > allocatedBefore ? allocatedAfter - allocatedBefore : 0;
+
+        Stopwatch stopwatch;
+        stopwatch.start();
+
+        for (const std::string& lookup : lookups)
+        {
+            foundSink = wordSet.contains(lookup);
+        }
+
+        stopwatch.stop();
+
+        std::cout << std::left << std::setw(22) << name << std::right
+                  << std::fixed << std::setprecision(1)
+                  << std::setw(12) << bytes / 1048576.0
+                  << std::setw(12) << static_cast<double>(bytes) / words.size()
+                  << std::setw(12) << nanosecondsPer(stopwatch.lastDuration(), lookups.size());
+
+        if (directBytes != 0)
+        {
+            std::cout << std::setw(12) << 100.0 * (1.0 - static_cast<double>(bytes) / directBytes) << '%';
+        }
+
+        std::cout << std::endl;
+        return bytes;
+    }
+
+
+    void reportAll(const std::vector<std::string>& words, std::size_t missesFrom)
+    {
+        std::mt19937_64 random{46};
+        std::uniform_int_distribution<std::size_t> index{0, words.size() - 1};
+
+        // half the lookups are words in the set, and the other half are
+        // either misspellings or synthetic words past the end of the set
+        std::vector<std::string> misspellings;
+
+        if (missesFrom == 0)
+        {
+            misspellings = makeMisspellings(words);
+        }
+
+        std::vector<std::string> lookups;
+        lookups.reserve(LOOKUP_COUNT);
+
+        for (std::size_t i = 0; i < LOOKUP_COUNT / 2; ++i)
+        {
+            lookups.push_back(words[index(random)]);
+            lookups.push_back(
+                missesFrom == 0
+                ? misspellings[index(random)]
+                : syntheticWordAt(missesFrom + index(random)));
+        }
+
+        std::cout << "Words: " << words.size() << std::endl;
+        std::cout << "Structure                    MiB  Bytes/word  Lookup (ns)  Saved" << std::endl;
+
+        std::size_t direct = report<HashSet<std::string, WordMixHash, HeapNodeAllocator, MaskedIndexing>>(
+            "HASH", words, lookups, 0);
+        report<HashSet<std::string, WordMixHash, HeapNodeAllocator, MaskedIndexing, InternedKeys>>(
+            "HASH INTERNED", words, lookups, direct);
+
+        direct = report<HashSet<std::string, WordMixHash, ArenaNodeAllocator, MaskedIndexing>>(
+            "HASH ARENA", words, lookups, 0);
+        report<HashSet<std::string, WordMixHash, ArenaNodeAllocator, MaskedIndexing, InternedKeys>>(
+            "HASH INTERNED ARENA", words, lookups, direct);
+
+        direct = report<AVLSet<std::string>>("AVL", words, lookups, 0);
+        report<AVLSet<std::string, HeapNodeAllocator, InternedKeys>>("AVL INTERNED", words, lookups, direct);
+
+        direct = report<AVLSet<std::string, ArenaNodeAllocator>>("AVL ARENA", words, lookups, 0);
+        report<AVLSet<std::string, ArenaNodeAllocator, InternedKeys>>(
+            "AVL INTERNED ARENA", words, lookups, direct);
+
+        std::cout << std::endl;
+    }
+}
+
+
+
+void runInterningBenchmark()
+{
+    std::string wordFilePath = readLine();
+    std::size_t syntheticWordCount = std::stoull(readLine());
+
+    reportAll(readWords(wordFilePath), 0);
+
+    std::vector<std::string> syntheticWords;
+    syntheticWords.reserve(syntheticWordCount);
+
+    for (std::size_t i = 0; i < syntheticWordCount; ++i)
+    {
+        syntheticWords.push_back(syntheticWordAt(i));
+    }
+
+    reportAll(syntheticWords, syntheticWordCount);
+}
@@ -0,0 +1,135 @@
+// LookupLatencyBenchmark.cpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+//
+// Times lookups one at a time, rather than in bulk, so that the tail of
+// the distribution is visible: a hash table with a good average can still
+// have a few lookups that walk a very long chain.  Each set is loaded from
+// a word file, then searched for every word and one misspelling of each,
+// in a shuffled order.  The time of each lookup includes the overhead of
+// reading the clock twice, which is measured and reported separately.
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "BenchmarkSupport.hpp"
+#include "Benchmarks.hpp"
+#include "CuckooHashSet.hpp"
+#include "HashSet.hpp"
+#include "StringHashing.hpp"
+#include "SwissHashSet.hpp"
+#include "WordSetLoader.hpp"
+
+
+
+namespace
+{
+    // HASH ZERO lookups take so long that only this many are timed.
+    constexpr std::size_t ZERO_HASH_LOOKUPS = 2000;
+
+    volatile bool foundSink;
+
+
+    double percentile(const std::vector<double>& sortedTimes, double fraction)
+    {
+        std::size_t index = static_cast<std::size_t>(fraction * (sortedTimes.size() - 1));
+        return sortedTimes[index];
+    }
+
+
+    double measureClockOverhead()
+    {
+        std::vector<double> times;
+
+        for (unsigned int i = 0; i < 100000; ++i)
+        {
+            auto start = std::chrono::steady_clock::now();
+            auto stop = std::chrono::steady_clock::now();
+            times.push_back(std::chrono::duration<double, std::nano>(stop - start).count());
+        }
+
+        std::sort(times.begin(), times.end());
+        return percentile(times, 0.5);
+    }
+
+
+    void report(
+        const std::string& name, Set<std::string>& wordSet,
+        const std::string& wordFilePath, const std::vector<std::string>& lookups)
+    {
+        WordSetLoader{}.load(wordFilePath, wordSet);
+
+        std::vector<double> times;
+        times.reserve(lookups.size());
+
+        for (const std::string& lookup : lookups)
+        {
+            auto start = std::chrono::steady_clock::now();
+            foundSink = wordSet.contains(lookup);
+            auto stop = std::chrono::steady_clock::now();
+            times.push_back(std::chrono::duration<double, std::nano>(stop - start).count());
+        }
+
+        std::sort(times.begin(), times.end());
+
+        std::cout << std::left << std::setw(16) << name << std::right
+                  << std::setw(9) << times.size()
+                  << std::fixed << std::setprecision(0)
+                  << std::setw(10) << percentile(times, 0.5)
+                  << std::setw(10) << percentile(times, 0.99)
+                  << std::setw(10) << percentile(times, 0.999)
+                  << std::setw(12) << times.back()
+                  << std::endl;
+    }
+}
+
+
+
+void runLookupLatencyBenchmark()
+{
+    std::string wordFilePath = readLine();
+
+    std::vector<std::string> words = readWords(wordFilePath);
+    std::vector<std::string> misspellings = makeMisspellings(words);
+
+    std::vector<std::string> lookups = words;
+    lookups.insert(lookups.end(), misspellings.begin(), misspellings.end());
+    std::shuffle(lookups.begin(), lookups.end(), std::mt19937{46});
+
+    std::vector<std::string> zeroLookups(lookups.begin(), lookups.begin() + std::min(ZERO_HASH_LOOKUPS, lookups.size()));
+
+    std::cout << "Clock overhead per lookup: about " << std::fixed << std::setprecision(0)
+              << measureClockOverhead() << " ns" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Structure         Lookups   p50 (ns)  p99 (ns) p99.9 (ns)   max (ns)" << std::endl;
+
+    {
+        HashSet<std::string, ZeroHash> wordSet;
+        report("HASH ZERO", wordSet, wordFilePath, zeroLookups);
+    }
+
+    {
+        HashSet<std::string, SumHash> wordSet;
+        report("HASH SUM", wordSet, wordFilePath, lookups);
+    }
+
+    {
+        HashSet<std::string, ProductHash> wordSet;
+        report("HASH PRODUCT", wordSet, wordFilePath, lookups);
+    }
+
+    {
+        SwissHashSet<std::string, ProductHash> wordSet;
+        report("HASH SWISS", wordSet, wordFilePath, lookups);
+    }
+
+    {
+        CuckooHashSet<std::string, ProductHash> wordSet;
+        report("HASH CUCKOO", wordSet, wordFilePath, lookups);
+    }
+}
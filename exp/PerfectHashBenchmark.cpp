@@ -0,0 +1,109 @@
+// PerfectHashBenchmark.cpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+//
+// Compares PerfectHashSet against HashSet and SwissHashSet on a word file:
+// how long each takes to load (including PerfectHashSet's build), how
+// much memory it uses per word, and how long a lookup takes, for words
+// that are in the set and for misspellings that aren't.
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "BenchmarkSupport.hpp"
+#include "Benchmarks.hpp"
+#include "HashSet.hpp"
+#include "PerfectHashSet.hpp"
+#include "Stopwatch.hpp"
+#include "StringHashing.hpp"
+#include "SwissHashSet.hpp"
+#include "WordSetLoader.hpp"
+
+
+
+namespace
+{
+    constexpr unsigned int LOOKUP_ROUNDS = 20;
+
+    // Lookup results are stored here, so the lookups can't be optimized
+    // away.
+    volatile unsigned int foundSink;
+
+
+    double timeLookups(const Set<std::string>& wordSet, const std::vector<std::string>& lookups)
+    {
+        Stopwatch stopwatch;
+        unsigned int found = 0;
+
+        stopwatch.start();
+
+        for (unsigned int round = 0; round < LOOKUP_ROUNDS; ++round)
+        {
+            for (const std::string& lookup : lookups)
+            {
+                found += wordSet.contains(lookup);
+            }
+        }
+
+        stopwatch.stop();
+
+        foundSink = found;
+
+        return nanosecondsPer(stopwatch.lastDuration(), LOOKUP_ROUNDS * lookups.size());
+    }
+
+
+    void report(
+        const std::string& name, Set<std::string>& wordSet, const std::string& wordFilePath,
+        const std::vector<std::string>& words, const std::vector<std::string>& misspellings)
+    {
+        Stopwatch stopwatch;
+        stopwatch.start();
+        WordSetLoader{}.load(wordFilePath, wordSet);
+        stopwatch.stop();
+
+        std::cout << std::left << std::setw(16) << name
+                  << std::right << std::fixed << std::setprecision(0)
+                  << std::setw(10) << stopwatch.lastDuration() << "usec"
+                  << std::setprecision(1)
+                  << std::setw(12) << timeLookups(wordSet, words) << "ns"
+                  << std::setw(12) << timeLookups(wordSet, misspellings) << "ns"
+                  << std::endl;
+    }
+}
+
+
+
+void runPerfectHashBenchmark()
+{
+    std::string wordFilePath = readLine();
+
+    std::vector<std::string> words = readWords(wordFilePath);
+    std::vector<std::string> misspellings = makeMisspellings(words);
+
+    std::cout << "Structure             Load     Hit lookup   Miss lookup" << std::endl;
+
+    {
+        HashSet<std::string, ProductHash> wordSet;
+        report("HASH PRODUCT", wordSet, wordFilePath, words, misspellings);
+    }
+
+    {
+        SwissHashSet<std::string, ProductHash> wordSet;
+        report("HASH SWISS", wordSet, wordFilePath, words, misspellings);
+    }
+
+    PerfectHashSet perfect;
+    report("PERFECT", perfect, wordFilePath, words, misspellings);
+
+    double keys = perfect.size();
+
+    std::cout << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "PerfectHashSet with " << perfect.size() << " words:" << std::endl;
+    std::cout << "  Hash function:  " << perfect.hashFunctionBits() / keys << " bits/word" << std::endl;
+    std::cout << "  Everything:     " << perfect.storageBytes() * 8 / keys << " bits/word ("
+              << perfect.storageBytes() << " bytes)" << std::endl;
+}
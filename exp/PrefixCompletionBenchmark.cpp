@@ -0,0 +1,147 @@
+// PrefixCompletionBenchmark.cpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+//
+// Times top-k prefix completion, the way an editor would ask for it on
+// each keystroke: for a random word, each of its first few prefixes is
+// completed in turn, asking for at most COMPLETION_LIMIT words.  Each
+// completion is timed on its own, so the median and the tail are both
+// visible.  For comparison, the same completions are found by walking the
+// whole set with inorder() and keeping the matches, which is all AVLSet
+// offered before visitPrefix(); that's slow enough that fewer of them are
+// timed.
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "AVLSet.hpp"
+#include "BenchmarkSupport.hpp"
+#include "Benchmarks.hpp"
+#include "KeyStorage.hpp"
+#include "NodeAllocator.hpp"
+
+
+
+namespace
+{
+    constexpr std::size_t COMPLETION_LIMIT = 10;
+    constexpr std::size_t LONGEST_PREFIX = 6;
+    constexpr std::size_t PREFIX_QUERIES = 60000;
+    constexpr std::size_t SCAN_QUERIES = 300;
+
+    volatile std::size_t resultSink;
+
+
+    double percentile(const std::vector<double>& sortedTimes, double fraction)
+    {
+        std::size_t index = static_cast<std::size_t>(fraction * (sortedTimes.size() - 1));
+        return sortedTimes[index];
+    }
+
+
+    template <typename Complete>
+    std::vector<double> timeCompletions(const std::vector<std::string>& prefixes, std::size_t count, Complete complete)
+    {
+        std::vector<double> times;
+        times.reserve(count);
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            auto start = std::chrono::steady_clock::now();
+            resultSink = complete(prefixes[i % prefixes.size()]);
+            auto stop = std::chrono::steady_clock::now();
+            times.push_back(std::chrono::duration<double, std::micro>(stop - start).count());
+        }
+
+        std::sort(times.begin(), times.end());
+        return times;
+    }
+
+
+    template <typename SetType>
+    void report(const std::string& name, const std::vector<std::string>& words, const std::vector<std::string>& prefixes)
+    {
+        SetType wordSet;
+        wordSet.addAll(words);
+        wordSet.freeze();
+
+        std::vector<std::string> completions;
+
+        std::vector<double> prefixTimes = timeCompletions(
+            prefixes, PREFIX_QUERIES,
+            [&](const std::string& prefix)
+            {
+                completions.clear();
+                return wordSet.visitPrefix(
+                    prefix,
+                    [&](const std::string& word) { completions.push_back(word); },
+                    COMPLETION_LIMIT);
+            });
+
+        std::vector<double> scanTimes = timeCompletions(
+            prefixes, SCAN_QUERIES,
+            [&](const std::string& prefix)
+            {
+                completions.clear();
+
+                wordSet.inorder(
+                    [&](const std::string& word)
+                    {
+                        if (completions.size() < COMPLETION_LIMIT && word.compare(0, prefix.size(), prefix) == 0)
+                        {
+                            completions.push_back(word);
+                        }
+                    });
+
+                return completions.size();
+            });
+
+        std::cout << std::left << std::setw(20) << name << std::right
+                  << std::fixed << std::setprecision(2)
+                  << std::setw(13) << percentile(prefixTimes, 0.5)
+                  << std::setw(12) << percentile(prefixTimes, 0.99)
+                  << std::setw(12) << prefixTimes.back()
+                  << std::setw(15) << std::setprecision(0) << percentile(scanTimes, 0.5)
+                  << std::endl;
+    }
+}
+
+
+
+void runPrefixCompletionBenchmark()
+{
+    std::vector<std::string> words = readWords(readLine());
+
+    std::mt19937_64 random{46};
+    std::uniform_int_distribution<std::size_t> index{0, words.size() - 1};
+
+    // the prefixes are typed one keystroke at a time, so each word
+    // contributes its prefixes of length 1, 2, and so on
+    std::vector<std::string> prefixes;
+
+    while (prefixes.size() < PREFIX_QUERIES)
+    {
+        const std::string& word = words[index(random)];
+
+        for (std::size_t length = 1; length <= std::min(word.length(), LONGEST_PREFIX); ++length)
+        {
+            prefixes.push_back(word.substr(0, length));
+        }
+    }
+
+    std::cout << "Words: " << words.size() << ", at most " << COMPLETION_LIMIT
+              << " completions per prefix" << std::endl;
+    std::cout << std::endl;
+    std::cout << "                     ----------- visitPrefix ------------  inorder scan" << std::endl;
+    std::cout << "Structure             Median (us)    p99 (us)    Max (us)    Median (us)" << std::endl;
+
+    report<AVLSet<std::string>>("AVL", words, prefixes);
+    report<AVLSet<std::string, ArenaNodeAllocator>>("AVL ARENA", words, prefixes);
+    report<AVLSet<std::string, ArenaNodeAllocator, InternedKeys>>("AVL INTERNED ARENA", words, prefixes);
+}
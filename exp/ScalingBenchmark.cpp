@@ -0,0 +1,144 @@
+// ScalingBenchmark.cpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+//
+// Loads sets of synthetic 64-bit keys, at sizes growing tenfold from
+// 1,000,000 up to a given maximum, and reports how long loading took,
+// how much memory each set uses per key, and how long a lookup takes
+// once the set no longer fits in any cache.  The keys are mixHash(1),
+// mixHash(2), and so on; since mixHash() is a bijection, they're all
+// different, and keys past the end of the set make a supply of misses
+// that never needs to be stored.
+//
+// Memory is measured as the growth in allocated bytes across a set's
+// construction (see allocatedBytes()), so it includes the allocator's
+// overhead per node and whatever part of a table has yet to be filled.
+
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "AVLSet.hpp"
+#include "BenchmarkSupport.hpp"
+#include "Benchmarks.hpp"
+#include "CuckooHashSet.hpp"
+#include "HashMixing.hpp"
+#include "HashSet.hpp"
+#include "NodeAllocator.hpp"
+#include "Stopwatch.hpp"
+#include "SwissHashSet.hpp"
+
+
+
+namespace
+{
+    constexpr std::size_t MIN_KEY_COUNT = 1000000;
+    constexpr std::size_t LOOKUP_COUNT = 1000000;
+
+    volatile bool foundSink;
+
+
+    // The keys are already uniformly distributed, so they're their own
+    // hash.
+    struct KeyHash
+    {
+        std::size_t operator()(std::uint64_t key) const noexcept
+        {
+            return key;
+        }
+    };
+
+
+    std::uint64_t keyAt(std::size_t index)
+    {
+        return mixHash(index + 1);
+    }
+
+
+    double timeLookups(const Set<std::uint64_t>& keySet, const std::vector<std::uint64_t>& lookups)
+    {
+        Stopwatch stopwatch;
+        stopwatch.start();
+
+        for (std::uint64_t key : lookups)
+        {
+            foundSink = keySet.contains(key);
+        }
+
+        stopwatch.stop();
+        return nanosecondsPer(stopwatch.lastDuration(), lookups.size());
+    }
+
+
+    template <typename SetType>
+    void report(const std::string& name, std::size_t keyCount)
+    {
+        std::mt19937_64 random{keyCount};
+        std::uniform_int_distribution<std::size_t> index{0, keyCount - 1};
+
+        std::vector<std::uint64_t> hits;
+        std::vector<std::uint64_t> misses;
+        hits.reserve(LOOKUP_COUNT);
+        misses.reserve(LOOKUP_COUNT);
+
+        for (std::size_t i = 0; i < LOOKUP_COUNT; ++i)
+        {
+            hits.push_back(keyAt(index(random)));
+            misses.push_back(keyAt(keyCount + index(random)));
+        }
+
+        std::size_t allocatedBefore = allocatedBytes();
+
+        SetType keySet;
+        Stopwatch stopwatch;
+        stopwatch.start();
+
+        keySet.reserve(keyCount);
+
+        for (std::size_t i = 0; i < keyCount; ++i)
+        {
+            keySet.add(keyAt(i));
+        }
+
+        stopwatch.stop();
+
+        double loadTime = nanosecondsPer(stopwatch.lastDuration(), keyCount);
+        std::size_t allocatedAfter = allocatedBytes();
+        double bytesPerKey =
+            allocatedAfter > allocatedBefore
+            ? static_cast<double>(allocatedAfter - allocatedBefore) / keyCount
+            : 0.0;
+
+        std::cout << std::left << std::setw(16) << name << std::right
+                  << std::setw(13) << keySet.size()
+                  << std::fixed << std::setprecision(1)
+                  << std::setw(12) << loadTime
+                  << std::setw(11) << bytesPerKey
+                  << std::setw(11) << timeLookups(keySet, hits)
+                  << std::setw(11) << timeLookups(keySet, misses)
+                  << std::endl;
+    }
+}
+
+
+
+void runScalingBenchmark()
+{
+    std::size_t maxKeyCount = std::stoull(readLine());
+
+    std::cout << "Structure            Keys   Load (ns)  Bytes/key   Hit (ns)  Miss (ns)" << std::endl;
+
+    for (std::size_t keyCount = MIN_KEY_COUNT; keyCount <= maxKeyCount; keyCount *= 10)
+    {
+        report<HashSet<std::uint64_t, KeyHash, HeapNodeAllocator, MaskedIndexing>>("HASH", keyCount);
+        report<HashSet<std::uint64_t, KeyHash, ArenaNodeAllocator, MaskedIndexing>>("HASH ARENA", keyCount);
+        report<SwissHashSet<std::uint64_t, KeyHash>>("HASH SWISS", keyCount);
+        report<CuckooHashSet<std::uint64_t, KeyHash>>("HASH CUCKOO", keyCount);
+        report<AVLSet<std::uint64_t, ArenaNodeAllocator>>("AVL ARENA", keyCount);
+        std::cout << std::endl;
+    }
+}
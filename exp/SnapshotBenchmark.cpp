@@ -0,0 +1,158 @@
+// SnapshotBenchmark.cpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+//
+// Compares taking a copy of a loaded word set, and then adding words to
+// the copy, for an AVLSet (whose copies are deep) and a PersistentAVLSet
+// (whose copies share every node until they're added to).  For each, it
+// reports how long a copy takes and how much memory it allocates, how
+// long each of ADDED_WORDS later additions to the copy takes and how much
+// memory each allocates, and how long a lookup takes (half words, half
+// misspellings).  Copies of a PersistentAVLSet are so quick that many of
+// them are timed together.
+
+#include <algorithm>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "AVLSet.hpp"
+#include "BenchmarkSupport.hpp"
+#include "Benchmarks.hpp"
+#include "PersistentAVLSet.hpp"
+#include "Stopwatch.hpp"
+
+
+
+namespace
+{
+    constexpr std::size_t ADDED_WORDS = 10000;
+    constexpr std::size_t LOOKUP_COUNT = 1000000;
+    constexpr unsigned int ROUNDS = 3;
+
+    volatile std::size_t resultSink;
+
+
+    std::size_t allocatedSince(std::size_t allocatedBefore)
+    {
+        std::size_t allocatedAfter = allocatedBytes();
+        return allocatedAfter > allocatedBefore ? allocatedAfter - allocatedBefore : 0;
+    }
+
+
+    template <typename SetType>
+    void report(
+        const std::string& name, const std::vector<std::string>& words,
+        const std::vector<std::string>& addedWords, const std::vector<std::string>& lookups,
+        std::size_t copyCount)
+    {
+        SetType wordSet;
+
+        for (const std::string& word : words)
+        {
+            wordSet.add(word);
+        }
+
+        Stopwatch stopwatch;
+
+        // the copies are made, and then destroyed, so that the memory of
+        // only one of them is counted
+        std::vector<SetType> copies;
+        copies.reserve(copyCount);
+
+        std::size_t allocatedBefore = allocatedBytes();
+        stopwatch.start();
+
+        for (std::size_t i = 0; i < copyCount; ++i)
+        {
+            copies.push_back(wordSet);
+        }
+
+        stopwatch.stop();
+
+        std::size_t copyBytes = allocatedSince(allocatedBefore) / copyCount;
+        double copyTime = stopwatch.lastDuration() / copyCount;
+
+        SetType copy = std::move(copies.front());
+        copies.clear();
+
+        allocatedBefore = allocatedBytes();
+        stopwatch.start();
+
+        for (const std::string& word : addedWords)
+        {
+            copy.add(word);
+        }
+
+        stopwatch.stop();
+
+        std::size_t addBytes = allocatedSince(allocatedBefore);
+        double addTime = nanosecondsPer(stopwatch.lastDuration(), addedWords.size());
+
+        double lookupTime = 0.0;
+
+        for (unsigned int round = 0; round < ROUNDS; ++round)
+        {
+            std::size_t found = 0;
+            stopwatch.start();
+
+            for (const std::string& lookup : lookups)
+            {
+                found += copy.contains(lookup);
+            }
+
+            stopwatch.stop();
+            resultSink = found;
+
+            double time = nanosecondsPer(stopwatch.lastDuration(), lookups.size());
+            lookupTime = (round == 0 ? time : std::min(lookupTime, time));
+        }
+
+        std::cout << std::left << std::setw(16) << name << std::right
+                  << std::fixed << std::setprecision(2)
+                  << std::setw(12) << copyTime
+                  << std::setw(14) << copyBytes
+                  << std::setprecision(0)
+                  << std::setw(11) << addTime
+                  << std::setw(12) << static_cast<double>(addBytes) / addedWords.size()
+                  << std::setw(14) << lookupTime
+                  << std::endl;
+    }
+}
+
+
+
+void runSnapshotBenchmark()
+{
+    std::vector<std::string> words = readWords(readLine());
+    std::vector<std::string> misspellings = makeMisspellings(words);
+
+    // the added words are synthetic, so almost none are already there
+    std::vector<std::string> addedWords;
+
+    for (std::size_t i = 0; i < ADDED_WORDS; ++i)
+    {
+        addedWords.push_back(syntheticWordAt(i));
+    }
+
+    std::mt19937_64 random{46};
+    std::uniform_int_distribution<std::size_t> index{0, words.size() - 1};
+
+    std::vector<std::string> lookups;
+    lookups.reserve(LOOKUP_COUNT);
+
+    for (std::size_t i = 0; i < LOOKUP_COUNT / 2; ++i)
+    {
+        lookups.push_back(words[index(random)]);
+        lookups.push_back(misspellings[index(random)]);
+    }
+
+    std::cout << "Words: " << words.size() << ", then " << ADDED_WORDS << " added to a copy" << std::endl;
+    std::cout << "Structure          Copy (us)  Copy (bytes)   Add (ns)   Bytes/add   Lookup (ns)" << std::endl;
+
+    report<AVLSet<std::string>>("AVL", words, addedWords, lookups, 1);
+    report<PersistentAVLSet<std::string>>("AVL PERSISTENT", words, addedWords, lookups, 100000);
+}
@@ -0,0 +1,136 @@
+// TraversalBenchmark.cpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+//
+// Times dumping every word in an AVLSet, one per line, into a string, the
+// way a dictionary would be serialized, by each of the ways AVLSet offers
+// to walk it: inorder() with a VisitFunction (one indirect call per
+// word), inorder() with a lambda (which can be inlined), a range-based for
+// loop over its iterators, and preorder() and postorder() with a lambda.
+// Each is run several times, and the fastest run is reported, in
+// nanoseconds per word.
+
+#include <algorithm>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "AVLSet.hpp"
+#include "BenchmarkSupport.hpp"
+#include "Benchmarks.hpp"
+#include "KeyStorage.hpp"
+#include "NodeAllocator.hpp"
+#include "Stopwatch.hpp"
+
+
+
+namespace
+{
+    constexpr unsigned int ROUNDS = 10;
+
+    volatile std::size_t resultSink;
+
+
+    template <typename Dump>
+    double fastestDump(std::size_t wordCount, Dump dump)
+    {
+        std::string output;
+        double fastest = 0.0;
+
+        for (unsigned int round = 0; round < ROUNDS; ++round)
+        {
+            Stopwatch stopwatch;
+            output.clear();
+
+            stopwatch.start();
+            dump(output);
+            stopwatch.stop();
+
+            resultSink = output.size();
+
+            double time = nanosecondsPer(stopwatch.lastDuration(), wordCount);
+            fastest = (round == 0 ? time : std::min(fastest, time));
+        }
+
+        return fastest;
+    }
+
+
+    template <typename SetType>
+    void report(const std::string& name, const std::vector<std::string>& words)
+    {
+        SetType wordSet;
+        wordSet.addAll(words);
+
+        auto append = [](std::string& output, const std::string& word)
+        {
+            output.append(word);
+            output.push_back('\n');
+        };
+
+        double visitFunction = fastestDump(
+            words.size(),
+            [&](std::string& output)
+            {
+                typename SetType::VisitFunction visit = [&](const std::string& word) { append(output, word); };
+                wordSet.inorder(visit);
+            });
+
+        double inorder = fastestDump(
+            words.size(),
+            [&](std::string& output)
+            {
+                wordSet.inorder([&](const std::string& word) { append(output, word); });
+            });
+
+        double iterators = fastestDump(
+            words.size(),
+            [&](std::string& output)
+            {
+                for (const std::string& word : wordSet)
+                {
+                    append(output, word);
+                }
+            });
+
+        double preorder = fastestDump(
+            words.size(),
+            [&](std::string& output)
+            {
+                wordSet.preorder([&](const std::string& word) { append(output, word); });
+            });
+
+        double postorder = fastestDump(
+            words.size(),
+            [&](std::string& output)
+            {
+                wordSet.postorder([&](const std::string& word) { append(output, word); });
+            });
+
+        std::cout << std::left << std::setw(20) << name << std::right
+                  << std::fixed << std::setprecision(1)
+                  << std::setw(14) << visitFunction
+                  << std::setw(11) << inorder
+                  << std::setw(11) << iterators
+                  << std::setw(11) << preorder
+                  << std::setw(11) << postorder
+                  << std::endl;
+    }
+}
+
+
+
+void runTraversalBenchmark()
+{
+    std::vector<std::string> words = readWords(readLine());
+
+    std::cout << "Words: " << words.size() << ", in nanoseconds per word" << std::endl;
+    std::cout << "                     ----------------- inorder -----------------" << std::endl;
+    std::cout << "Structure            VisitFunction     lambda   for loop   preorder  postorder" << std::endl;
+
+    report<AVLSet<std::string>>("AVL", words);
+    report<AVLSet<std::string, ArenaNodeAllocator>>("AVL ARENA", words);
+    report<AVLSet<std::string, ArenaNodeAllocator, InternedKeys>>("AVL INTERNED ARENA", words);
+}
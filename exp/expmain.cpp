@@ -6,13 +6,76 @@
 // Do whatever you'd like here.  This is intended to allow you to experiment
 // with your code, outside of the context of the broader program or Google
 // Test.
+//
+// The first line of standard input names the benchmark to run (see
+// Benchmarks.hpp); the benchmark then reads the rest of its input.
 
 #include <iostream>
-#include "AVLSet.hpp"
-#include <vector>
+#include <string>
+#include "BenchmarkSupport.hpp"
+#include "Benchmarks.hpp"
+
 
 int main()
 {
+    std::string benchmark = readLine();
+
+    if (benchmark == "CONCURRENT")
+    {
+        runConcurrentLookupBenchmark();
+    }
+    else if (benchmark == "PERFECT")
+    {
+        runPerfectHashBenchmark();
+    }
+    else if (benchmark == "HASHING")
+    {
+        runHashQualityBenchmark();
+    }
+    else if (benchmark == "LATENCY")
+    {
+        runLookupLatencyBenchmark();
+    }
+    else if (benchmark == "SCALING")
+    {
+        runScalingBenchmark();
+    }
+    else if (benchmark == "HUGEPAGES")
+    {
+        runHugePageBenchmark();
+    }
+    else if (benchmark == "INTERNING")
+    {
+        runInterningBenchmark();
+    }
+    else if (benchmark == "FROZEN")
+    {
+        runFrozenTreeBenchmark();
+    }
+    else if (benchmark == "PREFIX")
+    {
+        runPrefixCompletionBenchmark();
+    }
+    else if (benchmark == "BTREE")
+    {
+        runBTreeBenchmark();
+    }
+    else if (benchmark == "SNAPSHOT")
+    {
+        runSnapshotBenchmark();
+    }
+    else if (benchmark == "TRAVERSAL")
+    {
+        runTraversalBenchmark();
+    }
+    else if (benchmark == "COMPACT")
+    {
+        runCompactAVLBenchmark();
+    }
+    else
+    {
+        std::cout << "Unknown benchmark: " << benchmark << std::endl;
+    }
 
     return 0;
 }
@@ -0,0 +1,603 @@
+// AVLSet_ExtensionTests.cpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+//
+// Unit tests for the parts of AVLSet that go beyond the interface checked
+// by AVLSet_SanityCheckTests.cpp.
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "AVLSet.hpp"
+#include "KeyStorage.hpp"
+#include "NodeAllocator.hpp"
+#include "OrderedSet.hpp"
+
+
+TEST(AVLSet_ExtensionTests, addingDuplicatesDoesNotChangeSize)
+{
+    AVLSet<std::string> s;
+    s.add("BETA");
+    s.add("ALPHA");
+    s.add("BETA");
+    s.add("ALPHA");
+
+    EXPECT_EQ(2, s.size());
+}
+
+
+TEST(AVLSet_ExtensionTests, staysBalancedUnderRandomInsertion)
+{
+    std::vector<int> elements(50000);
+
+    for (int i = 0; i < 50000; ++i)
+    {
+        elements[i] = i;
+    }
+
+    std::shuffle(elements.begin(), elements.end(), std::mt19937{46});
+
+    AVLSet<int> s;
+
+    for (int element : elements)
+    {
+        s.add(element);
+    }
+
+    // an AVL tree of n nodes is less than 1.45 * log2(n + 2) tall
+    EXPECT_LE(s.height(), 22);
+    EXPECT_EQ(50000, s.size());
+
+    int previous = -1;
+    bool ordered = true;
+    s.inorder([&](const int& element) { ordered = ordered && element == previous + 1; previous = element; });
+
+    EXPECT_TRUE(ordered);
+    EXPECT_TRUE(s.contains(0));
+    EXPECT_TRUE(s.contains(49999));
+    EXPECT_FALSE(s.contains(50000));
+}
+
+
+TEST(AVLSet_ExtensionTests, ascendingInsertionLeavesUnbalancedTreeDegenerate)
+{
+    AVLSet<int> s{false};
+
+    for (int i = 0; i < 3000; ++i)
+    {
+        s.add(i);
+    }
+
+    EXPECT_EQ(2999, s.height());
+    EXPECT_TRUE(s.contains(2999));
+}
+
+
+TEST(AVLSet_ExtensionTests, unbalancedTreeTracksHeightOfDeepestBranch)
+{
+    AVLSet<int> s{false};
+    s.add(50);
+    s.add(25);
+    s.add(75);
+    s.add(10);
+    s.add(5);
+    s.add(80);
+
+    EXPECT_EQ(3, s.height());
+}
+
+
+TEST(AVLSet_ExtensionTests, frozenSetFindsExactlyWhatTheTreeDoes)
+{
+    for (int count = 0; count < 70; ++count)
+    {
+        AVLSet<int> s{true, true};
+
+        for (int i = 0; i < count; ++i)
+        {
+            s.add(2 * i);
+        }
+
+        s.freeze();
+        EXPECT_EQ(count > 0, s.isFrozen());
+
+        for (int i = -1; i <= 2 * count; ++i)
+        {
+            EXPECT_EQ(i >= 0 && i % 2 == 0 && i < 2 * count, s.contains(i));
+        }
+    }
+}
+
+
+TEST(AVLSet_ExtensionTests, addingAfterFreezeThawsTheSet)
+{
+    AVLSet<std::string> s{true, true};
+    s.add("DELTA");
+    s.add("ALPHA");
+    s.freeze();
+
+    s.add("ALPHA");
+    EXPECT_TRUE(s.isFrozen());
+
+    s.add("CHARLIE");
+    EXPECT_FALSE(s.isFrozen());
+    EXPECT_TRUE(s.contains("CHARLIE"));
+
+    s.freeze();
+    EXPECT_TRUE(s.contains("CHARLIE"));
+    EXPECT_TRUE(s.contains("DELTA"));
+    EXPECT_FALSE(s.contains("BRAVO"));
+}
+
+
+TEST(AVLSet_ExtensionTests, frozenSetStillTraversesItsTree)
+{
+    AVLSet<int> s{true, true};
+    s.add(20);
+    s.add(10);
+    s.add(30);
+    s.freeze();
+
+    AVLSet<int> copy{s};
+    EXPECT_TRUE(copy.isFrozen());
+
+    std::vector<int> preElements;
+    std::vector<int> inElements;
+    copy.preorder([&](const int& element) { preElements.push_back(element); });
+    copy.inorder([&](const int& element) { inElements.push_back(element); });
+
+    EXPECT_EQ((std::vector<int>{20, 10, 30}), preElements);
+    EXPECT_EQ((std::vector<int>{10, 20, 30}), inElements);
+    EXPECT_EQ(1, copy.height());
+}
+
+
+TEST(AVLSet_ExtensionTests, frozenInternedSetComparesAgainstThePool)
+{
+    AVLSet<std::string, ArenaNodeAllocator, InternedKeys> s{true, true};
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        s.add("WORD" + std::to_string(i));
+    }
+
+    s.freeze();
+
+    EXPECT_TRUE(s.contains("WORD0"));
+    EXPECT_TRUE(s.contains("WORD999"));
+    EXPECT_FALSE(s.contains("WORD1000"));
+    EXPECT_FALSE(s.contains("WORD"));
+}
+
+
+TEST(AVLSet_ExtensionTests, freezeBuildsNoArrayUnlessAskedTo)
+{
+    AVLSet<int> s;
+
+    for (int i = 0; i < 100; ++i)
+    {
+        s.add(i);
+    }
+
+    s.freeze();
+
+    EXPECT_FALSE(s.isFrozen());
+    EXPECT_TRUE(s.contains(99));
+    EXPECT_FALSE(s.contains(100));
+
+    AVLSet<int> copy{s};
+    copy.freeze();
+    EXPECT_FALSE(copy.isFrozen());
+}
+
+
+TEST(AVLSet_ExtensionTests, addAllBuildsBalancedTreeFromSortedElements)
+{
+    std::vector<int> elements;
+
+    for (int i = 0; i < 1023; ++i)
+    {
+        elements.push_back(i);
+    }
+
+    AVLSet<int> s;
+    s.addAll(elements, true);
+
+    EXPECT_EQ(1023, s.size());
+    EXPECT_EQ(9, s.height());
+
+    std::vector<int> visited;
+    s.inorder([&](const int& element) { visited.push_back(element); });
+
+    EXPECT_EQ(elements, visited);
+    EXPECT_FALSE(s.contains(1023));
+}
+
+
+TEST(AVLSet_ExtensionTests, addAllSortsAndDropsDuplicates)
+{
+    std::vector<std::string> words{"PEAR", "APPLE", "FIG", "APPLE", "BANANA", "FIG"};
+
+    AVLSet<std::string> s;
+    s.addAll(words);
+
+    std::vector<std::string> visited;
+    s.inorder([&](const std::string& word) { visited.push_back(word); });
+
+    EXPECT_EQ((std::vector<std::string>{"APPLE", "BANANA", "FIG", "PEAR"}), visited);
+    EXPECT_EQ(4, s.size());
+    EXPECT_EQ(2, s.height());
+}
+
+
+TEST(AVLSet_ExtensionTests, addAllWithSortedDuplicatesKeepsOneOfEach)
+{
+    AVLSet<int> s;
+    s.addAll(std::vector<int>{1, 1, 2, 3, 3, 3}, true);
+
+    EXPECT_EQ(3, s.size());
+    EXPECT_EQ(1, s.height());
+}
+
+
+TEST(AVLSet_ExtensionTests, buildsInBulkOnlyWhileEmptyAndBalanced)
+{
+    AVLSet<int> s;
+    EXPECT_TRUE(s.buildsInBulk());
+
+    s.add(1);
+    EXPECT_FALSE(s.buildsInBulk());
+
+    AVLSet<int> unbalanced{false};
+    EXPECT_FALSE(unbalanced.buildsInBulk());
+}
+
+
+TEST(AVLSet_ExtensionTests, addAllIntoNonEmptySetAddsOneAtATime)
+{
+    AVLSet<int> s;
+    s.add(5);
+    s.addAll(std::vector<int>{9, 1, 5, 7});
+
+    EXPECT_EQ(4, s.size());
+    EXPECT_TRUE(s.contains(1));
+    EXPECT_TRUE(s.contains(9));
+
+    AVLSet<int> unbalanced{false};
+    unbalanced.addAll(std::vector<int>{1, 2, 3, 4}, true);
+
+    EXPECT_EQ(3, unbalanced.height());
+}
+
+
+TEST(AVLSet_ExtensionTests, bulkBuiltSetCanBeGrownAndFrozen)
+{
+    std::vector<int> elements;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        elements.push_back(2 * i);
+    }
+
+    AVLSet<int, ArenaNodeAllocator> s{true, true};
+    s.addAll(elements, true);
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        s.add(2 * i + 1);
+    }
+
+    EXPECT_EQ(2000, s.size());
+    EXPECT_LE(s.height(), 15);
+
+    s.freeze();
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        EXPECT_TRUE(s.contains(i));
+    }
+
+    EXPECT_FALSE(s.contains(2000));
+}
+
+
+TEST(AVLSet_ExtensionTests, visitFromStartsAtLowAndStopsWhenAsked)
+{
+    AVLSet<int> s;
+
+    for (int i = 0; i < 100; ++i)
+    {
+        s.add(2 * i);
+    }
+
+    std::vector<int> visited;
+    std::size_t count = s.visitFrom(
+        51, [&](const int& element) { visited.push_back(element); return element < 58; });
+
+    EXPECT_EQ((std::vector<int>{52, 54, 56, 58}), visited);
+    EXPECT_EQ(4, count);
+    EXPECT_EQ(0, s.visitFrom(199, [](const int&) { return true; }));
+    EXPECT_EQ(100, s.visitFrom(-5, [](const int&) { return true; }));
+}
+
+
+TEST(AVLSet_ExtensionTests, visitRangeIsHalfOpenAndHonorsLimit)
+{
+    AVLSet<int> s{false};
+
+    for (int i : {50, 20, 80, 10, 30, 70, 90, 60, 40})
+    {
+        s.add(i);
+    }
+
+    std::vector<int> visited;
+    auto collect = [&](const int& element) { visited.push_back(element); };
+
+    EXPECT_EQ(4, s.visitRange(20, 60, collect));
+    EXPECT_EQ((std::vector<int>{20, 30, 40, 50}), visited);
+
+    visited.clear();
+    EXPECT_EQ(2, s.visitRange(35, 100, collect, 2));
+    EXPECT_EQ((std::vector<int>{40, 50}), visited);
+
+    EXPECT_EQ(0, s.visitRange(60, 60, collect));
+    EXPECT_EQ(0, s.visitRange(0, 100, collect, 0));
+}
+
+
+TEST(AVLSet_ExtensionTests, visitPrefixFindsOnlyMatchingWords)
+{
+    AVLSet<std::string> s{true, true};
+
+    for (const char* word : {"INTER", "INTERN", "INTERNAL", "INTERVAL", "INTO", "INSIDE", "INTEREST", "JOLT"})
+    {
+        s.add(word);
+    }
+
+    s.freeze();
+
+    std::vector<std::string> visited;
+    auto collect = [&](const std::string& word) { visited.push_back(word); };
+
+    EXPECT_EQ(5, s.visitPrefix("INTER", collect));
+    EXPECT_EQ((std::vector<std::string>{"INTER", "INTEREST", "INTERN", "INTERNAL", "INTERVAL"}), visited);
+
+    visited.clear();
+    EXPECT_EQ(2, s.visitPrefix("INTERN", collect, 5));
+    EXPECT_EQ((std::vector<std::string>{"INTERN", "INTERNAL"}), visited);
+
+    visited.clear();
+    EXPECT_EQ(3, s.visitPrefix("IN", collect, 3));
+    EXPECT_EQ((std::vector<std::string>{"INSIDE", "INTER", "INTEREST"}), visited);
+
+    EXPECT_EQ(0, s.visitPrefix("INTERNS", collect));
+    EXPECT_EQ(0, s.visitPrefix("K", collect));
+    EXPECT_EQ(8, s.visitPrefix("", collect));
+}
+
+
+TEST(AVLSet_ExtensionTests, internedSetVisitsPrefixThroughOrderedSet)
+{
+    AVLSet<std::string, ArenaNodeAllocator, InternedKeys> s;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        s.add("WORD" + std::to_string(i));
+    }
+
+    const OrderedSet<std::string>& ordered = s;
+
+    std::vector<std::string> visited;
+    EXPECT_EQ(11, ordered.visitPrefix("WORD99", [&](const std::string& word) { visited.push_back(word); }));
+    EXPECT_EQ("WORD99", visited.front());
+    EXPECT_EQ("WORD999", visited.back());
+}
+
+
+TEST(AVLSet_ExtensionTests, iteratorsWalkElementsInAscendingOrder)
+{
+    AVLSet<int> empty;
+    EXPECT_TRUE(empty.begin() == empty.end());
+
+    std::vector<int> elements(5000);
+
+    for (int i = 0; i < 5000; ++i)
+    {
+        elements[i] = i * 2;
+    }
+
+    std::shuffle(elements.begin(), elements.end(), std::mt19937{46});
+
+    AVLSet<int> s;
+
+    for (int element : elements)
+    {
+        s.add(element);
+    }
+
+    std::sort(elements.begin(), elements.end());
+
+    std::vector<int> walked;
+
+    for (int element : s)
+    {
+        walked.push_back(element);
+    }
+
+    EXPECT_EQ(elements, walked);
+    EXPECT_EQ(elements, std::vector<int>(s.begin(), s.end()));
+
+    AVLSet<int>::const_iterator i = s.begin();
+    AVLSet<int>::const_iterator previous = i++;
+    EXPECT_EQ(0, *previous);
+    EXPECT_EQ(2, *i);
+}
+
+
+TEST(AVLSet_ExtensionTests, lowerBoundFindsSmallestElementNotLess)
+{
+    AVLSet<int> s;
+
+    for (int i = 0; i < 100; ++i)
+    {
+        s.add(i * 10);
+    }
+
+    EXPECT_EQ(0, *s.lowerBound(-5));
+    EXPECT_EQ(500, *s.lowerBound(500));
+    EXPECT_EQ(510, *s.lowerBound(501));
+    EXPECT_TRUE(s.lowerBound(991) == s.end());
+
+    std::vector<int> tail(s.lowerBound(955), s.end());
+    EXPECT_EQ((std::vector<int>{960, 970, 980, 990}), tail);
+}
+
+
+TEST(AVLSet_ExtensionTests, templatedVisitorsMatchVisitFunctions)
+{
+    std::vector<int> elements(1000);
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        elements[i] = i;
+    }
+
+    std::shuffle(elements.begin(), elements.end(), std::mt19937{46});
+
+    AVLSet<int> s;
+
+    for (int element : elements)
+    {
+        s.add(element);
+    }
+
+    std::vector<int> expected;
+    std::vector<int> visited;
+    AVLSet<int>::VisitFunction collectExpected = [&](const int& element) { expected.push_back(element); };
+    auto collect = [&](const int& element) { visited.push_back(element); };
+
+    s.preorder(collectExpected);
+    s.preorder(collect);
+    EXPECT_EQ(expected, visited);
+    EXPECT_EQ(1000, visited.size());
+
+    expected.clear();
+    visited.clear();
+    s.postorder(collectExpected);
+    s.postorder(collect);
+    EXPECT_EQ(expected, visited);
+    EXPECT_EQ(1000, visited.size());
+
+    expected.clear();
+    visited.clear();
+    s.inorder(collectExpected);
+    s.inorder(collect);
+    EXPECT_EQ(expected, visited);
+    EXPECT_TRUE(std::is_sorted(visited.begin(), visited.end()));
+}
+
+
+TEST(AVLSet_ExtensionTests, traversalsOfVeryTallUnbalancedTreeDoNotRecurse)
+{
+    // adding in descending order leaves one long branch to the left, far
+    // taller than any balanced tree, whose walks have to come back up
+    // through every node
+    AVLSet<int> s{false};
+
+    for (int i = 5000; i > 0; --i)
+    {
+        s.add(i);
+    }
+
+    EXPECT_EQ(4999, s.height());
+
+    std::vector<int> ascending;
+    std::vector<int> descending;
+
+    for (int i = 1; i <= 5000; ++i)
+    {
+        ascending.push_back(i);
+        descending.push_back(5001 - i);
+    }
+
+    std::vector<int> visited;
+    s.inorder([&](const int& element) { visited.push_back(element); });
+    EXPECT_EQ(ascending, visited);
+
+    visited.clear();
+    s.preorder([&](const int& element) { visited.push_back(element); });
+    EXPECT_EQ(descending, visited);
+
+    visited.clear();
+    s.postorder([&](const int& element) { visited.push_back(element); });
+    EXPECT_EQ(ascending, visited);
+
+    AVLSet<int>::const_iterator i = s.lowerBound(2500);
+    AVLSet<int>::const_iterator copy = i;
+    EXPECT_EQ(2500, *copy++);
+    EXPECT_EQ(2501, *copy);
+    EXPECT_EQ(2500, *i);
+    EXPECT_EQ(2501, std::distance(i, s.end()));
+}
+
+
+TEST(AVLSet_ExtensionTests, veryTallUnbalancedTreeCanBeCopiedAndFrozen)
+{
+    // adding from both ends toward the middle leaves a zigzag, each node
+    // with a child on the side the previous one didn't have, so copying
+    // it has a right subtree pending at every level
+    AVLSet<int> s{false, true};
+
+    for (int low = 1, high = 5000; low < high; ++low, --high)
+    {
+        s.add(low);
+        s.add(high);
+    }
+
+    EXPECT_EQ(4999, s.height());
+
+    AVLSet<int> copy{s};
+    EXPECT_EQ(4999, copy.height());
+
+    std::vector<int> original;
+    std::vector<int> copied;
+    s.preorder([&](const int& element) { original.push_back(element); });
+    copy.preorder([&](const int& element) { copied.push_back(element); });
+    EXPECT_EQ(original, copied);
+
+    copy.freeze();
+    EXPECT_TRUE(copy.isFrozen());
+
+    for (int i = 0; i <= 5001; ++i)
+    {
+        EXPECT_EQ(i >= 1 && i <= 5000, copy.contains(i));
+    }
+
+    s = copy;
+    EXPECT_EQ(5000, s.size());
+    EXPECT_TRUE(s.isFrozen());
+}
+
+
+TEST(AVLSet_ExtensionTests, internedSetIteratesOverItsWords)
+{
+    AVLSet<std::string, ArenaNodeAllocator, InternedKeys> s;
+    s.add("GAMMA");
+    s.add("ALPHA");
+    s.add("BETA");
+
+    std::vector<std::string> walked;
+
+    for (const std::string& word : s)
+    {
+        walked.push_back(word);
+    }
+
+    EXPECT_EQ((std::vector<std::string>{"ALPHA", "BETA", "GAMMA"}), walked);
+    EXPECT_EQ("BETA", *s.lowerBound("B"));
+}
@@ -0,0 +1,226 @@
+// BTreeSet_Tests.cpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+//
+// Unit tests for BTreeSet.  Most of them use nodes small enough that a
+// few thousand elements make a tree several levels tall, so that leaves
+// and inner nodes are split many times over.
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "BTreeSet.hpp"
+#include "KeyStorage.hpp"
+#include "NodeAllocator.hpp"
+#include "OrderedSet.hpp"
+#include "Set.hpp"
+
+
+namespace
+{
+    using SmallTree = BTreeSet<int, HeapNodeAllocator, DirectKeys, 64>;
+
+
+    std::vector<int> visitAll(const OrderedSet<int>& s)
+    {
+        std::vector<int> visited;
+        s.visitFrom(std::numeric_limits<int>::min(), [&](const int& element) { visited.push_back(element); return true; });
+        return visited;
+    }
+}
+
+
+TEST(BTreeSet_Tests, inheritsFromOrderedSet)
+{
+    BTreeSet<std::string> s;
+    Set<std::string>& asSet = s;
+
+    EXPECT_TRUE(asSet.isImplemented());
+    EXPECT_EQ(0, asSet.size());
+    EXPECT_EQ(-1, s.height());
+    EXPECT_FALSE(asSet.contains("ANYTHING"));
+}
+
+
+TEST(BTreeSet_Tests, randomInsertionsAreAllFoundInOrder)
+{
+    std::vector<int> elements(20000);
+
+    for (int i = 0; i < 20000; ++i)
+    {
+        elements[i] = 2 * i;
+    }
+
+    std::shuffle(elements.begin(), elements.end(), std::mt19937{46});
+
+    SmallTree s;
+
+    for (int element : elements)
+    {
+        s.add(element);
+        s.add(element);
+    }
+
+    EXPECT_EQ(20000, s.size());
+    EXPECT_GE(s.height(), 4);
+
+    for (int i = -1; i <= 40000; ++i)
+    {
+        ASSERT_EQ(i >= 0 && i % 2 == 0 && i < 40000, s.contains(i));
+    }
+
+    std::sort(elements.begin(), elements.end());
+    EXPECT_EQ(elements, visitAll(s));
+}
+
+
+TEST(BTreeSet_Tests, ascendingAndDescendingInsertionsSplitCorrectly)
+{
+    SmallTree ascending;
+    SmallTree descending;
+
+    for (int i = 0; i < 5000; ++i)
+    {
+        ascending.add(i);
+        descending.add(4999 - i);
+    }
+
+    std::vector<int> expected(5000);
+
+    for (int i = 0; i < 5000; ++i)
+    {
+        expected[i] = i;
+    }
+
+    EXPECT_EQ(expected, visitAll(ascending));
+    EXPECT_EQ(expected, visitAll(descending));
+}
+
+
+TEST(BTreeSet_Tests, addAllBuildsFullNodesFromSortedElements)
+{
+    std::vector<int> elements;
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        elements.push_back(i);
+        elements.push_back(i);
+    }
+
+    SmallTree bulk;
+    bulk.addAll(elements, true);
+
+    SmallTree incremental;
+
+    for (int element : elements)
+    {
+        incremental.add(element);
+    }
+
+    EXPECT_EQ(10000, bulk.size());
+    EXPECT_LE(bulk.height(), incremental.height());
+    EXPECT_EQ(visitAll(incremental), visitAll(bulk));
+    EXPECT_TRUE(bulk.contains(9999));
+    EXPECT_FALSE(bulk.contains(10000));
+
+    bulk.add(-1);
+    bulk.add(10000);
+
+    EXPECT_EQ(10002, bulk.size());
+    EXPECT_TRUE(bulk.contains(-1));
+    EXPECT_TRUE(bulk.contains(10000));
+}
+
+
+TEST(BTreeSet_Tests, addAllSortsUnsortedElements)
+{
+    BTreeSet<std::string> s;
+    s.addAll(std::vector<std::string>{"PEAR", "APPLE", "FIG", "APPLE", "BANANA"});
+
+    std::vector<std::string> visited;
+    s.visitRange("B", "G", [&](const std::string& word) { visited.push_back(word); });
+
+    EXPECT_EQ(4, s.size());
+    EXPECT_EQ(0, s.height());
+    EXPECT_EQ((std::vector<std::string>{"BANANA", "FIG"}), visited);
+
+    s.addAll(std::vector<std::string>{"KIWI", "APPLE"});
+
+    EXPECT_EQ(5, s.size());
+    EXPECT_TRUE(s.contains("KIWI"));
+}
+
+
+TEST(BTreeSet_Tests, visitFromStartsInTheMiddleOfALeaf)
+{
+    SmallTree s;
+    std::vector<int> elements;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        elements.push_back(3 * i);
+    }
+
+    s.addAll(elements, true);
+
+    std::vector<int> visited;
+    EXPECT_EQ(3, s.visitRange(100, 110, [&](const int& element) { visited.push_back(element); }));
+    EXPECT_EQ((std::vector<int>{102, 105, 108}), visited);
+
+    EXPECT_EQ(0, s.visitFrom(2998, [](const int&) { return true; }));
+    EXPECT_EQ(5, s.visitFrom(0, [](const int& element) { return element < 12; }));
+}
+
+
+TEST(BTreeSet_Tests, copiesAndMovesAreIndependent)
+{
+    SmallTree s;
+
+    for (int i = 0; i < 3000; ++i)
+    {
+        s.add(i);
+    }
+
+    SmallTree copy{s};
+    copy.add(3000);
+
+    EXPECT_EQ(3000, s.size());
+    EXPECT_FALSE(s.contains(3000));
+    EXPECT_EQ(3001, copy.size());
+
+    SmallTree moved{std::move(copy)};
+    EXPECT_EQ(3001, moved.size());
+    EXPECT_TRUE(moved.contains(3000));
+
+    s = moved;
+    moved = SmallTree{};
+
+    EXPECT_EQ(3001, s.size());
+    EXPECT_EQ(0, moved.size());
+    EXPECT_EQ(3001, visitAll(s).size());
+}
+
+
+TEST(BTreeSet_Tests, internedArenaTreeFindsWordsByPrefix)
+{
+    BTreeSet<std::string, ArenaNodeAllocator, InternedKeys, 128> s;
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        s.add("WORD" + std::to_string(i));
+    }
+
+    s.freeze();
+
+    BTreeSet<std::string, ArenaNodeAllocator, InternedKeys, 128> copy{s};
+
+    std::vector<std::string> visited;
+    EXPECT_EQ(3, copy.visitPrefix("WORD199", [&](const std::string& word) { visited.push_back(word); }, 3));
+    EXPECT_EQ((std::vector<std::string>{"WORD199", "WORD1990", "WORD1991"}), visited);
+    EXPECT_TRUE(copy.contains("WORD0"));
+    EXPECT_FALSE(copy.contains("WORD2000"));
+}
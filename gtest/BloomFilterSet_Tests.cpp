@@ -0,0 +1,171 @@
+// BloomFilterSet_Tests.cpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+//
+// Unit tests for BloomFilterSet.  Most of them wrap a set that counts the
+// lookups that reach it, to check which ones the filter answers itself.
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <gtest/gtest.h>
+#include "AVLSet.hpp"
+#include "BloomFilterSet.hpp"
+#include "HashSet.hpp"
+#include "ListSet.hpp"
+#include "StringHashing.hpp"
+
+
+namespace
+{
+    class CountingSet : public Set<std::string>
+    {
+    public:
+        explicit CountingSet(unsigned int& lookups)
+            : lookups{lookups}
+        {
+        }
+
+        bool isImplemented() const noexcept override { return true; }
+        void add(const std::string& element) override { elements.add(element); }
+        std::size_t size() const noexcept override { return elements.size(); }
+
+        bool contains(const std::string& element) const override
+        {
+            ++lookups;
+            return elements.contains(element);
+        }
+
+    private:
+        unsigned int& lookups;
+        ListSet<std::string> elements;
+    };
+
+
+    using BloomSet = BloomFilterSet<std::string, WordMixHash>;
+    using CountedBloomSet = BloomFilterSet<std::string, WordMixHash, CountedFilterLookups>;
+}
+
+
+TEST(BloomFilterSet_Tests, behavesLikeTheWrappedSet)
+{
+    BloomSet s{std::make_unique<HashSet<std::string, ProductHash>>()};
+    Set<std::string>& ss = s;
+
+    ss.add("HELLO");
+    ss.add("THERE");
+    ss.add("HELLO");
+
+    EXPECT_TRUE(ss.isImplemented());
+    EXPECT_TRUE(ss.contains("HELLO"));
+    EXPECT_TRUE(ss.contains("THERE"));
+    EXPECT_FALSE(ss.contains("BOO"));
+    EXPECT_EQ(2, ss.size());
+}
+
+
+TEST(BloomFilterSet_Tests, neverRulesOutAnElementThatWasAdded)
+{
+    unsigned int lookups = 0;
+    BloomSet s{std::make_unique<CountingSet>(lookups)};
+    s.reserve(2000);
+
+    for (unsigned int i = 0; i < 2000; ++i)
+    {
+        s.add("WORD" + std::to_string(i));
+    }
+
+    for (unsigned int i = 0; i < 2000; ++i)
+    {
+        ASSERT_TRUE(s.contains("WORD" + std::to_string(i)));
+    }
+
+    EXPECT_EQ(2000, lookups);
+}
+
+
+TEST(BloomFilterSet_Tests, answersMostMissesWithoutTheWrappedSet)
+{
+    unsigned int lookups = 0;
+    CountedBloomSet s{std::make_unique<CountingSet>(lookups)};
+    s.reserve(2000);
+
+    for (unsigned int i = 0; i < 2000; ++i)
+    {
+        s.add("WORD" + std::to_string(i));
+    }
+
+    for (unsigned int i = 0; i < 10000; ++i)
+    {
+        ASSERT_FALSE(s.contains("MISS" + std::to_string(i)));
+    }
+
+    EXPECT_EQ(lookups, s.passedLookups());
+    EXPECT_EQ(lookups, s.falsePositives());
+    EXPECT_EQ(10000 - lookups, s.filteredLookups());
+    EXPECT_LT(s.falsePositiveRate(), 0.03);
+}
+
+
+TEST(BloomFilterSet_Tests, spreadsA32BitHashOverEveryBlock)
+{
+    // ProductHash returns 32 bits, so the high bits of its hash are all
+    // zero; only remixing them spreads the elements over the blocks
+    unsigned int lookups = 0;
+    BloomFilterSet<std::string, ProductHash, CountedFilterLookups> s{std::make_unique<CountingSet>(lookups)};
+    s.reserve(2000);
+
+    for (unsigned int i = 0; i < 2000; ++i)
+    {
+        s.add("WORD" + std::to_string(i));
+    }
+
+    for (unsigned int i = 0; i < 10000; ++i)
+    {
+        ASSERT_FALSE(s.contains("MISS" + std::to_string(i)));
+    }
+
+    EXPECT_LT(s.falsePositiveRate(), 0.03);
+}
+
+
+TEST(BloomFilterSet_Tests, lookupsAreOnlyCountedWhenAskedFor)
+{
+    BloomSet s{std::make_unique<HashSet<std::string, ProductHash>>()};
+
+    s.add("HELLO");
+    EXPECT_TRUE(s.contains("HELLO"));
+    EXPECT_FALSE(s.contains("BOO"));
+
+    EXPECT_EQ(0, s.filteredLookups());
+    EXPECT_EQ(0, s.passedLookups());
+    EXPECT_EQ(0, s.falsePositives());
+
+    std::ostringstream out;
+    s.printStatistics(out);
+    EXPECT_EQ(std::string::npos, out.str().find("lookups"));
+}
+
+
+TEST(BloomFilterSet_Tests, reserveSizesTheFilter)
+{
+    BloomSet s{std::make_unique<HashSet<std::string, ProductHash>>()};
+    EXPECT_EQ(BloomSet::DEFAULT_BLOCK_COUNT, s.blockCount());
+
+    s.reserve(51200);
+    EXPECT_EQ(51200 * BloomSet::BITS_PER_ELEMENT / 512, s.blockCount());
+}
+
+
+TEST(BloomFilterSet_Tests, buildsInBulkWhenTheWrappedSetDoes)
+{
+    BloomSet hashed{std::make_unique<HashSet<std::string, ProductHash>>()};
+    EXPECT_FALSE(hashed.buildsInBulk());
+
+    BloomSet tree{std::make_unique<AVLSet<std::string>>()};
+    EXPECT_TRUE(tree.buildsInBulk());
+
+    tree.add("HELLO");
+    EXPECT_FALSE(tree.buildsInBulk());
+}
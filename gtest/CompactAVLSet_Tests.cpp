@@ -0,0 +1,291 @@
+// CompactAVLSet_Tests.cpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+//
+// Unit tests for CompactAVLSet.  Most of them are run against both of its
+// node layouts, which should behave identically.
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "AVLSet.hpp"
+#include "CompactAVLSet.hpp"
+#include "KeyStorage.hpp"
+#include "OrderedSet.hpp"
+#include "Set.hpp"
+
+
+namespace
+{
+    template <typename SetType>
+    std::vector<int> inorderOf(const SetType& s)
+    {
+        std::vector<int> visited;
+        s.inorder([&](const int& element) { visited.push_back(element); });
+        return visited;
+    }
+
+
+    template <typename NodeLayout>
+    void checkRandomInsertion()
+    {
+        std::vector<int> elements(50000);
+
+        for (int i = 0; i < 50000; ++i)
+        {
+            elements[i] = i * 2;
+        }
+
+        std::shuffle(elements.begin(), elements.end(), std::mt19937{46});
+
+        CompactAVLSet<int, DirectKeys, NodeLayout> s;
+
+        for (int element : elements)
+        {
+            s.add(element);
+            s.add(element);
+        }
+
+        // an AVL tree of n nodes is less than 1.45 * log2(n + 2) tall
+        EXPECT_LE(s.height(), 22);
+        EXPECT_EQ(50000, s.size());
+
+        for (int i = 0; i < 100000; ++i)
+        {
+            EXPECT_EQ(i % 2 == 0, s.contains(i));
+        }
+
+        std::sort(elements.begin(), elements.end());
+        EXPECT_EQ(elements, inorderOf(s));
+    }
+
+
+    template <typename NodeLayout>
+    void checkBulkBuildThenAdd()
+    {
+        std::vector<int> elements;
+
+        for (int i = 0; i < 1023; ++i)
+        {
+            elements.push_back(i * 2);
+        }
+
+        std::vector<int> shuffled{elements};
+        shuffled.insert(shuffled.end(), elements.begin(), elements.begin() + 100);
+        std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937{46});
+
+        CompactAVLSet<int, DirectKeys, NodeLayout> s;
+        s.addAll(shuffled);
+
+        EXPECT_EQ(1023, s.size());
+        EXPECT_EQ(9, s.height());
+        EXPECT_EQ(elements, inorderOf(s));
+
+        // adding afterward rebalances the bulk-built tree as usual
+        for (int i = 0; i < 1023; ++i)
+        {
+            s.add(i * 2 + 1);
+        }
+
+        s.freeze();
+
+        EXPECT_EQ(2046, s.size());
+        EXPECT_LE(s.height(), 15);
+
+        for (int i = 0; i < 2046; ++i)
+        {
+            EXPECT_TRUE(s.contains(i));
+        }
+
+        EXPECT_FALSE(s.contains(2046));
+        EXPECT_FALSE(s.contains(-1));
+    }
+}
+
+
+TEST(CompactAVLSet_Tests, inheritsFromOrderedSet)
+{
+    CompactAVLSet<std::string> s;
+    Set<std::string>& asSet = s;
+    asSet.add("ALPHA");
+
+    EXPECT_TRUE(asSet.isImplemented());
+    EXPECT_TRUE(asSet.contains("ALPHA"));
+    EXPECT_FALSE(asSet.contains("BETA"));
+    EXPECT_EQ(1, asSet.size());
+    EXPECT_EQ(0, s.height());
+
+    CompactAVLSet<std::string> empty;
+    EXPECT_EQ(-1, empty.height());
+    EXPECT_FALSE(empty.contains("ALPHA"));
+}
+
+
+TEST(CompactAVLSet_Tests, interleavedNodesStayBalancedUnderRandomInsertion)
+{
+    checkRandomInsertion<InterleavedNodes>();
+}
+
+
+TEST(CompactAVLSet_Tests, splitNodesStayBalancedUnderRandomInsertion)
+{
+    checkRandomInsertion<SplitNodes>();
+}
+
+
+TEST(CompactAVLSet_Tests, interleavedNodesBuildInBulkThenGrow)
+{
+    checkBulkBuildThenAdd<InterleavedNodes>();
+}
+
+
+TEST(CompactAVLSet_Tests, splitNodesBuildInBulkThenGrow)
+{
+    checkBulkBuildThenAdd<SplitNodes>();
+}
+
+
+TEST(CompactAVLSet_Tests, ascendingInsertionStillBalances)
+{
+    CompactAVLSet<int, DirectKeys, SplitNodes> s;
+
+    for (int i = 0; i < 4095; ++i)
+    {
+        s.add(i);
+    }
+
+    EXPECT_EQ(11, s.height());
+    EXPECT_TRUE(s.contains(0));
+    EXPECT_TRUE(s.contains(4094));
+    EXPECT_FALSE(s.contains(4095));
+}
+
+
+TEST(CompactAVLSet_Tests, nodesAreSmallerThanAVLSetNodes)
+{
+    // a key, two 32-bit links and an 8-bit height, padded out to the
+    // key's alignment only when they're interleaved
+    EXPECT_EQ(sizeof(std::string) + 16, InterleavedNodes::Nodes<std::string>::NODE_BYTES);
+    EXPECT_EQ(sizeof(std::string) + 9, SplitNodes::Nodes<std::string>::NODE_BYTES);
+    EXPECT_LT(InterleavedNodes::Nodes<std::string>::NODE_BYTES, sizeof(Node<std::string>));
+
+    CompactAVLSet<std::string, DirectKeys, SplitNodes> s;
+    s.reserve(1000);
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        s.add("WORD" + std::to_string(i));
+    }
+
+    s.freeze();
+    EXPECT_EQ(1000 * SplitNodes::Nodes<std::string>::NODE_BYTES, s.nodeBytes());
+}
+
+
+TEST(CompactAVLSet_Tests, visitsRangesAndPrefixes)
+{
+    CompactAVLSet<std::string> s;
+    s.addAll({"INTEREST", "INSIDE", "INTER", "INN", "INTERN", "IN", "JAM", "HAT"});
+
+    std::vector<std::string> visited;
+    auto collect = [&](const std::string& word) { visited.push_back(word); };
+
+    EXPECT_EQ(3, s.visitPrefix("INTER", collect));
+    EXPECT_EQ((std::vector<std::string>{"INTER", "INTEREST", "INTERN"}), visited);
+
+    visited.clear();
+    EXPECT_EQ(2, s.visitRange("INN", "INTER", collect));
+    EXPECT_EQ((std::vector<std::string>{"INN", "INSIDE"}), visited);
+
+    visited.clear();
+    EXPECT_EQ(2, s.visitRange("A", "Z", collect, 2));
+    EXPECT_EQ((std::vector<std::string>{"HAT", "IN"}), visited);
+
+    EXPECT_EQ(0, s.visitPrefix("K", collect));
+}
+
+
+TEST(CompactAVLSet_Tests, internedKeysCompareAgainstThePool)
+{
+    CompactAVLSet<std::string, InternedKeys, SplitNodes> s;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        s.add("WORD" + std::to_string(i));
+    }
+
+    s.freeze();
+
+    EXPECT_EQ(1000, s.size());
+    EXPECT_TRUE(s.contains("WORD0"));
+    EXPECT_TRUE(s.contains("WORD999"));
+    EXPECT_FALSE(s.contains("WORD1000"));
+
+    const OrderedSet<std::string>& ordered = s;
+
+    std::vector<std::string> visited;
+    EXPECT_EQ(11, ordered.visitPrefix("WORD99", [&](const std::string& word) { visited.push_back(word); }));
+    EXPECT_EQ("WORD99", visited.front());
+    EXPECT_EQ("WORD999", visited.back());
+}
+
+
+TEST(CompactAVLSet_Tests, copiesAreIndependent)
+{
+    CompactAVLSet<int> s;
+
+    for (int i = 0; i < 100; ++i)
+    {
+        s.add(i);
+    }
+
+    CompactAVLSet<int> copy{s};
+    copy.add(100);
+    s.add(-1);
+
+    EXPECT_EQ(101, copy.size());
+    EXPECT_TRUE(copy.contains(100));
+    EXPECT_FALSE(copy.contains(-1));
+    EXPECT_FALSE(s.contains(100));
+
+    CompactAVLSet<int> moved{std::move(copy)};
+    EXPECT_EQ(101, moved.size());
+    EXPECT_TRUE(moved.contains(100));
+}
+
+
+TEST(CompactAVLSet_Tests, movedFromSetIsEmptyAndUsable)
+{
+    CompactAVLSet<int, DirectKeys, SplitNodes> s;
+
+    for (int i = 0; i < 100; ++i)
+    {
+        s.add(i);
+    }
+
+    CompactAVLSet<int, DirectKeys, SplitNodes> moved{std::move(s)};
+
+    EXPECT_EQ(100, moved.size());
+    EXPECT_EQ(0, s.size());
+    EXPECT_EQ(-1, s.height());
+    EXPECT_FALSE(s.contains(50));
+    EXPECT_TRUE(inorderOf(s).empty());
+
+    s.add(7);
+    EXPECT_TRUE(s.contains(7));
+    EXPECT_EQ(0, s.height());
+
+    // move assignment leaves the expiring set with the other's contents
+    CompactAVLSet<int, DirectKeys, SplitNodes> assigned;
+    assigned.add(-1);
+    assigned = std::move(s);
+
+    EXPECT_EQ(1, assigned.size());
+    EXPECT_TRUE(assigned.contains(7));
+    EXPECT_EQ(1, s.size());
+    EXPECT_TRUE(s.contains(-1));
+    EXPECT_FALSE(s.contains(7));
+}
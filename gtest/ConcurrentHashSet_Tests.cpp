@@ -0,0 +1,110 @@
+// ConcurrentHashSet_Tests.cpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+//
+// Unit tests for ConcurrentHashSet, including a few that share one set
+// among several threads.
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "ConcurrentHashSet.hpp"
+#include "StringHashing.hpp"
+
+
+TEST(ConcurrentHashSet_Tests, behavesLikeASet)
+{
+    ConcurrentHashSet<std::string, ProductHash> s;
+    Set<std::string>& ss = s;
+
+    ss.add("HELLO");
+    ss.add("THERE");
+    ss.add("HELLO");
+
+    EXPECT_TRUE(ss.contains("HELLO"));
+    EXPECT_TRUE(ss.contains("THERE"));
+    EXPECT_FALSE(ss.contains("BOO"));
+    EXPECT_EQ(2, ss.size());
+}
+
+
+TEST(ConcurrentHashSet_Tests, growsAsElementsAreAdded)
+{
+    ConcurrentHashSet<int> s{[](const int& i) { return static_cast<unsigned int>(i); }};
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        s.add(i);
+    }
+
+    EXPECT_EQ(10000, s.size());
+    EXPECT_GE(s.capacity() / 5 * 4, s.size());
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        ASSERT_TRUE(s.contains(i));
+    }
+
+    EXPECT_FALSE(s.contains(10000));
+}
+
+
+TEST(ConcurrentHashSet_Tests, readersSeeEveryElementWhileWritersResize)
+{
+    ConcurrentHashSet<int> s{[](const int& i) { return static_cast<unsigned int>(i); }};
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        s.add(i);
+    }
+
+    std::atomic<bool> stop{false};
+    std::atomic<int> failures{0};
+    std::vector<std::thread> threads;
+
+    for (int r = 0; r < 4; ++r)
+    {
+        threads.emplace_back(
+            [&]()
+            {
+                while (!stop.load())
+                {
+                    for (int i = 0; i < 1000; ++i)
+                    {
+                        if (!s.contains(i))
+                        {
+                            ++failures;
+                        }
+                    }
+                }
+            });
+    }
+
+    for (int w = 0; w < 2; ++w)
+    {
+        threads.emplace_back(
+            [&, w]()
+            {
+                for (int i = 1000 + w; i < 60000; i += 2)
+                {
+                    s.add(i);
+                }
+            });
+    }
+
+    threads[4].join();
+    threads[5].join();
+    stop.store(true);
+
+    for (int r = 0; r < 4; ++r)
+    {
+        threads[r].join();
+    }
+
+    EXPECT_EQ(0, failures.load());
+    EXPECT_EQ(60000, s.size());
+    EXPECT_TRUE(s.contains(59999));
+}
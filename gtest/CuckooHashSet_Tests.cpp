@@ -0,0 +1,142 @@
+// CuckooHashSet_Tests.cpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+//
+// Unit tests for CuckooHashSet.
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <gtest/gtest.h>
+#include "CuckooHashSet.hpp"
+#include "StringHashing.hpp"
+
+
+namespace
+{
+    unsigned int identityHash(const int& i)
+    {
+        return static_cast<unsigned int>(i);
+    }
+
+
+    unsigned int zeroHash(const int& i)
+    {
+        return 0;
+    }
+}
+
+
+TEST(CuckooHashSet_Tests, containsElementsAfterAdding)
+{
+    CuckooHashSet<std::string, ProductHash> s;
+    Set<std::string>& ss = s;
+
+    ss.add("HELLO");
+    ss.add("THERE");
+    ss.add("HELLO");
+
+    EXPECT_TRUE(ss.contains("HELLO"));
+    EXPECT_TRUE(ss.contains("THERE"));
+    EXPECT_FALSE(ss.contains("BOO"));
+    EXPECT_EQ(2, ss.size());
+}
+
+
+TEST(CuckooHashSet_Tests, growsToHoldManyElements)
+{
+    CuckooHashSet<int> s{identityHash};
+
+    for (int i = 0; i < 50000; ++i)
+    {
+        s.add(i);
+    }
+
+    EXPECT_EQ(50000, s.size());
+    EXPECT_LE(s.stashSize(), CuckooHashSet<int>::STASH_SIZE);
+    EXPECT_GE(s.bucketCount() * CuckooHashSet<int>::SLOTS_PER_BUCKET * CuckooHashSet<int>::MAX_LOAD, 50000);
+
+    for (int i = 0; i < 50000; ++i)
+    {
+        ASSERT_TRUE(s.contains(i));
+    }
+
+    EXPECT_FALSE(s.contains(50000));
+    EXPECT_FALSE(s.contains(-1));
+}
+
+
+TEST(CuckooHashSet_Tests, reserveSizesTheBucketsUpFront)
+{
+    CuckooHashSet<int> s{identityHash};
+    s.reserve(10000);
+    unsigned int buckets = s.bucketCount();
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        s.add(i);
+    }
+
+    EXPECT_EQ(buckets, s.bucketCount());
+}
+
+
+TEST(CuckooHashSet_Tests, stillWorksWhenEveryElementHashesTheSame)
+{
+    CuckooHashSet<int> s{zeroHash};
+
+    for (int i = 0; i < 500; ++i)
+    {
+        s.add(i);
+    }
+
+    EXPECT_EQ(500, s.size());
+
+    for (int i = 0; i < 500; ++i)
+    {
+        ASSERT_TRUE(s.contains(i));
+    }
+
+    EXPECT_FALSE(s.contains(500));
+}
+
+
+TEST(CuckooHashSet_Tests, stashIsBoundedAgainAfterASuccessfulResize)
+{
+    // the hash function is degenerate at first, so the stash has to grow
+    // past STASH_SIZE; then it improves, and a resize places everything
+    bool degenerate = true;
+    CuckooHashSet<int> s{[&](const int& i) { return degenerate ? 0u : static_cast<unsigned int>(i); }};
+
+    for (int i = 0; i < 40; ++i)
+    {
+        s.add(i);
+    }
+
+    EXPECT_GT(s.stashSize(), CuckooHashSet<int>::STASH_SIZE);
+
+    degenerate = false;
+    s.reserve(s.bucketCount() * CuckooHashSet<int>::SLOTS_PER_BUCKET);
+    EXPECT_EQ(0, s.stashSize());
+
+    // once the stash is full again, the buckets double rather than the
+    // stash growing any further
+    degenerate = true;
+    std::size_t buckets = s.bucketCount();
+
+    for (std::size_t i = 40; i < 40 + CuckooHashSet<int>::STASH_SIZE + 2 * CuckooHashSet<int>::SLOTS_PER_BUCKET + 1; ++i)
+    {
+        s.add(static_cast<int>(i));
+    }
+
+    EXPECT_GT(s.bucketCount(), buckets);
+}
+
+
+TEST(CuckooHashSet_Tests, cannotReserveMoreThanItsIndexesCanHold)
+{
+    CuckooHashSet<int> s{identityHash};
+    EXPECT_THROW(s.reserve(std::size_t{1} << 33), std::length_error);
+    EXPECT_EQ(CuckooHashSet<int>::DEFAULT_BUCKET_COUNT, s.bucketCount());
+}
@@ -0,0 +1,300 @@
+// HashSet_ExtensionTests.cpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+//
+// Unit tests for the parts of HashSet that go beyond the interface checked
+// by HashSet_SanityCheckTests.cpp.
+
+#include <cstddef>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <gtest/gtest.h>
+#include "HashSet.hpp"
+#include "HasherTraits.hpp"
+#include "KeyStorage.hpp"
+#include "NodeAllocator.hpp"
+#include "StringHashing.hpp"
+
+
+TEST(HashSet_ExtensionTests, canUseFunctionObjectHasher)
+{
+    HashSet<std::string, ProductHash> s;
+    s.add("HELLO");
+    s.add("THERE");
+
+    EXPECT_TRUE(s.contains("HELLO"));
+    EXPECT_TRUE(s.contains("THERE"));
+    EXPECT_FALSE(s.contains("BOO"));
+    EXPECT_EQ(2, s.size());
+
+    unsigned int index = ProductHash{}("HELLO") % 10000;
+    EXPECT_TRUE(s.isElementAtIndex("HELLO", index));
+}
+
+
+TEST(HashSet_ExtensionTests, onlyFunctionObjectHashersCanBeLeftToDefault)
+{
+    EXPECT_FALSE((impl_::CAN_DEFAULT_HASHER<std::function<unsigned int(const std::string&)>>));
+    EXPECT_FALSE((impl_::CAN_DEFAULT_HASHER<unsigned int (*)(const std::string&)>));
+    EXPECT_TRUE((impl_::CAN_DEFAULT_HASHER<ProductHash>));
+
+    EXPECT_FALSE((std::is_default_constructible_v<HashSet<std::string>>));
+    EXPECT_TRUE((std::is_default_constructible_v<HashSet<std::string, ProductHash>>));
+}
+
+
+TEST(HashSet_ExtensionTests, copiesKeepTheirHasher)
+{
+    HashSet<std::string> s1{hashStringAsProduct};
+    s1.add("HELLO");
+
+    HashSet<std::string> s2{s1};
+    s2.add("THERE");
+
+    EXPECT_TRUE(s2.contains("HELLO"));
+    EXPECT_TRUE(s2.contains("THERE"));
+    EXPECT_TRUE(s2.isElementAtIndex("THERE", hashStringAsProduct("THERE") % 10000));
+}
+
+
+TEST(HashSet_ExtensionTests, rehashingKeepsElementsAtTheirNewIndex)
+{
+    HashSet<int> s{[](const int& i) { return static_cast<unsigned int>(i); }};
+
+    for (int i = 0; i < 20000; ++i)
+    {
+        s.add(i);
+    }
+
+    EXPECT_EQ(20000, s.size());
+
+    for (int i = 0; i < 20000; ++i)
+    {
+        ASSERT_TRUE(s.contains(i));
+    }
+
+    EXPECT_FALSE(s.contains(20000));
+    EXPECT_TRUE(s.isElementAtIndex(12345, 12345));
+    EXPECT_EQ(1, s.elementsAtIndex(12345));
+}
+
+
+TEST(HashSet_ExtensionTests, addingDuplicatesDoesNotChangeSize)
+{
+    HashSet<std::string, SumHash> s;
+    s.add("AB");
+    s.add("BA");
+    s.add("AB");
+    s.add("BA");
+
+    EXPECT_EQ(2, s.size());
+}
+
+
+TEST(HashSet_ExtensionTests, canAllocateNodesFromAnArena)
+{
+    HashSet<std::string, ProductHash, ArenaNodeAllocator> s1;
+
+    for (int i = 0; i < 20000; ++i)
+    {
+        s1.add("WORD" + std::to_string(i));
+    }
+
+    HashSet<std::string, ProductHash, ArenaNodeAllocator> s2{s1};
+    s1 = s2;
+
+    EXPECT_EQ(20000, s1.size());
+    EXPECT_TRUE(s1.contains("WORD19999"));
+    EXPECT_TRUE(s2.contains("WORD0"));
+    EXPECT_FALSE(s2.contains("WORD20000"));
+}
+
+
+TEST(HashSet_ExtensionTests, maskedIndexingUsesMixedHashes)
+{
+    HashSet<int, std::function<unsigned int(const int&)>, HeapNodeAllocator, MaskedIndexing> s{
+        [](const int& i) { return static_cast<unsigned int>(i); }};
+
+    for (int i = 0; i < 20000; ++i)
+    {
+        s.add(i);
+    }
+
+    EXPECT_EQ(20000, s.size());
+    EXPECT_TRUE(s.contains(0));
+    EXPECT_TRUE(s.contains(19999));
+    EXPECT_FALSE(s.contains(20000));
+
+    unsigned int index = static_cast<unsigned int>(mixHash(777)) & (32768 - 1);
+    EXPECT_TRUE(s.isElementAtIndex(777, index));
+    EXPECT_FALSE(s.isElementAtIndex(777, index ^ 1));
+}
+
+
+TEST(HashSet_ExtensionTests, maskedIndexingKeepsZeroHashAtIndexZero)
+{
+    HashSet<int, std::function<unsigned int(const int&)>, HeapNodeAllocator, MaskedIndexing> s{
+        [](const int& i) { return 0u; }};
+    s.add(11);
+    s.add(1);
+    s.add(5);
+
+    EXPECT_EQ(3, s.elementsAtIndex(0));
+    EXPECT_EQ(0, s.elementsAtIndex(1));
+    EXPECT_TRUE(s.isElementAtIndex(5, 0));
+}
+
+
+TEST(HashSet_ExtensionTests, indexingHandlesCapacitiesBeyond32Bits)
+{
+    std::size_t fiveBillion = 5000000000ULL;
+
+    EXPECT_EQ(std::size_t{1} << 33, MaskedIndexing::capacityFor(fiveBillion));
+    EXPECT_EQ(fiveBillion, ModuloIndexing::capacityFor(fiveBillion));
+    EXPECT_EQ(4294967296ULL, ModuloIndexing::index(9294967296ULL, fiveBillion));
+    EXPECT_LT(MaskedIndexing::index(~std::size_t{0}, std::size_t{1} << 33), std::size_t{1} << 33);
+}
+
+
+TEST(HashSet_ExtensionTests, incrementalResizeKeepsEveryElementVisible)
+{
+    HashSet<std::string, ProductHash> s{ProductHash{}, HashSetResize::Incremental};
+
+    for (int i = 0; i < 50000; ++i)
+    {
+        s.add("WORD" + std::to_string(i));
+
+        if (i % 97 == 0)
+        {
+            for (int j = 0; j <= i; j += 1013)
+            {
+                ASSERT_TRUE(s.contains("WORD" + std::to_string(j)));
+            }
+        }
+    }
+
+    for (int i = 0; i < 50000; ++i)
+    {
+        s.add("WORD" + std::to_string(i));
+    }
+
+    EXPECT_EQ(50000, s.size());
+
+    HashSet<std::string, ProductHash> copy{s};
+    EXPECT_TRUE(copy.contains("WORD49999"));
+    EXPECT_FALSE(copy.contains("WORD50000"));
+
+    unsigned int total = 0;
+
+    for (unsigned int i = 0; i < 80000; ++i)
+    {
+        total += s.elementsAtIndex(i);
+    }
+
+    EXPECT_EQ(50000, total);
+}
+
+
+TEST(HashSet_ExtensionTests, reserveSizesTheArrayUpFront)
+{
+    HashSet<int> s{[](const int& i) { return static_cast<unsigned int>(i); }};
+    s.reserve(100000);
+
+    for (int i = 0; i < 100000; ++i)
+    {
+        s.add(i);
+    }
+
+    EXPECT_EQ(100000, s.size());
+    EXPECT_TRUE(s.isElementAtIndex(99999, 99999));
+    EXPECT_EQ(0, s.elementsAtIndex(125001));
+    EXPECT_EQ(1, s.elementsAtIndex(0));
+}
+
+
+TEST(HashSet_ExtensionTests, statisticsDescribeTheChains)
+{
+    HashSet<int> s{[](const int& i) { return static_cast<unsigned int>(i % 4); }};
+
+    for (int i = 0; i < 8; ++i)
+    {
+        s.add(i);
+    }
+
+    HashSetStatistics stats = s.statistics();
+
+    EXPECT_EQ(8, stats.size);
+    EXPECT_EQ(ModuloIndexing::INITIAL_CAPACITY, stats.capacity);
+    EXPECT_DOUBLE_EQ(8.0 / ModuloIndexing::INITIAL_CAPACITY, stats.loadFactor);
+    EXPECT_EQ(2, stats.longestChain);
+    ASSERT_EQ(3, stats.chainLengths.size());
+    EXPECT_EQ(ModuloIndexing::INITIAL_CAPACITY - 4, stats.chainLengths[0]);
+    EXPECT_EQ(0, stats.chainLengths[1]);
+    EXPECT_EQ(4, stats.chainLengths[2]);
+}
+
+
+TEST(HashSet_ExtensionTests, statisticsCountProbesPerLookup)
+{
+    HashSet<int, HashSet<int>::HashFunction, HeapNodeAllocator, ModuloIndexing, DirectKeys, CountedLookups> s{
+        [](const int& i) { return 0u; }};
+
+    s.add(1);
+    s.add(2);
+    s.add(3);
+
+    // Newer elements are at the front of the one chain: 3, 2, 1.
+    EXPECT_TRUE(s.contains(3));
+    EXPECT_TRUE(s.contains(1));
+    EXPECT_FALSE(s.contains(4));
+
+    HashSetStatistics stats = s.statistics();
+
+    EXPECT_TRUE(stats.lookupsCounted);
+    EXPECT_EQ(2, stats.successfulLookups);
+    EXPECT_EQ(4, stats.successfulProbes);
+    EXPECT_DOUBLE_EQ(2.0, stats.averageProbesPerSuccess());
+    EXPECT_EQ(1, stats.failedLookups);
+    EXPECT_EQ(3, stats.failedProbes);
+    EXPECT_DOUBLE_EQ(3.0, stats.averageProbesPerFailure());
+}
+
+
+TEST(HashSet_ExtensionTests, lookupsAreOnlyCountedWhenAskedFor)
+{
+    HashSet<int> s{[](const int& i) { return 0u; }};
+
+    s.add(1);
+    EXPECT_TRUE(s.contains(1));
+    EXPECT_FALSE(s.contains(2));
+
+    HashSetStatistics stats = s.statistics();
+
+    EXPECT_FALSE(stats.lookupsCounted);
+    EXPECT_EQ(0, stats.successfulLookups);
+    EXPECT_EQ(0, stats.failedLookups);
+
+    std::ostringstream out;
+    stats.print(out);
+    EXPECT_EQ(std::string::npos, out.str().find("lookups"));
+}
+
+
+TEST(HashSet_ExtensionTests, statisticsCountResizes)
+{
+    HashSet<int> s{[](const int& i) { return static_cast<unsigned int>(i); }};
+    EXPECT_EQ(0, s.statistics().resizeCount);
+
+    for (unsigned int i = 0; i <= ModuloIndexing::INITIAL_CAPACITY * 4 / 5; ++i)
+    {
+        s.add(i);
+    }
+
+    EXPECT_EQ(1, s.statistics().resizeCount);
+
+    s.reserve(ModuloIndexing::INITIAL_CAPACITY * 4);
+    EXPECT_EQ(2, s.statistics().resizeCount);
+}
@@ -0,0 +1,114 @@
+// KeyStorage_Tests.cpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+//
+// Unit tests for StringPool, and for the linked Set implementations when
+// they keep their strings in one with InternedKeys.
+
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "AVLSet.hpp"
+#include "HashSet.hpp"
+#include "KeyStorage.hpp"
+#include "ListSet.hpp"
+#include "NodeAllocator.hpp"
+#include "StringHashing.hpp"
+#include "StringPool.hpp"
+
+
+TEST(KeyStorage_Tests, poolHandlesReferToTheirStringsAsThePoolGrows)
+{
+    StringPool pool;
+    std::vector<StringHandle> handles;
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        handles.push_back(pool.intern("WORD" + std::to_string(i)));
+    }
+
+    handles.push_back(pool.intern(""));
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        EXPECT_EQ("WORD" + std::to_string(i), pool.view(handles[i]));
+        EXPECT_TRUE(pool.equals(handles[i], "WORD" + std::to_string(i)));
+    }
+
+    EXPECT_TRUE(pool.equals(handles.back(), ""));
+    EXPECT_FALSE(pool.equals(handles[1], "WORD10"));
+}
+
+
+TEST(KeyStorage_Tests, poolComparesLikeStdString)
+{
+    StringPool pool;
+    StringHandle apple = pool.intern("APPLE");
+
+    EXPECT_EQ(0, pool.compare("APPLE", apple));
+    EXPECT_LT(pool.compare("APP", apple), 0);
+    EXPECT_LT(pool.compare("AARDVARK", apple), 0);
+    EXPECT_GT(pool.compare("APPLES", apple), 0);
+    EXPECT_GT(pool.compare("B", apple), 0);
+}
+
+
+TEST(KeyStorage_Tests, internedHashSetBehavesLikeDirectHashSet)
+{
+    HashSet<std::string, WordMixHash, HeapNodeAllocator, MaskedIndexing, InternedKeys> s;
+
+    for (int i = 0; i < 20000; ++i)
+    {
+        s.add(std::to_string(i));
+        s.add(std::to_string(i));
+    }
+
+    s.freeze();
+
+    HashSet<std::string, WordMixHash, HeapNodeAllocator, MaskedIndexing, InternedKeys> copy{s};
+    s = copy;
+
+    EXPECT_EQ(20000, s.size());
+    EXPECT_TRUE(s.contains("0"));
+    EXPECT_TRUE(copy.contains("19999"));
+    EXPECT_FALSE(s.contains("20000"));
+    EXPECT_FALSE(s.contains(""));
+}
+
+
+TEST(KeyStorage_Tests, internedAVLSetVisitsWordsInOrder)
+{
+    AVLSet<std::string, ArenaNodeAllocator, InternedKeys> s;
+    std::vector<std::string> words{"PEAR", "APPLE", "FIG", "APPLES", "BANANA", "APP"};
+
+    for (const std::string& word : words)
+    {
+        s.add(word);
+    }
+
+    AVLSet<std::string, ArenaNodeAllocator, InternedKeys> copy{s};
+
+    std::vector<std::string> visited;
+    copy.inorder([&](const std::string& word) { visited.push_back(word); });
+
+    std::vector<std::string> expected{"APP", "APPLE", "APPLES", "BANANA", "FIG", "PEAR"};
+    EXPECT_EQ(expected, visited);
+    EXPECT_TRUE(s.contains("APPLES"));
+    EXPECT_FALSE(s.contains("APPL"));
+}
+
+
+TEST(KeyStorage_Tests, internedListSetIgnoresDuplicates)
+{
+    ListSet<std::string, HeapNodeAllocator, InternedKeys> s;
+    s.add("ALPHA");
+    s.add("BETA");
+    s.add("ALPHA");
+
+    ListSet<std::string, HeapNodeAllocator, InternedKeys> moved{std::move(s)};
+
+    EXPECT_EQ(2, moved.size());
+    EXPECT_TRUE(moved.contains("BETA"));
+    EXPECT_FALSE(moved.contains("GAMMA"));
+}
@@ -0,0 +1,160 @@
+// NodeAllocator_Tests.cpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+//
+// Unit tests for the node allocators, and for the linked Set
+// implementations when they allocate their nodes from an arena or from
+// huge pages.
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "AVLSet.hpp"
+#include "HashSet.hpp"
+#include "HugePages.hpp"
+#include "ListSet.hpp"
+#include "NodeAllocator.hpp"
+
+
+namespace
+{
+    struct CountedNode
+    {
+        static int live;
+
+        CountedNode(int value) : value{value} { ++live; }
+        ~CountedNode() { --live; }
+
+        int value;
+    };
+
+    int CountedNode::live = 0;
+}
+
+
+TEST(NodeAllocator_Tests, arenaDestroysEveryNodeOnRelease)
+{
+    {
+        ArenaNodeAllocator::Pool<CountedNode> pool;
+
+        for (int i = 0; i < 5000; ++i)
+        {
+            EXPECT_EQ(i, pool.create(i)->value);
+        }
+
+        EXPECT_EQ(5000, CountedNode::live);
+
+        pool.releaseAll();
+        EXPECT_EQ(0, CountedNode::live);
+
+        pool.create(1);
+    }
+
+    EXPECT_EQ(0, CountedNode::live);
+}
+
+
+TEST(NodeAllocator_Tests, arenaAVLSetBehavesLikeHeapAVLSet)
+{
+    AVLSet<int, ArenaNodeAllocator> s;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        s.add(i);
+    }
+
+    AVLSet<int, ArenaNodeAllocator> copy{s};
+    s = copy;
+
+    std::vector<int> elements;
+    s.inorder([&](const int& element) { elements.push_back(element); });
+
+    ASSERT_EQ(1000, elements.size());
+    EXPECT_EQ(999, elements.back());
+    EXPECT_TRUE(copy.contains(500));
+    EXPECT_EQ(9, s.height());
+}
+
+
+TEST(NodeAllocator_Tests, arenaListSetSupportsCopyAndMove)
+{
+    ListSet<std::string, ArenaNodeAllocator> s1;
+    s1.add("HELLO");
+    s1.add("THERE");
+
+    ListSet<std::string, ArenaNodeAllocator> s2;
+    s2 = s1;
+
+    ListSet<std::string, ArenaNodeAllocator> s3{std::move(s1)};
+    s3.add("BOO");
+
+    EXPECT_TRUE(s2.contains("HELLO"));
+    EXPECT_FALSE(s2.contains("BOO"));
+    EXPECT_TRUE(s3.contains("THERE"));
+    EXPECT_EQ(3, s3.size());
+}
+
+
+TEST(NodeAllocator_Tests, hugePagePoolDestroysEveryNodeAndGivesBackItsPages)
+{
+    HugePageUsage before = hugePageUsage();
+
+    {
+        HugePageNodeAllocator::Pool<CountedNode> pool;
+
+        // enough nodes that the later slabs are whole huge pages
+        for (int i = 0; i < 500000; ++i)
+        {
+            EXPECT_EQ(i, pool.create(i)->value);
+        }
+
+        EXPECT_EQ(500000, CountedNode::live);
+
+        HugePageUsage during = hugePageUsage();
+        EXPECT_GT(
+            during.explicitBytes + during.transparentBytes + during.ordinaryBytes,
+            before.explicitBytes + before.transparentBytes + before.ordinaryBytes);
+    }
+
+    HugePageUsage after = hugePageUsage();
+    EXPECT_EQ(0, CountedNode::live);
+    EXPECT_EQ(before.explicitBytes, after.explicitBytes);
+    EXPECT_EQ(before.transparentBytes, after.transparentBytes);
+    EXPECT_EQ(before.ordinaryBytes, after.ordinaryBytes);
+}
+
+
+TEST(NodeAllocator_Tests, hugePagesAreAlignedWhenMapped)
+{
+    void* memory = allocateHugePages(3 * HUGE_PAGE_BYTES / 2);
+    std::uint64_t* words = static_cast<std::uint64_t*>(memory);
+    words[0] = 1;
+    words[3 * HUGE_PAGE_BYTES / 2 / sizeof(std::uint64_t) - 1] = 2;
+
+#if defined(__linux__)
+    EXPECT_EQ(0, reinterpret_cast<std::uintptr_t>(memory) % HUGE_PAGE_BYTES);
+#endif
+
+    releaseHugePages(memory, 3 * HUGE_PAGE_BYTES / 2);
+}
+
+
+TEST(NodeAllocator_Tests, hugePageHashSetSurvivesResizesAndCopies)
+{
+    HashSet<int, std::function<unsigned int(const int&)>, HugePageNodeAllocator, MaskedIndexing> s{
+        [](const int& i) { return static_cast<unsigned int>(i); }};
+
+    for (int i = 0; i < 100000; ++i)
+    {
+        s.add(i);
+    }
+
+    auto copy = s;
+
+    EXPECT_EQ(100000, copy.size());
+    EXPECT_TRUE(copy.contains(99999));
+    EXPECT_FALSE(copy.contains(100000));
+}
@@ -0,0 +1,118 @@
+// PackedWordSet_Tests.cpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+//
+// Unit tests for PackedWordSet.
+
+#include <string>
+#include <gtest/gtest.h>
+#include "PackedWordSet.hpp"
+
+
+TEST(PackedWordSet_Tests, inheritFromSet)
+{
+    PackedWordSet s;
+    Set<std::string>& ss = s;
+    EXPECT_EQ(0, ss.size());
+    EXPECT_FALSE(ss.contains("ANYTHING"));
+}
+
+
+TEST(PackedWordSet_Tests, packsShortAndMediumWords)
+{
+    PackedWordSet s;
+    s.add("A");
+    s.add("HELLO");
+    s.add("ABCDEFGHIJKL");
+    s.add("ABCDEFGHIJKLM");
+    s.add("ABCDEFGHIJKLMNOPQRSTUVWX");
+    s.add("DON'T");
+    s.add("WELL-KNOWN");
+
+    EXPECT_EQ(7, s.size());
+    EXPECT_EQ(7, s.packedCount());
+    EXPECT_EQ(0, s.unpackedCount());
+
+    EXPECT_TRUE(s.contains("A"));
+    EXPECT_TRUE(s.contains("HELLO"));
+    EXPECT_TRUE(s.contains("ABCDEFGHIJKL"));
+    EXPECT_TRUE(s.contains("ABCDEFGHIJKLM"));
+    EXPECT_TRUE(s.contains("ABCDEFGHIJKLMNOPQRSTUVWX"));
+    EXPECT_TRUE(s.contains("DON'T"));
+    EXPECT_TRUE(s.contains("WELL-KNOWN"));
+
+    EXPECT_FALSE(s.contains("B"));
+    EXPECT_FALSE(s.contains("HELL"));
+    EXPECT_FALSE(s.contains("HELLOS"));
+    EXPECT_FALSE(s.contains("ABCDEFGHIJKLN"));
+    EXPECT_FALSE(s.contains(""));
+}
+
+
+TEST(PackedWordSet_Tests, wordsThatDoNotPackAreStoredAsStrings)
+{
+    PackedWordSet s;
+    s.add("ABCDEFGHIJKLMNOPQRSTUVWXY");
+    s.add("ROUTE66");
+    s.add("hello");
+    s.add("");
+
+    EXPECT_EQ(4, s.size());
+    EXPECT_EQ(0, s.packedCount());
+    EXPECT_EQ(4, s.unpackedCount());
+
+    EXPECT_TRUE(s.contains("ABCDEFGHIJKLMNOPQRSTUVWXY"));
+    EXPECT_TRUE(s.contains("ROUTE66"));
+    EXPECT_TRUE(s.contains("hello"));
+    EXPECT_TRUE(s.contains(""));
+    EXPECT_FALSE(s.contains("HELLO"));
+    EXPECT_FALSE(s.contains("ROUTE67"));
+}
+
+
+TEST(PackedWordSet_Tests, addingDuplicatesHasNoEffect)
+{
+    PackedWordSet s;
+    s.add("HELLO");
+    s.add("HELLO");
+    s.add("ROUTE66");
+    s.add("ROUTE66");
+
+    EXPECT_EQ(2, s.size());
+}
+
+
+TEST(PackedWordSet_Tests, containsManyWordsAcrossGrowth)
+{
+    PackedWordSet s;
+
+    for (unsigned int i = 0; i < 20000; ++i)
+    {
+        std::string word;
+
+        for (unsigned int n = i + 1; n > 0; n /= 26)
+        {
+            word += static_cast<char>('A' + n % 26);
+        }
+
+        s.add(word);
+        s.add(word + word + word + word + word);
+    }
+
+    EXPECT_EQ(40000, s.size());
+
+    for (unsigned int i = 0; i < 20000; ++i)
+    {
+        std::string word;
+
+        for (unsigned int n = i + 1; n > 0; n /= 26)
+        {
+            word += static_cast<char>('A' + n % 26);
+        }
+
+        ASSERT_TRUE(s.contains(word));
+        ASSERT_TRUE(s.contains(word + word + word + word + word));
+        ASSERT_FALSE(s.contains(word + "-"));
+    }
+}
@@ -0,0 +1,60 @@
+// ParallelSort_Tests.cpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+//
+// Unit tests for parallelSort().
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "ParallelSort.hpp"
+
+
+namespace
+{
+    std::vector<int> shuffledElements(std::size_t count)
+    {
+        std::vector<int> elements(count);
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            elements[i] = static_cast<int>(i / 2);
+        }
+
+        std::shuffle(elements.begin(), elements.end(), std::mt19937{46});
+        return elements;
+    }
+}
+
+
+TEST(ParallelSort_Tests, sortsLikeStdSortWithAnyThreadCount)
+{
+    for (unsigned int threadCount : {1u, 2u, 3u, 4u, 7u})
+    {
+        std::vector<int> elements = shuffledElements(3 * MIN_PARALLEL_SORT_SIZE + 5);
+        std::vector<int> expected = elements;
+        std::sort(expected.begin(), expected.end());
+
+        parallelSort(elements, threadCount);
+
+        EXPECT_EQ(expected, elements);
+    }
+}
+
+
+TEST(ParallelSort_Tests, sortsSmallVectorsOnTheCallingThread)
+{
+    std::vector<std::string> words{"PEAR", "APPLE", "FIG"};
+    parallelSort(words, 4);
+
+    EXPECT_EQ((std::vector<std::string>{"APPLE", "FIG", "PEAR"}), words);
+
+    std::vector<std::string> empty;
+    parallelSort(empty, 4);
+
+    EXPECT_TRUE(empty.empty());
+}
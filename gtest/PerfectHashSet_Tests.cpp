@@ -0,0 +1,115 @@
+// PerfectHashSet_Tests.cpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+//
+// Unit tests for PerfectHashSet.
+
+#include <cstddef>
+#include <string>
+#include <gtest/gtest.h>
+#include "PerfectHashSet.hpp"
+
+
+TEST(PerfectHashSet_Tests, inheritFromSet)
+{
+    PerfectHashSet s;
+    Set<std::string>& ss = s;
+    EXPECT_EQ(0, ss.size());
+    EXPECT_FALSE(ss.contains("ANYTHING"));
+}
+
+
+TEST(PerfectHashSet_Tests, containsElementsAfterFreezing)
+{
+    PerfectHashSet s;
+    s.add("HELLO");
+    s.add("THERE");
+    s.add("BOO");
+    s.freeze();
+
+    EXPECT_TRUE(s.contains("HELLO"));
+    EXPECT_TRUE(s.contains("THERE"));
+    EXPECT_TRUE(s.contains("BOO"));
+    EXPECT_FALSE(s.contains("NOTBOO"));
+    EXPECT_FALSE(s.contains(""));
+    EXPECT_EQ(3, s.size());
+}
+
+
+TEST(PerfectHashSet_Tests, findsWaitingWordsWithoutBuilding)
+{
+    PerfectHashSet s;
+    std::size_t emptyBytes = s.storageBytes();
+
+    s.add("HELLO");
+    s.add("THERE");
+    s.add("HELLO");
+
+    EXPECT_TRUE(s.contains("HELLO"));
+    EXPECT_FALSE(s.contains("BOO"));
+    EXPECT_EQ(2, s.size());
+
+    // neither lookup built the table
+    EXPECT_EQ(emptyBytes, s.storageBytes());
+
+    s.freeze();
+    EXPECT_LT(emptyBytes, s.storageBytes());
+    EXPECT_TRUE(s.contains("THERE"));
+    EXPECT_EQ(2, s.size());
+}
+
+
+TEST(PerfectHashSet_Tests, addingDuplicatesHasNoEffect)
+{
+    PerfectHashSet s;
+    s.add("HELLO");
+    s.add("HELLO");
+    s.freeze();
+    s.add("HELLO");
+
+    EXPECT_EQ(1, s.size());
+}
+
+
+TEST(PerfectHashSet_Tests, canAddAfterFreezing)
+{
+    PerfectHashSet s;
+    s.add("HELLO");
+    s.freeze();
+    s.add("THERE");
+
+    EXPECT_TRUE(s.contains("HELLO"));
+    EXPECT_TRUE(s.contains("THERE"));
+    EXPECT_EQ(2, s.size());
+
+    s.freeze();
+
+    EXPECT_TRUE(s.contains("HELLO"));
+    EXPECT_TRUE(s.contains("THERE"));
+    EXPECT_EQ(2, s.size());
+}
+
+
+TEST(PerfectHashSet_Tests, findsEveryOneOfManyWords)
+{
+    PerfectHashSet s;
+
+    for (unsigned int i = 0; i < 20000; ++i)
+    {
+        s.add("WORD" + std::to_string(i));
+    }
+
+    s.freeze();
+
+    ASSERT_EQ(20000, s.size());
+
+    for (unsigned int i = 0; i < 20000; ++i)
+    {
+        ASSERT_TRUE(s.contains("WORD" + std::to_string(i)));
+        ASSERT_FALSE(s.contains("DROW" + std::to_string(i)));
+    }
+
+    // The hash function itself should take only a few bits per word.
+    EXPECT_LT(s.hashFunctionBits() / 20000.0, 8.0);
+}
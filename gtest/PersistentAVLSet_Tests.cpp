@@ -0,0 +1,191 @@
+// PersistentAVLSet_Tests.cpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+//
+// Unit tests for PersistentAVLSet, checking in particular that versions
+// share their nodes until they're added to, and that adding to one
+// version never changes what another one contains.
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "PersistentAVLSet.hpp"
+
+
+namespace
+{
+    std::vector<int> elementsOf(const PersistentAVLSet<int>& s)
+    {
+        std::vector<int> elements;
+        s.inorder([&](const int& element) { elements.push_back(element); });
+        return elements;
+    }
+}
+
+
+TEST(PersistentAVLSet_Tests, staysBalancedUnderRandomInsertion)
+{
+    std::vector<int> elements(50000);
+
+    for (int i = 0; i < 50000; ++i)
+    {
+        elements[i] = i;
+    }
+
+    std::shuffle(elements.begin(), elements.end(), std::mt19937{46});
+
+    PersistentAVLSet<int> s;
+
+    for (int element : elements)
+    {
+        s.add(element);
+        s.add(element);
+    }
+
+    std::sort(elements.begin(), elements.end());
+
+    EXPECT_EQ(50000, s.size());
+    EXPECT_LE(s.height(), 22);
+    EXPECT_EQ(elements, elementsOf(s));
+    EXPECT_EQ(50000, s.ownedNodeCount());
+}
+
+
+TEST(PersistentAVLSet_Tests, snapshotSharesEveryNode)
+{
+    PersistentAVLSet<int> s;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        s.add(i);
+    }
+
+    PersistentAVLSet<int> snapshot = s.snapshot();
+
+    EXPECT_EQ(0, s.ownedNodeCount());
+    EXPECT_EQ(0, snapshot.ownedNodeCount());
+
+    // adding what's already there copies nothing
+    s.add(500);
+    EXPECT_EQ(0, s.ownedNodeCount());
+
+    // adding something new copies only the path to it
+    s.add(1000);
+    EXPECT_GE(s.ownedNodeCount(), 1);
+    EXPECT_LE(s.ownedNodeCount(), s.height() + 2);
+
+    EXPECT_EQ(1001, s.size());
+    EXPECT_EQ(1000, snapshot.size());
+    EXPECT_TRUE(s.contains(1000));
+    EXPECT_FALSE(snapshot.contains(1000));
+}
+
+
+TEST(PersistentAVLSet_Tests, everyVersionKeepsItsOwnContents)
+{
+    std::vector<PersistentAVLSet<int>> versions(1);
+
+    for (int i = 0; i < 300; ++i)
+    {
+        // each version is the one before it with one more element, added
+        // in an order that makes plenty of rotations
+        PersistentAVLSet<int> next = versions.back();
+        next.add((i * 7919) % 300);
+        versions.push_back(std::move(next));
+    }
+
+    for (int v = 0; v <= 300; ++v)
+    {
+        ASSERT_EQ(v, versions[v].size());
+
+        for (int i = 0; i < 300; ++i)
+        {
+            int position = 0;
+
+            while (position < 300 && (position * 7919) % 300 != i)
+            {
+                ++position;
+            }
+
+            ASSERT_EQ(position < v, versions[v].contains(i));
+        }
+    }
+
+    // all of the versions but the last can be discarded in any order
+    std::shuffle(versions.begin(), versions.end() - 1, std::mt19937{46});
+    versions.erase(versions.begin(), versions.end() - 1);
+
+    EXPECT_EQ(300, versions.back().ownedNodeCount());
+    EXPECT_EQ(300, elementsOf(versions.back()).size());
+}
+
+
+TEST(PersistentAVLSet_Tests, copiesAndMovesShareOrTakeTheTree)
+{
+    PersistentAVLSet<std::string> s;
+    s.add("BETA");
+    s.add("ALPHA");
+
+    PersistentAVLSet<std::string> copy{s};
+    PersistentAVLSet<std::string> moved{std::move(s)};
+
+    EXPECT_EQ(0, s.size());
+    EXPECT_EQ(2, moved.size());
+    EXPECT_EQ(0, moved.ownedNodeCount());
+
+    copy = copy;
+    copy.add("GAMMA");
+    moved = copy;
+
+    EXPECT_TRUE(moved.contains("GAMMA"));
+    EXPECT_EQ(0, moved.ownedNodeCount());
+
+    copy = PersistentAVLSet<std::string>{};
+    EXPECT_EQ(3, moved.ownedNodeCount());
+
+    std::vector<std::string> visited;
+    moved.visitPrefix("", [&](const std::string& word) { visited.push_back(word); }, 2);
+    EXPECT_EQ((std::vector<std::string>{"ALPHA", "BETA"}), visited);
+}
+
+
+TEST(PersistentAVLSet_Tests, readerOfSnapshotIsUnaffectedByConcurrentAdds)
+{
+    PersistentAVLSet<int> s;
+
+    for (int i = 0; i < 20000; i += 2)
+    {
+        s.add(i);
+    }
+
+    PersistentAVLSet<int> snapshot = s.snapshot();
+    bool consistent = true;
+
+    std::thread reader{
+        [&consistent, snapshot]
+        {
+            for (int round = 0; round < 5; ++round)
+            {
+                for (int i = 0; i < 20000; ++i)
+                {
+                    consistent = consistent && (snapshot.contains(i) == (i % 2 == 0));
+                }
+            }
+        }};
+
+    for (int i = 1; i < 20000; i += 2)
+    {
+        s.add(i);
+    }
+
+    snapshot = PersistentAVLSet<int>{};
+    reader.join();
+
+    EXPECT_TRUE(consistent);
+    EXPECT_EQ(20000, s.size());
+    EXPECT_EQ(20000, s.ownedNodeCount());
+}
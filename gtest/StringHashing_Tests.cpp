@@ -0,0 +1,108 @@
+// StringHashing_Tests.cpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+//
+// Unit tests for the 64-bit string hash functions.  They can't check for
+// particular hash values, since the functions aren't specified that
+// precisely, but they can check for the properties that matter: that
+// every byte of a key of any length affects the hash, and that changing
+// one bit of a key changes about half of the bits of its hash.
+
+#include <bitset>
+#include <set>
+#include <string>
+#include <gtest/gtest.h>
+#include "StringHashing.hpp"
+
+
+namespace
+{
+    template <typename Hasher>
+    void expectEveryByteMatters(std::size_t maxLength)
+    {
+        Hasher hasher;
+
+        for (std::size_t length = 0; length <= maxLength; ++length)
+        {
+            std::string key(length, 'A');
+            std::set<std::uint64_t> hashes{hasher(key)};
+
+            for (std::size_t i = 0; i < length; ++i)
+            {
+                std::string changed = key;
+                changed[i] = 'B';
+                hashes.insert(hasher(changed));
+            }
+
+            ASSERT_EQ(length + 1, hashes.size()) << "length " << length;
+        }
+    }
+
+
+    template <typename Hasher>
+    double averageBitsFlipped(std::size_t length)
+    {
+        Hasher hasher;
+        std::string key;
+
+        for (std::size_t i = 0; i < length; ++i)
+        {
+            key += static_cast<char>('A' + i % 26);
+        }
+
+        std::uint64_t original = hasher(key);
+        double flipped = 0;
+
+        for (std::size_t bit = 0; bit < length * 8; ++bit)
+        {
+            std::string changed = key;
+            changed[bit / 8] ^= static_cast<char>(1 << (bit % 8));
+            flipped += std::bitset<64>{original ^ hasher(changed)}.count();
+        }
+
+        return flipped / (length * 8);
+    }
+}
+
+
+TEST(StringHashing_Tests, functionsMatchTheirFunctionObjects)
+{
+    EXPECT_EQ(WordMixHash{}("HELLO"), hashStringAsWordMix("HELLO"));
+    EXPECT_EQ(StripesHash{}("HELLO"), hashStringAsStripes("HELLO"));
+}
+
+
+TEST(StringHashing_Tests, everyByteAffectsWordMixHash)
+{
+    expectEveryByteMatters<WordMixHash>(300);
+}
+
+
+TEST(StringHashing_Tests, everyByteAffectsStripesHash)
+{
+    expectEveryByteMatters<StripesHash>(1100);
+}
+
+
+TEST(StringHashing_Tests, stripesHashMatchesWordMixForShortKeys)
+{
+    for (std::size_t length = 0; length <= StripesHash::STRIPE_BYTES; ++length)
+    {
+        std::string key(length, 'Q');
+        EXPECT_EQ(WordMixHash{}(key), StripesHash{}(key));
+    }
+}
+
+
+TEST(StringHashing_Tests, oneBitChangesAboutHalfTheHash)
+{
+    for (std::size_t length : {3, 8, 13, 24, 100, 500})
+    {
+        double wordMix = averageBitsFlipped<WordMixHash>(length);
+        double stripes = averageBitsFlipped<StripesHash>(length);
+
+        EXPECT_NEAR(32.0, wordMix, 3.0) << "length " << length;
+        EXPECT_NEAR(32.0, stripes, 3.0) << "length " << length;
+    }
+}
@@ -0,0 +1,123 @@
+// SwissHashSet_SanityCheckTests.cpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+//
+// Sanity-checking unit tests for the SwissHashSet implementation, in the
+// same spirit as the ones provided for the other Set implementations.
+
+#include <string>
+#include <gtest/gtest.h>
+#include "SwissHashSet.hpp"
+
+
+namespace
+{
+    template <typename T>
+    unsigned int zeroHash(const T& t)
+    {
+        return 0;
+    }
+
+
+    unsigned int identityHash(const int& i)
+    {
+        return static_cast<unsigned int>(i);
+    }
+}
+
+
+TEST(SwissHashSet_SanityCheckTests, inheritFromSet)
+{
+    SwissHashSet<int> s1{zeroHash<int>};
+    Set<int>& ss1 = s1;
+    EXPECT_EQ(0, ss1.size());
+
+    SwissHashSet<std::string> s2{zeroHash<std::string>};
+    Set<std::string>& ss2 = s2;
+    EXPECT_EQ(0, ss2.size());
+}
+
+
+TEST(SwissHashSet_SanityCheckTests, containsElementsAfterAdding)
+{
+    SwissHashSet<std::string> s{zeroHash<std::string>};
+    s.add("HELLO");
+    s.add("THERE");
+    s.add("BOO");
+
+    EXPECT_TRUE(s.contains("HELLO"));
+    EXPECT_TRUE(s.contains("THERE"));
+    EXPECT_TRUE(s.contains("BOO"));
+    EXPECT_FALSE(s.contains("NOTBOO"));
+    EXPECT_EQ(3, s.size());
+}
+
+
+TEST(SwissHashSet_SanityCheckTests, addingDuplicatesHasNoEffect)
+{
+    SwissHashSet<int> s{identityHash};
+    s.add(11);
+    s.add(11);
+    s.add(5);
+
+    EXPECT_EQ(2, s.size());
+}
+
+
+TEST(SwissHashSet_SanityCheckTests, growsPastSeveralGroups)
+{
+    SwissHashSet<int> s{identityHash};
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        s.add(i * 3);
+    }
+
+    EXPECT_EQ(10000, s.size());
+    EXPECT_GE(s.capacity() / 8 * 7, s.size());
+
+    for (int i = 0; i < 30000; ++i)
+    {
+        EXPECT_EQ(i % 3 == 0, s.contains(i));
+    }
+}
+
+
+TEST(SwissHashSet_SanityCheckTests, canCopyAndMove)
+{
+    SwissHashSet<std::string> s1{zeroHash<std::string>};
+    s1.add("ALPHA");
+    s1.add("BETA");
+
+    SwissHashSet<std::string> s2{s1};
+    EXPECT_TRUE(s2.contains("ALPHA"));
+    EXPECT_EQ(2, s2.size());
+
+    SwissHashSet<std::string> s3{std::move(s1)};
+    EXPECT_TRUE(s3.contains("BETA"));
+
+    s1 = s3;
+    EXPECT_TRUE(s1.contains("BETA"));
+
+    s1.add("GAMMA");
+    s2 = std::move(s1);
+    EXPECT_TRUE(s2.contains("GAMMA"));
+    EXPECT_EQ(3, s2.size());
+}
+
+
+TEST(SwissHashSet_SanityCheckTests, reserveAvoidsGrowth)
+{
+    SwissHashSet<int> s{identityHash};
+    s.reserve(1000);
+    unsigned int reserved = s.capacity();
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        s.add(i);
+    }
+
+    EXPECT_EQ(2048, reserved);
+    EXPECT_EQ(reserved, s.capacity());
+}
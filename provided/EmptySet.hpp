@@ -11,6 +11,7 @@
 #ifndef EMPTYSET_HPP
 #define EMPTYSET_HPP
 
+#include <cstddef>
 #include "Set.hpp"
 
 
@@ -22,7 +23,7 @@ public:
     virtual bool isImplemented() const noexcept override;
     virtual void add(const ElementType& element) override;
     virtual bool contains(const ElementType& element) const override;
-    virtual unsigned int size() const noexcept override;
+    virtual std::size_t size() const noexcept override;
 };
 
 
@@ -47,7 +48,7 @@ bool EmptySet<ElementType>::contains(const ElementType& element) const
 
 
 template <typename ElementType>
-unsigned int EmptySet<ElementType>::size() const noexcept
+std::size_t EmptySet<ElementType>::size() const noexcept
 {
     return 0;
 }
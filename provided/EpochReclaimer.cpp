@@ -0,0 +1,159 @@
+// EpochReclaimer.cpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+
+#include <algorithm>
+#include <utility>
+#include "EpochReclaimer.hpp"
+
+
+
+namespace
+{
+    // Hands out the per-thread slot indexes shared by every
+    // EpochReclaimer, and takes them back when threads exit.
+    class ThreadSlots
+    {
+    public:
+        unsigned int acquire()
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+
+            for (unsigned int i = 0; i < EpochReclaimer::MAX_THREADS; ++i)
+            {
+                if (!used[i])
+                {
+                    used[i] = true;
+                    return i;
+                }
+            }
+
+            throw EpochReclaimer::TooManyThreadsException{};
+        }
+
+        void release(unsigned int index)
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            used[index] = false;
+        }
+
+    private:
+        std::mutex mutex;
+        bool used[EpochReclaimer::MAX_THREADS] = {};
+    };
+
+
+    ThreadSlots& threadSlots()
+    {
+        static ThreadSlots slots;
+        return slots;
+    }
+
+
+    struct ThreadSlot
+    {
+        ThreadSlot()
+            : index{threadSlots().acquire()}
+        {
+        }
+
+        ~ThreadSlot()
+        {
+            threadSlots().release(index);
+        }
+
+        unsigned int index;
+    };
+
+
+    unsigned int currentThreadSlot()
+    {
+        thread_local ThreadSlot slot;
+        return slot.index;
+    }
+}
+
+
+
+EpochReclaimer::Guard::Guard(std::atomic<std::uint64_t>& slot) noexcept
+    : slot{slot}
+{
+}
+
+
+EpochReclaimer::Guard::~Guard() noexcept
+{
+    slot.store(IDLE);
+}
+
+
+
+EpochReclaimer::EpochReclaimer()
+    : globalEpoch{1}
+{
+    for (Slot& slot : slots)
+    {
+        slot.epoch.store(IDLE);
+    }
+}
+
+
+EpochReclaimer::~EpochReclaimer() noexcept
+{
+    for (Retired& r : retired)
+    {
+        r.deleter();
+    }
+}
+
+
+EpochReclaimer::Guard EpochReclaimer::pin()
+{
+    // All of these operations are sequentially consistent.  A reader that
+    // announces an epoch after a writer has scanned the slots must also
+    // load the shared data after the writer unlinked it, so it can only
+    // ever see the new version.
+    std::atomic<std::uint64_t>& slot = slots[currentThreadSlot()].epoch;
+    slot.store(globalEpoch.load());
+    return Guard{slot};
+}
+
+
+void EpochReclaimer::retire(std::function<void()> deleter)
+{
+    std::lock_guard<std::mutex> lock{retiredMutex};
+
+    retired.push_back(Retired{globalEpoch.load(), std::move(deleter)});
+    globalEpoch.fetch_add(1);
+
+    reclaim();
+}
+
+
+void EpochReclaimer::reclaim()
+{
+    std::uint64_t oldestPinned = globalEpoch.load();
+
+    for (Slot& slot : slots)
+    {
+        std::uint64_t epoch = slot.epoch.load();
+
+        if (epoch != IDLE)
+        {
+            oldestPinned = std::min(oldestPinned, epoch);
+        }
+    }
+
+    auto stillVisible = std::partition(
+        retired.begin(), retired.end(),
+        [&](const Retired& r) { return r.epoch >= oldestPinned; });
+
+    for (auto i = stillVisible; i != retired.end(); ++i)
+    {
+        i->deleter();
+    }
+
+    retired.erase(stillVisible, retired.end());
+}
+
@@ -0,0 +1,100 @@
+// EpochReclaimer.hpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+//
+// An EpochReclaimer solves the memory reclamation problem for concurrent
+// data structures whose readers take no locks: when a writer unlinks
+// something (say, the old array of a hash table that has been resized),
+// it can't delete it right away, because a reader may still be looking
+// at it.
+//
+// Readers call pin() before they look at shared data and let the returned
+// Guard go out of scope when they're done.  Pinning is wait-free: it
+// records the current global epoch in a slot belonging to the calling
+// thread.  Writers call retire() with a function that deletes what they
+// unlinked; retire() stamps it with the current epoch, advances the
+// global epoch, and then runs every retired deleter whose stamp is older
+// than the epoch recorded by every pinned reader.  Anything a pinned
+// reader could still see is kept until a later retire() (or until the
+// EpochReclaimer is destroyed).
+//
+// Each thread that pins is given one of MAX_THREADS slots the first time
+// it does so, and gives it back when the thread exits.  A thread must not
+// pin the same EpochReclaimer again while it already holds a Guard for it.
+
+#ifndef EPOCHRECLAIMER_HPP
+#define EPOCHRECLAIMER_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+
+
+class EpochReclaimer
+{
+public:
+    static constexpr unsigned int MAX_THREADS = 256;
+
+    class TooManyThreadsException { };
+
+
+    class Guard
+    {
+    public:
+        explicit Guard(std::atomic<std::uint64_t>& slot) noexcept;
+        ~Guard() noexcept;
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+
+    private:
+        std::atomic<std::uint64_t>& slot;
+    };
+
+
+public:
+    EpochReclaimer();
+
+    // Runs every deleter that is still waiting, so the EpochReclaimer
+    // must outlive any reader that might be pinned to it.
+    ~EpochReclaimer() noexcept;
+
+    EpochReclaimer(const EpochReclaimer&) = delete;
+    EpochReclaimer& operator=(const EpochReclaimer&) = delete;
+
+    Guard pin();
+
+    void retire(std::function<void()> deleter);
+
+
+private:
+    static constexpr std::uint64_t IDLE = 0;
+
+    struct alignas(64) Slot
+    {
+        std::atomic<std::uint64_t> epoch;
+    };
+
+    struct Retired
+    {
+        std::uint64_t epoch;
+        std::function<void()> deleter;
+    };
+
+    void reclaim();
+
+    std::atomic<std::uint64_t> globalEpoch;
+    Slot slots[MAX_THREADS];
+
+    std::mutex retiredMutex;
+    std::vector<Retired> retired;
+};
+
+
+
+#endif // EPOCHRECLAIMER_HPP
+
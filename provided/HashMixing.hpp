@@ -0,0 +1,32 @@
+// HashMixing.hpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+//
+// Hash tables that pick a bucket by taking the low bits of a hash are at
+// the mercy of how well those low bits are distributed, and hash functions
+// like hashStringAsSum distribute them poorly.  mixHash() runs a hash
+// through the 64-bit finalizer from MurmurHash3, so that every bit of the
+// input affects every bit of the output.  It maps 0 to 0.
+
+#ifndef HASHMIXING_HPP
+#define HASHMIXING_HPP
+
+#include <cstdint>
+
+
+
+inline std::uint64_t mixHash(std::uint64_t hash) noexcept
+{
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+
+
+#endif // HASHMIXING_HPP
+
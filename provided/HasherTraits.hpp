@@ -0,0 +1,38 @@
+// HasherTraits.hpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+//
+// The hash-based sets are templated on a Hasher, which defaults to a
+// std::function.  impl_::CAN_DEFAULT_HASHER says whether one of them can
+// construct its own Hasher when it isn't given one.
+
+#ifndef HASHERTRAITS_HPP
+#define HASHERTRAITS_HPP
+
+#include <functional>
+#include <type_traits>
+
+
+
+namespace impl_
+{
+    // Only a function object type can be left to default.  A
+    // default-constructed std::function holds no function at all, and
+    // would throw the first time an element is hashed; a default function
+    // pointer is null.
+    template <typename Hasher>
+    struct IsStdFunction : std::false_type {};
+
+    template <typename Signature>
+    struct IsStdFunction<std::function<Signature>> : std::true_type {};
+
+    template <typename Hasher>
+    inline constexpr bool CAN_DEFAULT_HASHER =
+        std::is_class_v<Hasher> && std::is_default_constructible_v<Hasher> && !IsStdFunction<Hasher>::value;
+}
+
+
+
+#endif // HASHERTRAITS_HPP
+
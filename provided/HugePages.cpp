@@ -0,0 +1,199 @@
+// HugePages.cpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+
+#include <cstdint>
+#include <iomanip>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+#include "HugePages.hpp"
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+
+
+namespace
+{
+    struct Allocation
+    {
+        PageBacking backing;
+        bool mapped;
+    };
+
+
+    // Every allocation is remembered, so that releaseHugePages() knows
+    // how to give it back and which total to take it out of.  Huge page
+    // allocations are few and large, so a locked map costs nothing
+    // noticeable.
+    std::mutex allocationsMutex;
+    std::unordered_map<void*, Allocation> allocations;
+    HugePageUsage usage{0, 0, 0};
+
+
+    std::size_t roundToHugePages(std::size_t bytes) noexcept
+    {
+        return (bytes + HUGE_PAGE_BYTES - 1) / HUGE_PAGE_BYTES * HUGE_PAGE_BYTES;
+    }
+
+
+    std::size_t& bytesWith(PageBacking backing) noexcept
+    {
+        switch (backing)
+        {
+        case PageBacking::Explicit:
+            return usage.explicitBytes;
+        case PageBacking::Transparent:
+            return usage.transparentBytes;
+        default:
+            return usage.ordinaryBytes;
+        }
+    }
+
+
+    void remember(void* memory, std::size_t bytes, Allocation allocation)
+    {
+        std::lock_guard<std::mutex> lock{allocationsMutex};
+        allocations.emplace(memory, allocation);
+        bytesWith(allocation.backing) += bytes;
+    }
+
+
+#if defined(__linux__)
+    void* mapExplicit(std::size_t bytes) noexcept
+    {
+        void* memory = mmap(
+            nullptr, bytes, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+
+        return memory == MAP_FAILED ? nullptr : memory;
+    }
+
+
+    // Maps one huge page more than asked for, then unmaps whatever lies
+    // before the first huge page boundary and after the requested size,
+    // since the kernel can only use a huge page for an aligned 2 MiB range.
+    void* mapAligned(std::size_t bytes) noexcept
+    {
+        std::size_t paddedBytes = bytes + HUGE_PAGE_BYTES;
+
+        void* memory = mmap(
+            nullptr, paddedBytes, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+        if (memory == MAP_FAILED)
+        {
+            return nullptr;
+        }
+
+        std::uintptr_t start = reinterpret_cast<std::uintptr_t>(memory);
+        std::uintptr_t aligned = (start + HUGE_PAGE_BYTES - 1) / HUGE_PAGE_BYTES * HUGE_PAGE_BYTES;
+        std::size_t before = aligned - start;
+        std::size_t after = paddedBytes - before - bytes;
+
+        if (before > 0)
+        {
+            munmap(memory, before);
+        }
+
+        if (after > 0)
+        {
+            munmap(reinterpret_cast<void*>(aligned + bytes), after);
+        }
+
+        return reinterpret_cast<void*>(aligned);
+    }
+#endif
+}
+
+
+
+void HugePageUsage::print(std::ostream& out) const
+{
+    out << std::left << std::fixed << std::setprecision(1);
+    out << std::setw(24) << "Explicit huge pages" << explicitBytes / 1048576.0 << " MiB" << '\n';
+    out << std::setw(24) << "Transparent huge pages" << transparentBytes / 1048576.0 << " MiB" << '\n';
+    out << std::setw(24) << "Ordinary pages" << ordinaryBytes / 1048576.0 << " MiB" << '\n';
+    out << std::right;
+}
+
+
+void* allocateHugePages(std::size_t bytes)
+{
+#if defined(__linux__)
+    if (bytes >= HUGE_PAGE_BYTES / 2)
+    {
+        std::size_t roundedBytes = roundToHugePages(bytes);
+
+        if (void* memory = mapExplicit(roundedBytes))
+        {
+            remember(memory, roundedBytes, Allocation{PageBacking::Explicit, true});
+            return memory;
+        }
+
+        if (void* memory = mapAligned(roundedBytes))
+        {
+            // madvise() fails if transparent huge pages are compiled out
+            // of the kernel; the memory is still perfectly good
+            bool advised = madvise(memory, roundedBytes, MADV_HUGEPAGE) == 0;
+
+            remember(
+                memory, roundedBytes,
+                Allocation{advised ? PageBacking::Transparent : PageBacking::Ordinary, true});
+
+            return memory;
+        }
+
+        throw std::bad_alloc{};
+    }
+#endif
+
+    void* memory = ::operator new(bytes);
+    remember(memory, bytes, Allocation{PageBacking::Ordinary, false});
+    return memory;
+}
+
+
+void releaseHugePages(void* memory, std::size_t bytes) noexcept
+{
+    if (memory == nullptr)
+    {
+        return;
+    }
+
+    Allocation allocation;
+
+    {
+        std::lock_guard<std::mutex> lock{allocationsMutex};
+        auto found = allocations.find(memory);
+        allocation = found->second;
+        allocations.erase(found);
+
+        if (allocation.mapped)
+        {
+            bytes = roundToHugePages(bytes);
+        }
+
+        bytesWith(allocation.backing) -= bytes;
+    }
+
+#if defined(__linux__)
+    if (allocation.mapped)
+    {
+        munmap(memory, bytes);
+        return;
+    }
+#endif
+
+    ::operator delete(memory);
+}
+
+
+HugePageUsage hugePageUsage() noexcept
+{
+    std::lock_guard<std::mutex> lock{allocationsMutex};
+    return usage;
+}
@@ -0,0 +1,76 @@
+// HugePages.hpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+//
+// A random lookup in a large hash table touches a bucket and a node that
+// are unlikely to be on the same 4 KiB page as anything touched recently,
+// so besides a cache miss, it often costs a TLB miss: a walk of the page
+// tables to find where the page is.  Backing the table with 2 MiB pages
+// lets each TLB entry cover 512 times as much memory.
+//
+// allocateHugePages() asks for memory backed by huge pages, trying, in
+// order:
+//
+//     Explicit      an mmap() with MAP_HUGETLB, which only succeeds if
+//                   the administrator has reserved huge pages
+//     Transparent   an ordinary mmap(), aligned to a huge page boundary
+//                   and marked with madvise(MADV_HUGEPAGE), so that the
+//                   kernel backs it with huge pages if it can
+//     Ordinary      operator new, on systems without mmap(), and for
+//                   requests smaller than half a huge page, which aren't
+//                   worth rounding up to a whole one
+//
+// Requests are rounded up to a whole number of huge pages.  Memory must be
+// given back with releaseHugePages(), passing the same size.
+
+#ifndef HUGEPAGES_HPP
+#define HUGEPAGES_HPP
+
+#include <cstddef>
+#include <ostream>
+
+
+
+constexpr std::size_t HUGE_PAGE_BYTES = std::size_t{2} << 20;
+
+
+enum class PageBacking
+{
+    Explicit,
+    Transparent,
+    Ordinary
+};
+
+
+// HugePageUsage is the number of bytes currently allocated by
+// allocateHugePages() with each kind of backing.
+struct HugePageUsage
+{
+    std::size_t explicitBytes;
+    std::size_t transparentBytes;
+    std::size_t ordinaryBytes;
+
+    // print() writes the usage as a few lines in the style of
+    // Set::printStatistics().
+    void print(std::ostream& out) const;
+};
+
+
+// allocateHugePages() returns at least the given number of bytes, aligned
+// to a huge page if they came from mmap().  It throws std::bad_alloc if
+// no memory is available.
+void* allocateHugePages(std::size_t bytes);
+
+
+// releaseHugePages() gives back memory returned by allocateHugePages().
+void releaseHugePages(void* memory, std::size_t bytes) noexcept;
+
+
+// hugePageUsage() reports the memory allocateHugePages() has handed out
+// and not yet had back, by backing.
+HugePageUsage hugePageUsage() noexcept;
+
+
+
+#endif // HUGEPAGES_HPP
@@ -0,0 +1,143 @@
+// KeyStorage.hpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+//
+// Key storage policies decide what a linked Set implementation (HashSet,
+// AVLSet, ListSet) keeps in each node to stand for an element.  Each of
+// those class templates takes a KeyStorage as a template argument and
+// keeps one KeyStorage::Store<ElementType> alongside its nodes.  A Store
+// has this interface:
+//
+//     Key                         the type kept in each node
+//     Key keep(element)           returns the Key to put in a new node
+//     bool equals(key, element)   true if the key stands for the element
+//     int compare(element, key)   orders the element against the key's,
+//                                 returning <0, 0 or >0
+//     element(key)                returns the element a key stands for
+//     void shrinkToFit()          gives back room set aside for keys
+//                                 that haven't been kept yet
+//
+// A Store can be copied along with the Set that owns it; the copy's Keys
+// are the same as the original's.
+//
+// DirectKeys keeps the elements themselves in the nodes, as a Set always
+// used to.  InternedKeys, which only stores std::strings, keeps their
+// characters in a StringPool, so each node holds an 8-byte StringHandle
+// and every string's characters sit end to end in one block of memory.
+
+#ifndef KEYSTORAGE_HPP
+#define KEYSTORAGE_HPP
+
+#include <string>
+#include <type_traits>
+#include "StringPool.hpp"
+
+
+
+// StoredKey<KeyStorage, ElementType> is the type of Key a Set using the
+// given KeyStorage keeps in its nodes.
+template <typename KeyStorage, typename ElementType>
+using StoredKey = typename KeyStorage::template Store<ElementType>::Key;
+
+
+
+struct DirectKeys
+{
+    template <typename ElementType>
+    class Store
+    {
+    public:
+        using Key = ElementType;
+
+        const Key& keep(const ElementType& element) const noexcept
+        {
+            return element;
+        }
+
+        bool equals(const Key& key, const ElementType& element) const
+        {
+            return key == element;
+        }
+
+        // Strings are compared once, with compare(), rather than twice,
+        // with <.
+        int compare(const ElementType& element, const Key& key) const
+        {
+            if constexpr (std::is_same_v<ElementType, std::string>)
+            {
+                return element.compare(key);
+            }
+            else if (element < key)
+            {
+                return -1;
+            }
+            else
+            {
+                return key < element ? 1 : 0;
+            }
+        }
+
+        const ElementType& element(const Key& key) const noexcept
+        {
+            return key;
+        }
+
+        void shrinkToFit() noexcept
+        {
+        }
+    };
+};
+
+
+
+struct InternedKeys
+{
+    template <typename ElementType>
+    class Store
+    {
+        static_assert(
+            std::is_same_v<ElementType, std::string>,
+            "only strings can be interned");
+
+    public:
+        using Key = StringHandle;
+
+        Key keep(const std::string& element)
+        {
+            return pool.intern(element);
+        }
+
+        bool equals(Key key, const std::string& element) const noexcept
+        {
+            return pool.equals(key, element);
+        }
+
+        int compare(const std::string& element, Key key) const noexcept
+        {
+            return pool.compare(element, key);
+        }
+
+        std::string element(Key key) const
+        {
+            return std::string{pool.view(key)};
+        }
+
+        void shrinkToFit()
+        {
+            pool.shrinkToFit();
+        }
+
+        const StringPool& strings() const noexcept
+        {
+            return pool;
+        }
+
+    private:
+        StringPool pool;
+    };
+};
+
+
+
+#endif // KEYSTORAGE_HPP
@@ -5,17 +5,24 @@
 //
 // An implementation of the Set<ElementType> class template, which uses
 // a singly-linked list with a head pointer to store its keys.  The keys
-// are not sorted in any particular order.
+// are not sorted in any particular order.  Nodes are obtained from the
+// given NodeAllocator (see NodeAllocator.hpp), and what each node keeps
+// to stand for its key is up to the given KeyStorage (see KeyStorage.hpp).
 
 #ifndef LISTSET_HPP
 #define LISTSET_HPP
 
 #include <algorithm>
+#include <cstddef>
+#include "KeyStorage.hpp"
+#include "NodeAllocator.hpp"
 #include "Set.hpp"
 
 
 
-template <typename ElementType>
+template <
+    typename ElementType, typename NodeAllocator = HeapNodeAllocator,
+    typename KeyStorage = DirectKeys>
 class ListSet : public Set<ElementType>
 {
 public:
@@ -29,16 +36,19 @@ public:
     virtual bool isImplemented() const noexcept override;
     virtual void add(const ElementType& element) override;
     virtual bool contains(const ElementType& element) const override;
-    virtual unsigned int size() const noexcept override;
+    virtual std::size_t size() const noexcept override;
+    virtual void freeze() override;
 
 private:
     struct Node
     {
-        ElementType element;
+        StoredKey<KeyStorage, ElementType> key;
         Node* next;
     };
 
     Node* head;
+    typename NodeAllocator::template Pool<Node> nodes;
+    typename KeyStorage::template Store<ElementType> keys;
 
 private:
     Node* copyAll(const ListSet& s);
@@ -47,73 +57,78 @@ private:
 
 
 
-template <typename ElementType>
-ListSet<ElementType>::ListSet() noexcept
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+ListSet<ElementType, NodeAllocator, KeyStorage>::ListSet() noexcept
     : head{nullptr}
 {
 }
 
 
-template <typename ElementType>
-ListSet<ElementType>::~ListSet() noexcept
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+ListSet<ElementType, NodeAllocator, KeyStorage>::~ListSet() noexcept
 {
     destroyAll(head);
 }
 
 
-template <typename ElementType>
-ListSet<ElementType>::ListSet(const ListSet& s)
-    : head{nullptr}
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+ListSet<ElementType, NodeAllocator, KeyStorage>::ListSet(const ListSet& s)
+    : head{nullptr}, keys{s.keys}
 {
     head = copyAll(s);
 }
 
 
-template <typename ElementType>
-ListSet<ElementType>::ListSet(ListSet&& s) noexcept
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+ListSet<ElementType, NodeAllocator, KeyStorage>::ListSet(ListSet&& s) noexcept
     : head{nullptr}
 {
     std::swap(head, s.head);
+    std::swap(nodes, s.nodes);
+    std::swap(keys, s.keys);
 }
 
 
-template <typename ElementType>
-ListSet<ElementType>& ListSet<ElementType>::operator=(const ListSet& s)
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+ListSet<ElementType, NodeAllocator, KeyStorage>& ListSet<ElementType, NodeAllocator, KeyStorage>::operator=(const ListSet& s)
 {
     if (this != &s)
     {
-        Node* newHead = copyAll(s);
-        destroyAll(head);
-        head = newHead;
+        ListSet copy{s};
+        std::swap(head, copy.head);
+        std::swap(nodes, copy.nodes);
+        std::swap(keys, copy.keys);
     }
 
     return *this;
 }
 
 
-template <typename ElementType>
-ListSet<ElementType>& ListSet<ElementType>::operator=(ListSet&& s) noexcept
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+ListSet<ElementType, NodeAllocator, KeyStorage>& ListSet<ElementType, NodeAllocator, KeyStorage>::operator=(ListSet&& s) noexcept
 {
     std::swap(head, s.head);
+    std::swap(nodes, s.nodes);
+    std::swap(keys, s.keys);
     return *this;
 }
 
 
-template <typename ElementType>
-bool ListSet<ElementType>::isImplemented() const noexcept
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+bool ListSet<ElementType, NodeAllocator, KeyStorage>::isImplemented() const noexcept
 {
     return true;
 }
 
 
-template <typename ElementType>
-void ListSet<ElementType>::add(const ElementType& element)
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+void ListSet<ElementType, NodeAllocator, KeyStorage>::add(const ElementType& element)
 {
     Node* curr = head;
 
     while (curr != nullptr)
     {
-        if (curr->element == element)
+        if (keys.equals(curr->key, element))
         {
             return;
         }
@@ -121,18 +136,18 @@ void ListSet<ElementType>::add(const ElementType& element)
         curr = curr->next;
     }
 
-    head = new Node{element, head};
+    head = nodes.create(keys.keep(element), head);
 }
 
 
-template <typename ElementType>
-bool ListSet<ElementType>::contains(const ElementType& element) const
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+bool ListSet<ElementType, NodeAllocator, KeyStorage>::contains(const ElementType& element) const
 {
     Node* curr = head;
 
     while (curr != nullptr)
     {
-        if (curr->element == element)
+        if (keys.equals(curr->key, element))
         {
             return true;
         }
@@ -144,11 +159,11 @@ bool ListSet<ElementType>::contains(const ElementType& element) const
 }
 
 
-template <typename ElementType>
-unsigned int ListSet<ElementType>::size() const noexcept
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+std::size_t ListSet<ElementType, NodeAllocator, KeyStorage>::size() const noexcept
 {
     Node* curr = head;
-    unsigned int count = 0;
+    std::size_t count = 0;
 
     while (curr != nullptr)
     {
@@ -160,8 +175,15 @@ unsigned int ListSet<ElementType>::size() const noexcept
 }
 
 
-template <typename ElementType>
-typename ListSet<ElementType>::Node* ListSet<ElementType>::copyAll(const ListSet& s)
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+void ListSet<ElementType, NodeAllocator, KeyStorage>::freeze()
+{
+    keys.shrinkToFit();
+}
+
+
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+typename ListSet<ElementType, NodeAllocator, KeyStorage>::Node* ListSet<ElementType, NodeAllocator, KeyStorage>::copyAll(const ListSet& s)
 {
     Node* curr = s.head;
     Node* newHead = nullptr;
@@ -170,7 +192,7 @@ typename ListSet<ElementType>::Node* ListSet<ElementType>::copyAll(const ListSet
     {
         while (curr != nullptr)
         {
-            newHead = new Node{curr->element, newHead};
+            newHead = nodes.create(curr->key, newHead);
             curr = curr->next;
         }
 
@@ -184,16 +206,23 @@ typename ListSet<ElementType>::Node* ListSet<ElementType>::copyAll(const ListSet
 }
 
 
-template <typename ElementType>
-void ListSet<ElementType>::destroyAll(Node* head) noexcept
+template <typename ElementType, typename NodeAllocator, typename KeyStorage>
+void ListSet<ElementType, NodeAllocator, KeyStorage>::destroyAll(Node* head) noexcept
 {
-    Node* curr = head;
-
-    while (curr != nullptr)
+    if constexpr (decltype(nodes)::RELEASES_IN_BULK)
     {
-        Node* temp = curr;
-        curr = curr->next;
-        delete temp;
+        nodes.releaseAll();
+    }
+    else
+    {
+        Node* curr = head;
+
+        while (curr != nullptr)
+        {
+            Node* temp = curr;
+            curr = curr->next;
+            nodes.destroy(temp);
+        }
     }
 }
 
@@ -0,0 +1,298 @@
+// NodeAllocator.hpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+//
+// Node allocators decide where the nodes of a linked Set implementation
+// (HashSet, AVLSet, ListSet) come from.  Each of those class templates
+// takes a NodeAllocator as a template argument and keeps one
+// NodeAllocator::Pool<NodeType> for its own nodes.  A Pool has this
+// interface:
+//
+//     NodeType* create(args...)   constructs a node from the arguments
+//     void destroy(NodeType*)     gives an individual node back
+//     void releaseAll()           destroys every node created so far
+//     RELEASES_IN_BULK            true if releaseAll() alone is enough to
+//                                 clean up, so a Set can skip visiting
+//                                 its nodes one at a time on teardown
+//
+// A NodeAllocator also has two static member functions for the large
+// arrays some of those Sets keep (such as HashSet's array of chains):
+//
+//     T* allocateArray<T>(count)  returns uninitialized storage for count
+//                                 objects of the trivial type T
+//     void releaseArray(array, count)
+//                                 gives that storage back
+//
+// HeapNodeAllocator is the traditional approach, where every node is its
+// own call to new and delete.  ArenaNodeAllocator carves nodes out of
+// large slabs, so creating a node is usually just bumping a counter, and
+// releasing a whole Set frees a handful of slabs instead of every node.
+// HugePageNodeAllocator is an arena whose slabs, and arrays, are backed
+// by 2 MiB pages where the system allows it (see HugePages.hpp), which
+// makes random lookups in a large Set cause fewer TLB misses.
+
+#ifndef NODEALLOCATOR_HPP
+#define NODEALLOCATOR_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "HugePages.hpp"
+
+
+
+struct HeapNodeAllocator
+{
+    template <typename NodeType>
+    class Pool
+    {
+    public:
+        static constexpr bool RELEASES_IN_BULK = false;
+
+        template <typename... Args>
+        NodeType* create(Args&&... args)
+        {
+            return new NodeType{std::forward<Args>(args)...};
+        }
+
+        void destroy(NodeType* node) noexcept
+        {
+            delete node;
+        }
+
+        void releaseAll() noexcept
+        {
+        }
+    };
+
+    template <typename T>
+    static T* allocateArray(std::size_t count)
+    {
+        static_assert(std::is_trivial_v<T>, "arrays are left uninitialized");
+        return static_cast<T*>(::operator new(count * sizeof(T)));
+    }
+
+    template <typename T>
+    static void releaseArray(T* array, std::size_t count) noexcept
+    {
+        ::operator delete(array);
+    }
+};
+
+
+
+// A PageSource says where an arena's slabs and arrays come from, and how
+// large its slabs grow.
+struct OrdinaryPageSource
+{
+    static constexpr std::size_t MAX_SLAB_BYTES = 1 << 20;
+
+    static void* allocate(std::size_t bytes)
+    {
+        return ::operator new(bytes);
+    }
+
+    static void release(void* memory, std::size_t bytes) noexcept
+    {
+        ::operator delete(memory);
+    }
+};
+
+
+struct HugePageSource
+{
+    static constexpr std::size_t MAX_SLAB_BYTES = HUGE_PAGE_BYTES;
+
+    static void* allocate(std::size_t bytes)
+    {
+        return allocateHugePages(bytes);
+    }
+
+    static void release(void* memory, std::size_t bytes) noexcept
+    {
+        releaseHugePages(memory, bytes);
+    }
+};
+
+
+
+template <typename PageSource>
+struct BasicArenaNodeAllocator
+{
+    template <typename NodeType>
+    class Pool
+    {
+    public:
+        static constexpr bool RELEASES_IN_BULK = true;
+
+        // Slabs start small, so that small sets stay small, and double in
+        // size until they reach MAX_SLAB_BYTES.
+        static constexpr std::size_t MIN_SLAB_NODES = 32;
+        static constexpr std::size_t MAX_SLAB_BYTES = PageSource::MAX_SLAB_BYTES;
+
+        Pool() noexcept;
+        ~Pool() noexcept;
+
+        Pool(const Pool&) = delete;
+        Pool(Pool&& p) noexcept;
+        Pool& operator=(const Pool&) = delete;
+        Pool& operator=(Pool&& p) noexcept;
+
+        template <typename... Args>
+        NodeType* create(Args&&... args);
+
+        // Individual nodes are not given back to an arena; their storage
+        // (and destructor) is deferred until releaseAll().
+        void destroy(NodeType* node) noexcept;
+
+        void releaseAll() noexcept;
+
+    private:
+        struct Slab
+        {
+            Slab* next;
+            std::size_t used;
+            std::size_t capacity;
+        };
+
+        static constexpr std::size_t HEADER_BYTES =
+            (sizeof(Slab) + alignof(NodeType) - 1) / alignof(NodeType) * alignof(NodeType);
+
+        static NodeType* nodeAt(Slab* slab, std::size_t index) noexcept;
+        void addSlab();
+
+        Slab* slabs;
+        std::size_t nextSlabNodes;
+    };
+
+    template <typename T>
+    static T* allocateArray(std::size_t count)
+    {
+        static_assert(std::is_trivial_v<T>, "arrays are left uninitialized");
+        return static_cast<T*>(PageSource::allocate(count * sizeof(T)));
+    }
+
+    template <typename T>
+    static void releaseArray(T* array, std::size_t count) noexcept
+    {
+        PageSource::release(array, count * sizeof(T));
+    }
+};
+
+
+using ArenaNodeAllocator = BasicArenaNodeAllocator<OrdinaryPageSource>;
+using HugePageNodeAllocator = BasicArenaNodeAllocator<HugePageSource>;
+
+
+
+template <typename PageSource>
+template <typename NodeType>
+BasicArenaNodeAllocator<PageSource>::Pool<NodeType>::Pool() noexcept
+    : slabs{nullptr}, nextSlabNodes{MIN_SLAB_NODES}
+{
+}
+
+
+template <typename PageSource>
+template <typename NodeType>
+BasicArenaNodeAllocator<PageSource>::Pool<NodeType>::~Pool() noexcept
+{
+    releaseAll();
+}
+
+
+template <typename PageSource>
+template <typename NodeType>
+BasicArenaNodeAllocator<PageSource>::Pool<NodeType>::Pool(Pool&& p) noexcept
+    : slabs{p.slabs}, nextSlabNodes{p.nextSlabNodes}
+{
+    p.slabs = nullptr;
+    p.nextSlabNodes = MIN_SLAB_NODES;
+}
+
+
+template <typename PageSource>
+template <typename NodeType>
+typename BasicArenaNodeAllocator<PageSource>::template Pool<NodeType>& BasicArenaNodeAllocator<PageSource>::Pool<NodeType>::operator=(Pool&& p) noexcept
+{
+    std::swap(slabs, p.slabs);
+    std::swap(nextSlabNodes, p.nextSlabNodes);
+    return *this;
+}
+
+
+template <typename PageSource>
+template <typename NodeType>
+template <typename... Args>
+NodeType* BasicArenaNodeAllocator<PageSource>::Pool<NodeType>::create(Args&&... args)
+{
+    if (slabs == nullptr || slabs->used == slabs->capacity)
+    {
+        addSlab();
+    }
+
+    NodeType* node = new (nodeAt(slabs, slabs->used)) NodeType{std::forward<Args>(args)...};
+    ++slabs->used;
+    return node;
+}
+
+
+template <typename PageSource>
+template <typename NodeType>
+void BasicArenaNodeAllocator<PageSource>::Pool<NodeType>::destroy(NodeType* node) noexcept
+{
+}
+
+
+template <typename PageSource>
+template <typename NodeType>
+void BasicArenaNodeAllocator<PageSource>::Pool<NodeType>::releaseAll() noexcept
+{
+    while (slabs != nullptr)
+    {
+        Slab* slab = slabs;
+        slabs = slab->next;
+
+        if constexpr (!std::is_trivially_destructible_v<NodeType>)
+        {
+            for (std::size_t i = 0; i < slab->used; ++i)
+            {
+                nodeAt(slab, i)->~NodeType();
+            }
+        }
+
+        PageSource::release(slab, HEADER_BYTES + slab->capacity * sizeof(NodeType));
+    }
+
+    nextSlabNodes = MIN_SLAB_NODES;
+}
+
+
+template <typename PageSource>
+template <typename NodeType>
+NodeType* BasicArenaNodeAllocator<PageSource>::Pool<NodeType>::nodeAt(Slab* slab, std::size_t index) noexcept
+{
+    unsigned char* storage = reinterpret_cast<unsigned char*>(slab) + HEADER_BYTES;
+    return reinterpret_cast<NodeType*>(storage) + index;
+}
+
+
+template <typename PageSource>
+template <typename NodeType>
+void BasicArenaNodeAllocator<PageSource>::Pool<NodeType>::addSlab()
+{
+    void* memory = PageSource::allocate(HEADER_BYTES + nextSlabNodes * sizeof(NodeType));
+    slabs = new (memory) Slab{slabs, 0, nextSlabNodes};
+
+    // the largest slabs fill MAX_SLAB_BYTES exactly, header and all, so
+    // that a huge page slab is exactly one huge page
+    constexpr std::size_t MAX_SLAB_NODES = (MAX_SLAB_BYTES - HEADER_BYTES) / sizeof(NodeType);
+    nextSlabNodes = std::min(nextSlabNodes * 2, MAX_SLAB_NODES);
+}
+
+
+
+#endif // NODEALLOCATOR_HPP
@@ -0,0 +1,121 @@
+// OrderedSet.hpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+//
+// The OrderedSet<ElementType> class template is an abstract base class
+// template for implementations of a Set that keep their elements in
+// ascending order (such as AVLSet), so that they can visit just the
+// elements in a range -- or, when the elements are strings, just the
+// ones that start with a prefix -- without walking all of the others.
+//
+// An implementation provides visitFrom(), which visits the elements in
+// ascending order starting from a given one, until the visit function
+// asks it to stop; visitRange() and visitPrefix() are built on top of it.
+// All three return the number of elements they visited.
+
+#ifndef ORDEREDSET_HPP
+#define ORDEREDSET_HPP
+
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include "Set.hpp"
+
+
+
+template <typename ElementType>
+class OrderedSet : public Set<ElementType>
+{
+public:
+    // A VisitFunction is a function that takes a reference to a const
+    // ElementType and returns no value.
+    using VisitFunction = std::function<void(const ElementType&)>;
+
+    // A WhileFunction is a function that takes a reference to a const
+    // ElementType and returns true if the visiting should continue past
+    // that element, false if it should stop there.
+    using WhileFunction = std::function<bool(const ElementType&)>;
+
+    // NO_LIMIT is the default limit on how many elements to visit.
+    static constexpr std::size_t NO_LIMIT = std::numeric_limits<std::size_t>::max();
+
+
+public:
+    // visitFrom() calls the given "visit" function for each element that
+    // is not less than low, in ascending order, until the function returns
+    // false or there are no more elements.  This should take O(log n + k)
+    // time, where k is the number of elements visited.
+    virtual std::size_t visitFrom(const ElementType& low, WhileFunction visit) const = 0;
+
+
+    // visitRange() calls the given "visit" function for each element that
+    // is not less than low and is less than high, in ascending order,
+    // stopping early once limit elements have been visited.
+    std::size_t visitRange(
+        const ElementType& low, const ElementType& high,
+        VisitFunction visit, std::size_t limit = NO_LIMIT) const
+    {
+        if (limit == 0)
+        {
+            return 0;
+        }
+
+        std::size_t visited = 0;
+
+        visitFrom(
+            low,
+            [&](const ElementType& element)
+            {
+                if (!(element < high))
+                {
+                    return false;
+                }
+
+                visit(element);
+                return ++visited < limit;
+            });
+
+        return visited;
+    }
+
+
+    // visitPrefix() calls the given "visit" function for each element that
+    // starts with the given prefix, in ascending order, stopping early
+    // once limit elements have been visited.  (It's only available when
+    // the elements are strings, or something else with a compare() that
+    // can compare a prefix of an element.)  Every element starting with a
+    // prefix sorts at or after the prefix itself, and they all come
+    // before any element that doesn't, so the visiting stops at the first
+    // one that doesn't match.
+    std::size_t visitPrefix(
+        const ElementType& prefix, VisitFunction visit,
+        std::size_t limit = NO_LIMIT) const
+    {
+        if (limit == 0)
+        {
+            return 0;
+        }
+
+        std::size_t visited = 0;
+
+        visitFrom(
+            prefix,
+            [&](const ElementType& element)
+            {
+                if (element.compare(0, prefix.size(), prefix) != 0)
+                {
+                    return false;
+                }
+
+                visit(element);
+                return ++visited < limit;
+            });
+
+        return visited;
+    }
+};
+
+
+
+#endif // ORDEREDSET_HPP
@@ -0,0 +1,101 @@
+// ParallelSort.hpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+//
+// parallelSort() sorts a vector using several threads: the vector is cut
+// into one run per thread, each thread sorts its own run with std::sort(),
+// and then neighbouring runs are merged in pairs, in parallel, until one
+// run is left.  Vectors too small to be worth starting threads for, and
+// machines with only one hardware thread, are sorted with std::sort()
+// alone.  (The parallel overloads of the standard algorithms would do the
+// same job, but with GCC they need Intel's TBB library to be linked in.)
+
+#ifndef PARALLELSORT_HPP
+#define PARALLELSORT_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+
+
+// Vectors with fewer elements than this are sorted on the calling thread.
+constexpr std::size_t MIN_PARALLEL_SORT_SIZE = 1 << 14;
+
+
+template <typename ElementType>
+void parallelSort(
+    std::vector<ElementType>& elements,
+    unsigned int threadCount = std::thread::hardware_concurrency())
+{
+    if (threadCount <= 1 || elements.size() < MIN_PARALLEL_SORT_SIZE)
+    {
+        std::sort(elements.begin(), elements.end());
+        return;
+    }
+
+    // runs[i] is where the ith run starts; the last entry is the end
+    std::vector<std::size_t> runs;
+
+    for (unsigned int i = 0; i <= threadCount; ++i)
+    {
+        runs.push_back(elements.size() * i / threadCount);
+    }
+
+    std::vector<std::thread> threads;
+
+    for (unsigned int i = 0; i < threadCount; ++i)
+    {
+        threads.emplace_back(
+            [&elements, &runs, i]
+            {
+                std::sort(elements.begin() + runs[i], elements.begin() + runs[i + 1]);
+            });
+    }
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    while (runs.size() > 2)
+    {
+        std::vector<std::size_t> merged;
+        threads.clear();
+
+        for (std::size_t i = 0; i + 2 < runs.size(); i += 2)
+        {
+            threads.emplace_back(
+                [&elements, &runs, i]
+                {
+                    std::inplace_merge(
+                        elements.begin() + runs[i],
+                        elements.begin() + runs[i + 1],
+                        elements.begin() + runs[i + 2]);
+                });
+
+            merged.push_back(runs[i]);
+        }
+
+        // an odd run out is carried, unmerged, into the next round
+        if (runs.size() % 2 == 0)
+        {
+            merged.push_back(runs[runs.size() - 2]);
+        }
+
+        merged.push_back(runs.back());
+
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+
+        runs = merged;
+    }
+}
+
+
+
+#endif // PARALLELSORT_HPP
@@ -11,6 +11,9 @@
 #ifndef SET_HPP
 #define SET_HPP
 
+#include <cstddef>
+#include <ostream>
+#include <vector>
 
 
 template <typename ElementType>
@@ -34,13 +37,68 @@ public:
     virtual void add(const ElementType& element) = 0;
 
 
+    // addAll() adds every element in the given vector, with the same
+    // effect as calling add() on each.  If sorted is true, the caller
+    // promises that the elements are in ascending order (duplicates are
+    // allowed), so that implementations that can build themselves faster
+    // from sorted input (such as AVLSet) can do so.  By default, it just
+    // calls add() on each element.
+    virtual void addAll(const std::vector<ElementType>& elements, bool sorted = false)
+    {
+        for (const ElementType& element : elements)
+        {
+            add(element);
+        }
+    }
+
+
+    // buildsInBulk() returns true if addAll() would do better with the
+    // elements handed to it all at once than add() would with them one at
+    // a time (e.g., by building a balanced tree from all of them), so that
+    // callers reading elements from a stream know whether collecting them
+    // into a vector first is worth the memory.  By default, it returns
+    // false.
+    virtual bool buildsInBulk() const noexcept
+    {
+        return false;
+    }
+
+
     // contains() returns true if the given element is already in the set,
     // false otherwise.
     virtual bool contains(const ElementType& element) const = 0;
 
 
     // size() returns the number of elements in the set.
-    virtual unsigned int size() const noexcept = 0;
+    virtual std::size_t size() const noexcept = 0;
+
+
+    // reserve() tells the set that about expectedSize elements are going
+    // to be added to it, so that implementations that grow as elements are
+    // added (such as hash tables) can allocate enough space up front rather
+    // than growing repeatedly.  It is only a hint; by default, it does
+    // nothing.
+    virtual void reserve(std::size_t expectedSize)
+    {
+    }
+
+
+    // freeze() tells the set that no more elements are expected to be
+    // added to it for a while, so that implementations that can arrange
+    // themselves for faster searching (at the cost of slower adding) can
+    // do so now.  Elements may still be added afterward.  By default, it
+    // does nothing.
+    virtual void freeze()
+    {
+    }
+
+
+    // printStatistics() writes whatever an implementation can report about
+    // its own internals (such as how long a hash table's chains are) to
+    // the given stream.  By default, it writes nothing.
+    virtual void printStatistics(std::ostream& out) const
+    {
+    }
 };
 
 
@@ -7,17 +7,31 @@
 #include <iomanip>
 #include <iostream>
 #include <memory>
+#include <sstream>
+#include <utility>
 #include "SpellCheckShell.hpp"
 #include "AVLSet.hpp"
+#include "BloomFilterSet.hpp"
+#include "BTreeSet.hpp"
+#include "CompactAVLSet.hpp"
+#include "ConcurrentHashSet.hpp"
+#include "CuckooHashSet.hpp"
 #include "EmptySet.hpp"
 #include "HashSet.hpp"
+#include "HugePages.hpp"
+#include "KeyStorage.hpp"
 #include "ListSet.hpp"
+#include "NodeAllocator.hpp"
 #include "OutputSpellCheckerListener.hpp"
+#include "PackedWordSet.hpp"
+#include "PerfectHashSet.hpp"
+#include "PersistentAVLSet.hpp"
 #include "Set.hpp"
 #include "SkipListSet.hpp"
 #include "SpellChecker.hpp"
 #include "Stopwatch.hpp"
 #include "StringHashing.hpp"
+#include "SwissHashSet.hpp"
 #include "TextFileReader.hpp"
 #include "WordChecker.hpp"
 #include "WordSetLoader.hpp"
@@ -47,31 +61,218 @@ namespace
     }
 
 
-    std::unique_ptr<Set<std::string>> makeWordSet(const std::string& setType)
+    bool endsWith(const std::string& s, const std::string& suffix)
+    {
+        return s.length() >= suffix.length()
+            && s.compare(s.length() - suffix.length(), suffix.length(), suffix) == 0;
+    }
+
+
+    // The set types whose nodes come from a NodeAllocator and keep their
+    // words as the KeyStorage says.  Returns nullptr if the type is not
+    // one of them.  The shell only ever uses a set from one thread, so
+    // its HashSets count their lookups for the statistics that TIME mode
+    // prints.
+    template <typename NodeAllocator, typename KeyStorage>
+    std::unique_ptr<Set<std::string>> makeNodeWordSetWith(const std::string& setType)
     {
         if (setType == "AVL")
         {
-            return std::make_unique<AVLSet<std::string>>();
+            return std::make_unique<AVLSet<std::string, NodeAllocator, KeyStorage>>();
         }
-        else if (setType == "EMPTY")
+        else if (setType == "AVL FROZEN")
         {
-            return std::make_unique<EmptySet<std::string>>();
+            // searched in an Eytzinger array once it's loaded, at the cost
+            // of keeping every word twice (see AVLSet::freeze())
+            return std::make_unique<AVLSet<std::string, NodeAllocator, KeyStorage>>(true, true);
+        }
+        else if (setType == "BTREE")
+        {
+            return std::make_unique<BTreeSet<std::string, NodeAllocator, KeyStorage>>();
         }
         else if (setType == "HASH ZERO")
         {
-            return std::make_unique<HashSet<std::string>>(hashStringAsZero);
+            return std::make_unique<HashSet<std::string, ZeroHash, NodeAllocator, ModuloIndexing, KeyStorage, CountedLookups>>();
         }
         else if (setType == "HASH SUM")
         {
-            return std::make_unique<HashSet<std::string>>(hashStringAsSum);
+            return std::make_unique<HashSet<std::string, SumHash, NodeAllocator, ModuloIndexing, KeyStorage, CountedLookups>>();
         }
         else if (setType == "HASH PRODUCT")
         {
-            return std::make_unique<HashSet<std::string>>(hashStringAsProduct);
+            return std::make_unique<HashSet<std::string, ProductHash, NodeAllocator, ModuloIndexing, KeyStorage, CountedLookups>>();
+        }
+        else if (setType == "HASH WORDMIX")
+        {
+            return std::make_unique<HashSet<std::string, WordMixHash, NodeAllocator, ModuloIndexing, KeyStorage, CountedLookups>>();
+        }
+        else if (setType == "HASH STRIPES")
+        {
+            return std::make_unique<HashSet<std::string, StripesHash, NodeAllocator, ModuloIndexing, KeyStorage, CountedLookups>>();
+        }
+        else if (setType == "HASH ZERO MASKED")
+        {
+            return std::make_unique<HashSet<std::string, ZeroHash, NodeAllocator, MaskedIndexing, KeyStorage, CountedLookups>>();
+        }
+        else if (setType == "HASH SUM MASKED")
+        {
+            return std::make_unique<HashSet<std::string, SumHash, NodeAllocator, MaskedIndexing, KeyStorage, CountedLookups>>();
+        }
+        else if (setType == "HASH PRODUCT MASKED")
+        {
+            return std::make_unique<HashSet<std::string, ProductHash, NodeAllocator, MaskedIndexing, KeyStorage, CountedLookups>>();
         }
         else if (setType == "LIST")
         {
-            return std::make_unique<ListSet<std::string>>();
+            return std::make_unique<ListSet<std::string, NodeAllocator, KeyStorage>>();
+        }
+        else
+        {
+            return nullptr;
+        }
+    }
+
+
+    // A node set type ending in " INTERNED" (e.g., "AVL INTERNED") keeps
+    // the characters of its words in a StringPool, with only a handle to
+    // them in each node.
+    template <typename NodeAllocator>
+    std::unique_ptr<Set<std::string>> makeNodeWordSet(const std::string& setType)
+    {
+        const std::string internedSuffix = " INTERNED";
+
+        if (endsWith(setType, internedSuffix))
+        {
+            return makeNodeWordSetWith<NodeAllocator, InternedKeys>(
+                setType.substr(0, setType.length() - internedSuffix.length()));
+        }
+        else
+        {
+            return makeNodeWordSetWith<NodeAllocator, DirectKeys>(setType);
+        }
+    }
+
+
+    // The compact AVL set types keep their nodes in arrays instead of
+    // allocating them, so they take no NodeAllocator; as with the node set
+    // types, " INTERNED" keeps their words in a StringPool.
+    template <typename KeyStorage>
+    std::unique_ptr<Set<std::string>> makeCompactWordSetWith(const std::string& setType)
+    {
+        if (setType == "AVL COMPACT")
+        {
+            return std::make_unique<CompactAVLSet<std::string, KeyStorage, InterleavedNodes>>();
+        }
+        else if (setType == "AVL COMPACT SPLIT")
+        {
+            return std::make_unique<CompactAVLSet<std::string, KeyStorage, SplitNodes>>();
+        }
+        else
+        {
+            return nullptr;
+        }
+    }
+
+
+    std::unique_ptr<Set<std::string>> makeCompactWordSet(const std::string& setType)
+    {
+        const std::string internedSuffix = " INTERNED";
+
+        if (endsWith(setType, internedSuffix))
+        {
+            return makeCompactWordSetWith<InternedKeys>(
+                setType.substr(0, setType.length() - internedSuffix.length()));
+        }
+        else
+        {
+            return makeCompactWordSetWith<DirectKeys>(setType);
+        }
+    }
+
+
+    std::unique_ptr<Set<std::string>> makeWordSet(const std::string& setType)
+    {
+        // A set type ending in "+BLOOM" (e.g., "AVL+BLOOM") is the set type
+        // before the suffix with a Bloom filter in front of it.  Like the
+        // HashSets, the filter counts its lookups for TIME mode.
+        const std::string bloomSuffix = "+BLOOM";
+
+        if (endsWith(setType, bloomSuffix))
+        {
+            return std::make_unique<BloomFilterSet<std::string, WordMixHash, CountedFilterLookups>>(
+                makeWordSet(setType.substr(0, setType.length() - bloomSuffix.length())));
+        }
+
+        // A set type ending in " ARENA" (e.g., "AVL ARENA") allocates its
+        // nodes from an ArenaNodeAllocator instead of one at a time.
+        const std::string arenaSuffix = " ARENA";
+
+        if (endsWith(setType, arenaSuffix))
+        {
+            std::unique_ptr<Set<std::string>> wordSet = makeNodeWordSet<ArenaNodeAllocator>(
+                setType.substr(0, setType.length() - arenaSuffix.length()));
+
+            if (!wordSet)
+            {
+                throw SpellCheckShell::ShellException{"Invalid search structure type: " + setType};
+            }
+
+            return wordSet;
+        }
+
+        // A set type ending in " HUGE" (e.g., "HASH PRODUCT MASKED HUGE")
+        // allocates its nodes from a HugePageNodeAllocator, so that its
+        // nodes and arrays are backed by huge pages where possible.
+        const std::string hugeSuffix = " HUGE";
+
+        if (endsWith(setType, hugeSuffix))
+        {
+            std::unique_ptr<Set<std::string>> wordSet = makeNodeWordSet<HugePageNodeAllocator>(
+                setType.substr(0, setType.length() - hugeSuffix.length()));
+
+            if (!wordSet)
+            {
+                throw SpellCheckShell::ShellException{"Invalid search structure type: " + setType};
+            }
+
+            return wordSet;
+        }
+
+        if (std::unique_ptr<Set<std::string>> wordSet = makeNodeWordSet<HeapNodeAllocator>(setType))
+        {
+            return wordSet;
+        }
+        else if (std::unique_ptr<Set<std::string>> compactWordSet = makeCompactWordSet(setType))
+        {
+            return compactWordSet;
+        }
+        else if (setType == "EMPTY")
+        {
+            return std::make_unique<EmptySet<std::string>>();
+        }
+        else if (setType == "HASH CUCKOO")
+        {
+            return std::make_unique<CuckooHashSet<std::string, ProductHash>>();
+        }
+        else if (setType == "HASH CONCURRENT")
+        {
+            return std::make_unique<ConcurrentHashSet<std::string, ProductHash>>();
+        }
+        else if (setType == "HASH SWISS")
+        {
+            return std::make_unique<SwissHashSet<std::string, ProductHash>>();
+        }
+        else if (setType == "PERFECT")
+        {
+            return std::make_unique<PerfectHashSet>();
+        }
+        else if (setType == "PACKED")
+        {
+            return std::make_unique<PackedWordSet>();
+        }
+        else if (setType == "AVL PERSISTENT")
+        {
+            return std::make_unique<PersistentAVLSet<std::string>>();
         }
         else if (setType == "SKIPLIST")
         {
@@ -158,9 +359,11 @@ namespace
 
 
     void runTimingTest(
-        Set<std::string>& wordSet,
+        std::unique_ptr<Set<std::string>> wordSetOwner,
         const std::string& wordFilePath, const std::string& textFilePath)
     {
+        Set<std::string>& wordSet = *wordSetOwner;
+
         std::cout << std::endl;
 
         SpellChecker spellChecker;
@@ -191,6 +394,28 @@ namespace
 
         double wordSetSpellCheckDuration = stopwatch.lastDuration();
 
+        // The search structure is destroyed before the results are shown,
+        // so its statistics (if it keeps any) are captured now.
+        std::ostringstream wordSetStatistics;
+        wordSet.printStatistics(wordSetStatistics);
+
+        HugePageUsage pages = hugePageUsage();
+
+        if (pages.explicitBytes + pages.transparentBytes + pages.ordinaryBytes > 0)
+        {
+            pages.print(wordSetStatistics);
+        }
+
+        std::cout << "Destroying search structure ..." << std::endl;
+
+        {
+            stopwatch.start();
+            wordSetOwner.reset();
+            stopwatch.stop();
+        }
+
+        double wordSetTeardownDuration = stopwatch.lastDuration();
+
         EmptySet<std::string> emptySet;
         
         std::cout << "Loading word set from " << wordFilePath
@@ -261,6 +486,21 @@ namespace
                      - (emptySetLoadDuration + emptySetSpellCheckDuration) << "usec";
 
         std::cout << std::endl;
+        std::cout << std::endl;
+
+        std::cout << std::left << std::setw(12) << "Teardown";
+
+        std::cout << std::right << std::fixed << std::setprecision(0) << std::setw(12)
+                  << wordSetTeardownDuration << "usec";
+
+        std::cout << std::endl;
+
+        if (!wordSetStatistics.str().empty())
+        {
+            std::cout << std::endl;
+            std::cout << "SEARCH STRUCTURE STATISTICS" << std::endl;
+            std::cout << wordSetStatistics.str();
+        }
     }
 }
 
@@ -291,7 +531,7 @@ void SpellCheckShell::run()
         break;
 
     case OutputType::TimeOnly:
-        runTimingTest(*wordSet, wordFilePath, textFilePath);
+        runTimingTest(std::move(wordSet), wordFilePath, textFilePath);
         break;
     }
 }
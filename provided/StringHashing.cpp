@@ -12,7 +12,7 @@
 
 unsigned int hashStringAsZero(const std::string& word)
 {
-    return 0;
+    return ZeroHash{}(word);
 }
 
 
@@ -22,14 +22,7 @@ unsigned int hashStringAsZero(const std::string& word)
 
 unsigned int hashStringAsSum(const std::string& word)
 {
-    unsigned int hash = 0;
-
-    for (size_t i = 0; i < word.length(); ++i)
-    {
-        hash += static_cast<unsigned int>(word[i]);
-    }
-
-    return hash;
+    return SumHash{}(word);
 }
 
 
@@ -39,14 +32,26 @@ unsigned int hashStringAsSum(const std::string& word)
 
 unsigned int hashStringAsProduct(const std::string& word)
 {
-    unsigned int hash = 0;
-
-    for (size_t i = 0; i < word.length(); ++i)
-    {
-        hash *= 37;
-        hash += static_cast<unsigned int>(word[i]);
-    }
-    
-    return hash;
+    return ProductHash{}(word);
+}
+
+
+
+// This hash function reads the string eight bytes at a time and mixes
+// them with 128-bit multiplications, in the style of wyhash.  Every bit
+// of the string affects every bit of the 64-bit result.
+
+std::uint64_t hashStringAsWordMix(const std::string& word)
+{
+    return WordMixHash{}(word);
 }
 
+
+// This hash function is the same as hashStringAsWordMix for short
+// strings, but hashes long ones in 64-byte stripes, several lanes at a
+// time, in the style of xxh3.
+
+std::uint64_t hashStringAsStripes(const std::string& word)
+{
+    return StripesHash{}(word);
+}
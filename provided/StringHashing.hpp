@@ -4,17 +4,333 @@
 // Project #4: Set the Controls for the Heart of the Sun
 //
 // A collection of hash functions that are capable of hashing strings.
+//
+// Each hash function is available in two forms: as a plain function
+// (e.g., hashStringAsProduct), which can be stored in a std::function,
+// and as a function object type (e.g., ProductHash), which can be given
+// to a hash-based set as a template argument so that the call is
+// resolved, and usually inlined, at compile time.
+//
+// Zero, Sum and Product are the traditional byte-at-a-time hashes, with
+// 32-bit results.  WordMix and Stripes are modern 64-bit hashes that
+// read eight bytes at a time and mix with 64x64-to-128-bit multiplies:
+//
+//   * WordMix follows wyhash.  Keys of up to 16 bytes are read as at most
+//     two overlapping 64-bit words; longer keys are consumed 16 bytes (or,
+//     past 48 bytes, 48 bytes in three independent lanes) at a time.
+//
+//   * Stripes follows xxh3.  It is the same as WordMix for keys of up to
+//     STRIPE_BYTES bytes, but longer keys are consumed in 64-byte stripes
+//     that feed eight 64-bit accumulators, using SSE2 (two lanes per
+//     instruction) when it's available, and a scalar loop otherwise.
+//
+// Neither is meant to be compatible with the published algorithms; they
+// borrow their structure, not their exact output.
 
 #ifndef STRINGHASHING_HPP
 #define STRINGHASHING_HPP
 
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <string>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 
 
 unsigned int hashStringAsZero(const std::string& word);
 unsigned int hashStringAsSum(const std::string& word);
 unsigned int hashStringAsProduct(const std::string& word);
+std::uint64_t hashStringAsWordMix(const std::string& word);
+std::uint64_t hashStringAsStripes(const std::string& word);
+
+
+
+namespace impl_
+{
+    constexpr std::uint64_t HASH_P0 = 0xa0761d6478bd642fULL;
+    constexpr std::uint64_t HASH_P1 = 0xe7037ed1a0b428dbULL;
+    constexpr std::uint64_t HASH_P2 = 0x8ebc6af09c88c6e3ULL;
+    constexpr std::uint64_t HASH_P3 = 0x589965cc75374cc3ULL;
+
+
+    inline std::uint64_t read64(const char* p) noexcept
+    {
+        std::uint64_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+
+    inline std::uint64_t read32(const char* p) noexcept
+    {
+        std::uint32_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+
+    // Multiplies a and b into a 128-bit product and folds its two halves
+    // together with XOR.
+    inline std::uint64_t multiplyFold(std::uint64_t a, std::uint64_t b) noexcept
+    {
+#ifdef __SIZEOF_INT128__
+        unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+        return static_cast<std::uint64_t>(product) ^ static_cast<std::uint64_t>(product >> 64);
+#else
+        std::uint64_t aHigh = a >> 32, aLow = a & 0xffffffffULL;
+        std::uint64_t bHigh = b >> 32, bLow = b & 0xffffffffULL;
+        std::uint64_t lowLow = aLow * bLow, lowHigh = aLow * bHigh;
+        std::uint64_t highLow = aHigh * bLow, highHigh = aHigh * bHigh;
+        std::uint64_t middle = (lowLow >> 32) + (lowHigh & 0xffffffffULL) + (highLow & 0xffffffffULL);
+        std::uint64_t low = (middle << 32) | (lowLow & 0xffffffffULL);
+        std::uint64_t high = highHigh + (lowHigh >> 32) + (highLow >> 32) + (middle >> 32);
+        return low ^ high;
+#endif
+    }
+
+
+    // Hashes a key of at most 16 bytes, folding in the state left by
+    // hashing whatever came before it (just the seed, for short keys).
+    inline std::uint64_t hashTail(
+        const char* p, std::size_t length, std::size_t totalLength, std::uint64_t state) noexcept
+    {
+        std::uint64_t a;
+        std::uint64_t b;
+
+        if (length >= 4)
+        {
+            std::size_t middle = (length >> 3) << 2;
+            a = (read32(p) << 32) | read32(p + middle);
+            b = (read32(p + length - 4) << 32) | read32(p + length - 4 - middle);
+        }
+        else if (length > 0)
+        {
+            a = (static_cast<std::uint64_t>(static_cast<unsigned char>(p[0])) << 16)
+                | (static_cast<std::uint64_t>(static_cast<unsigned char>(p[length >> 1])) << 8)
+                | static_cast<unsigned char>(p[length - 1]);
+            b = 0;
+        }
+        else
+        {
+            a = 0;
+            b = 0;
+        }
+
+        return multiplyFold(HASH_P1 ^ totalLength, multiplyFold(a ^ HASH_P1, b ^ state));
+    }
+
+
+    // Consumes all but the last 1 to 16 bytes of a key longer than 16
+    // bytes, then hashes those last bytes (overlapping the previous block,
+    // so that they're always a full 16).
+    inline std::uint64_t hashLong(const char* p, std::size_t length, std::uint64_t state) noexcept
+    {
+        std::size_t totalLength = length;
+
+        if (length > 48)
+        {
+            std::uint64_t lane1 = state;
+            std::uint64_t lane2 = state;
+
+            do
+            {
+                state = multiplyFold(read64(p) ^ HASH_P1, read64(p + 8) ^ state);
+                lane1 = multiplyFold(read64(p + 16) ^ HASH_P2, read64(p + 24) ^ lane1);
+                lane2 = multiplyFold(read64(p + 32) ^ HASH_P3, read64(p + 40) ^ lane2);
+                p += 48;
+                length -= 48;
+            }
+            while (length > 48);
+
+            state ^= lane1 ^ lane2;
+        }
+
+        while (length > 16)
+        {
+            state = multiplyFold(read64(p) ^ HASH_P1, read64(p + 8) ^ state);
+            p += 16;
+            length -= 16;
+        }
+
+        std::uint64_t a = read64(p + length - 16);
+        std::uint64_t b = read64(p + length - 8);
+        return multiplyFold(HASH_P1 ^ totalLength, multiplyFold(a ^ HASH_P1, b ^ state));
+    }
+
+
+    inline std::uint64_t hashWordMix(const char* p, std::size_t length) noexcept
+    {
+        if (length <= 16)
+        {
+            return hashTail(p, length, length, HASH_P0);
+        }
+        else
+        {
+            return hashLong(p, length, HASH_P0);
+        }
+    }
+
+
+    // The secret that each 64-byte stripe is combined with, as eight
+    // 64-bit lanes.
+    constexpr std::uint64_t STRIPE_SECRET[8] =
+    {
+        0xbe4ba423396cfeb8ULL, 0x1cad21f72c81017cULL, 0xdb979083e96dd4deULL, 0x1f67b3b7a4a44072ULL,
+        0x78e5c0cc4ee679cbULL, 0x2172ffcc7dd05a82ULL, 0x8e2443f7744608b8ULL, 0x4c263a81e69035e0ULL
+    };
+
+
+    // Accumulates one 64-byte stripe into eight 64-bit accumulators: each
+    // lane adds the product of the low and high halves of (data XOR
+    // secret), plus the neighboring lane's data, as xxh3 does.
+    inline void accumulateStripe(std::uint64_t* accumulators, const char* p, std::uint64_t salt) noexcept
+    {
+#ifdef __SSE2__
+        __m128i saltPair = _mm_set1_epi64x(static_cast<long long>(salt));
+
+        for (unsigned int i = 0; i < 4; ++i)
+        {
+            __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * i));
+            __m128i secret = _mm_xor_si128(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(STRIPE_SECRET + 2 * i)), saltPair);
+            __m128i keyed = _mm_xor_si128(data, secret);
+            __m128i product = _mm_mul_epu32(keyed, _mm_shuffle_epi32(keyed, 0x31));
+            __m128i swapped = _mm_shuffle_epi32(data, 0x4e);
+
+            __m128i* accumulator = reinterpret_cast<__m128i*>(accumulators + 2 * i);
+            __m128i sum = _mm_add_epi64(_mm_loadu_si128(accumulator), _mm_add_epi64(product, swapped));
+            _mm_storeu_si128(accumulator, sum);
+        }
+#else
+        for (unsigned int i = 0; i < 8; ++i)
+        {
+            std::uint64_t data = read64(p + 8 * i);
+            std::uint64_t keyed = data ^ STRIPE_SECRET[i] ^ salt;
+            accumulators[i] += (keyed & 0xffffffffULL) * (keyed >> 32);
+            accumulators[i ^ 1] += data;
+        }
+#endif
+    }
+
+
+    inline std::uint64_t hashStripes(const char* p, std::size_t length, std::size_t stripeBytes) noexcept
+    {
+        if (length <= 16)
+        {
+            return hashTail(p, length, length, HASH_P0);
+        }
+        else if (length <= stripeBytes)
+        {
+            return hashLong(p, length, HASH_P0);
+        }
+
+        std::uint64_t accumulators[8] =
+        {
+            HASH_P0, HASH_P1, HASH_P2, HASH_P3, HASH_P0 ^ length, HASH_P1, HASH_P2, HASH_P3
+        };
+
+        std::size_t remaining = length;
+        std::uint64_t stripe = 0;
+
+        for (; remaining > 64; p += 64, remaining -= 64, ++stripe)
+        {
+            // Each stripe's secret is salted differently; otherwise the
+            // accumulators couldn't tell one stripe from another.
+            accumulateStripe(accumulators, p, (stripe + 1) * HASH_P2);
+
+            // Every eight stripes, the accumulators are scrambled, so that
+            // their high bits keep feeding back into the low ones.
+            if ((stripe & 7) == 7)
+            {
+                for (std::uint64_t& accumulator : accumulators)
+                {
+                    accumulator = (accumulator ^ (accumulator >> 47)) * HASH_P1;
+                }
+            }
+        }
+
+        std::uint64_t state = HASH_P0 ^ length;
+
+        for (unsigned int i = 0; i < 8; i += 2)
+        {
+            state = multiplyFold(accumulators[i] ^ STRIPE_SECRET[i], accumulators[i + 1] ^ state);
+        }
+
+        // The last 1 to 64 bytes go through the ordinary 16-byte rounds;
+        // hashLong() needs at least 17, so a short tail is extended
+        // backward into the last stripe.
+        std::size_t tail = remaining < 17 ? 17 : remaining;
+        return hashLong(p + remaining - tail, tail, state);
+    }
+}
+
+
+
+struct ZeroHash
+{
+    unsigned int operator()(const std::string& word) const noexcept
+    {
+        return 0;
+    }
+};
+
+
+struct SumHash
+{
+    unsigned int operator()(const std::string& word) const noexcept
+    {
+        unsigned int hash = 0;
+
+        for (size_t i = 0; i < word.length(); ++i)
+        {
+            hash += static_cast<unsigned int>(word[i]);
+        }
+
+        return hash;
+    }
+};
+
+
+struct ProductHash
+{
+    unsigned int operator()(const std::string& word) const noexcept
+    {
+        unsigned int hash = 0;
+
+        for (size_t i = 0; i < word.length(); ++i)
+        {
+            hash *= 37;
+            hash += static_cast<unsigned int>(word[i]);
+        }
+
+        return hash;
+    }
+};
+
+
+struct WordMixHash
+{
+    std::uint64_t operator()(const std::string& word) const noexcept
+    {
+        return impl_::hashWordMix(word.data(), word.length());
+    }
+};
+
+
+struct StripesHash
+{
+    // Keys longer than this are hashed in 64-byte SIMD stripes.
+    static constexpr std::size_t STRIPE_BYTES = 128;
+
+    std::uint64_t operator()(const std::string& word) const noexcept
+    {
+        return impl_::hashStripes(word.data(), word.length(), STRIPE_BYTES);
+    }
+};
 
 
 
@@ -0,0 +1,44 @@
+// StringPool.cpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+
+#include <limits>
+#include "StringPool.hpp"
+
+
+
+StringHandle StringPool::intern(const std::string& s)
+{
+    constexpr std::size_t MAX_BYTES = std::numeric_limits<std::uint32_t>::max();
+
+    if (s.length() > MAX_BYTES - characters.size())
+    {
+        throw PoolFullException{};
+    }
+
+    StringHandle handle{
+        static_cast<std::uint32_t>(characters.size()),
+        static_cast<std::uint32_t>(s.length())};
+
+    characters.insert(characters.end(), s.begin(), s.end());
+    return handle;
+}
+
+
+void StringPool::shrinkToFit()
+{
+    characters.shrink_to_fit();
+}
+
+
+std::size_t StringPool::characterBytes() const noexcept
+{
+    return characters.size();
+}
+
+
+std::size_t StringPool::capacityBytes() const noexcept
+{
+    return characters.capacity();
+}
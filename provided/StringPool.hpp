@@ -0,0 +1,101 @@
+// StringPool.hpp
+//
+// ICS 46 Spring 2018
+// Project #4: Set the Controls for the Heart of the Sun
+//
+// A StringPool keeps the characters of many strings end to end in one
+// contiguous block, and hands out a StringHandle for each: a 32-bit
+// offset into the block and a 32-bit length.  A handle is 8 bytes, where
+// a std::string is 32 (plus a heap block of its own for anything longer
+// than the small-string buffer), and the characters of strings added
+// one after another sit next to each other in memory instead of wherever
+// the heap happened to put them.
+//
+// A pool only ever grows; it doesn't look for an existing copy of a string
+// before adding it, since the Sets that own pools (see KeyStorage.hpp)
+// already know whether a string is new.  Handles stay valid as the pool
+// grows, since they're offsets rather than pointers, but they only mean
+// something to the pool that handed them out.
+
+#ifndef STRINGPOOL_HPP
+#define STRINGPOOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+
+struct StringHandle
+{
+    std::uint32_t offset;
+    std::uint32_t length;
+};
+
+
+
+class StringPool
+{
+public:
+    // A PoolFullException is thrown by intern() if the pool would grow
+    // past the 4 GiB that a 32-bit offset can address.
+    class PoolFullException { };
+
+public:
+    // intern() appends the characters of s to the pool and returns a
+    // handle to them.
+    StringHandle intern(const std::string& s);
+
+    // view() returns the characters a handle refers to.  The view is only
+    // good until the next call to intern() or shrinkToFit().
+    std::string_view view(StringHandle handle) const noexcept;
+
+    // equals() returns true if a handle refers to the same characters as
+    // s, comparing lengths first, so that most unequal strings are told
+    // apart without reading the pool at all.
+    bool equals(StringHandle handle, const std::string& s) const noexcept;
+
+    // compare() orders s against the string a handle refers to the same
+    // way std::string::compare() would, returning a negative number, zero
+    // or a positive number.
+    int compare(const std::string& s, StringHandle handle) const noexcept;
+
+    // shrinkToFit() gives back whatever room the pool has set aside for
+    // strings it doesn't have yet.
+    void shrinkToFit();
+
+    // characterBytes() returns the number of bytes of characters stored,
+    // and capacityBytes() the number of bytes the pool has allocated.
+    std::size_t characterBytes() const noexcept;
+    std::size_t capacityBytes() const noexcept;
+
+private:
+    std::vector<char> characters;
+};
+
+
+
+// view(), equals() and compare() are called on every probe of a Set that
+// stores handles, so they're defined here, where they can be inlined.
+inline std::string_view StringPool::view(StringHandle handle) const noexcept
+{
+    return std::string_view{characters.data() + handle.offset, handle.length};
+}
+
+
+inline bool StringPool::equals(StringHandle handle, const std::string& s) const noexcept
+{
+    return handle.length == s.length() && view(handle) == s;
+}
+
+
+inline int StringPool::compare(const std::string& s, StringHandle handle) const noexcept
+{
+    return std::string_view{s}.compare(view(handle));
+}
+
+
+
+#endif // STRINGPOOL_HPP
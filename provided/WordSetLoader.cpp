@@ -6,29 +6,97 @@
 #include <algorithm>
 #include <cctype>
 #include <fstream>
+#include <utility>
 #include "WordSetLoader.hpp"
 
 
 
+WordSetLoader::WordSetLoader(WordOrder order)
+    : order{order}
+{
+}
+
+
 void WordSetLoader::load(const std::string& wordFilePath, Set<std::string>& wordSet)
 {
     std::ifstream wordFile{wordFilePath};
 
+    std::size_t lineCount = countLines(wordFile);
+    wordSet.reserve(lineCount);
+
     std::string word;
 
+    if (!wordSet.buildsInBulk())
+    {
+        while (std::getline(wordFile, word))
+        {
+            normalize(word);
+            wordSet.add(word);
+        }
+
+        wordSet.freeze();
+        return;
+    }
+
+    std::vector<std::string> words;
+    words.reserve(lineCount);
+
+    bool sorted = (order != WordOrder::Unsorted);
+
     while (std::getline(wordFile, word))
     {
-        std::transform(
-            word.begin(), word.end(), word.begin(),
-            [](auto c) { return std::toupper(c); });
+        normalize(word);
+
+        if (order == WordOrder::Detect && sorted && !words.empty() && word < words.back())
+        {
+            sorted = false;
+        }
+
+        words.push_back(std::move(word));
+    }
+
+    wordSet.addAll(words, sorted);
+    wordSet.freeze();
+}
+
+
+void WordSetLoader::normalize(std::string& word)
+{
+    std::transform(
+        word.begin(), word.end(), word.begin(),
+        [](auto c) { return std::toupper(c); });
 
-        word.erase(
-            std::remove_if(
-                word.begin(), word.end(),
-                [](auto c) { return c == '\r' || c == '\n'; }),
-            word.end());
+    word.erase(
+        std::remove_if(
+            word.begin(), word.end(),
+            [](auto c) { return c == '\r' || c == '\n'; }),
+        word.end());
+}
+
+
+std::size_t WordSetLoader::countLines(std::ifstream& wordFile)
+{
+    constexpr std::streamsize bufferSize = 1 << 16;
+    char buffer[bufferSize];
 
-        wordSet.add(word);
+    std::size_t lines = 0;
+    char last = '\n';
+
+    while (wordFile.read(buffer, bufferSize) || wordFile.gcount() > 0)
+    {
+        std::streamsize count = wordFile.gcount();
+        lines += std::count(buffer, buffer + count, '\n');
+        last = buffer[count - 1];
     }
+
+    if (last != '\n')
+    {
+        ++lines;
+    }
+
+    wordFile.clear();
+    wordFile.seekg(0);
+
+    return lines;
 }
 
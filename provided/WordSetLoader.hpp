@@ -5,19 +5,56 @@
 //
 // A class that loads a word set from a file containing one word on each
 // line.  The words are then added to the given Set<std::string>.
+//
+// The loader makes a quick pass over the file to count its lines and
+// passes the count to the set's reserve(), so that hash-based sets can be
+// sized once instead of growing repeatedly.  The words are then added one
+// at a time as they're read, unless the set builds itself better in bulk
+// (see Set::buildsInBulk()); only then are they all read into memory
+// first and handed to the set's addAll() at once, along with whether
+// they're sorted, so that sets that can build themselves from sorted
+// input in linear time (such as AVLSet) can do so.  Whether the words are
+// sorted is checked as they're read, unless the loader is told the file's
+// order up front.  Once every word has been added, the loader
+// calls the set's freeze(), since nothing else will be added to a word
+// set.
 
 #ifndef WORDSETLOADER_HPP
 #define WORDSETLOADER_HPP
 
+#include <cstddef>
+#include <fstream>
 #include <string>
+#include <vector>
 #include "Set.hpp"
 
 
 
+// A WordOrder is what a WordSetLoader knows in advance about the order of
+// the words in the files it loads: nothing (so it checks), or that they're
+// sorted or unsorted.  Sorted means sorted after the words are normalized
+// (i.e., uppercased).
+enum class WordOrder
+{
+    Detect,
+    Sorted,
+    Unsorted
+};
+
+
+
 class WordSetLoader
 {
 public:
+    explicit WordSetLoader(WordOrder order = WordOrder::Detect);
+
     void load(const std::string& wordFilePath, Set<std::string>& wordSet);
+
+private:
+    WordOrder order;
+
+    std::size_t countLines(std::ifstream& wordFile);
+    void normalize(std::string& word);
 };
 
 